@@ -0,0 +1,36 @@
+// This sketch sends a raw signal using the fast soft PWM sender every 5 seconds,
+// with a 56kHz carrier.
+// It requires an IR-Led connected to the sending pin.
+
+#include <IrSenderPwmSoftFast.h>
+
+static const frequency_t frequency = 56000U;
+static const pin_t pin = 4U;
+static const unsigned long BAUD = 115200UL;
+
+// NEC(1) 122 29 with no repetition; powers on many Yamaha receivers
+static const microseconds_t array[] = {
+   9024, 4512, 564, 564, 564, 1692, 564, 564, 564, 1692, 564, 1692,
+   564, 1692, 564, 1692, 564, 564, 564, 1692, 564, 564, 564, 1692,
+   564, 564, 564, 564, 564, 564, 564, 564, 564, 1692, 564, 1692, 564,
+   564, 564, 1692, 564, 1692, 564, 1692, 564, 564, 564, 564, 564, 564,
+   564, 564, 564, 1692, 564, 564, 564, 564, 564, 564, 564, 1692, 564,
+   1692, 564, 1692, 564, 39756
+};
+
+static const IrSequence irSequence(array, sizeof(array) / sizeof(microseconds_t));
+IrSender* irSender;
+
+void setup() {
+    Serial.begin(BAUD);
+    while (!Serial)
+        ;
+    irSender = new IrSenderPwmSoftFast<pin>();
+}
+
+void loop() {
+    Serial.print("sending on pin ");
+    Serial.println(pin, DEC);
+    irSender->send(irSequence, frequency);
+    delay(5000);
+}
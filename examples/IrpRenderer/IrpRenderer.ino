@@ -0,0 +1,22 @@
+// Send Sony12 1/18 (volume up for Sony TVs) followed by 2 repeats
+
+#include <IrpRenderer.h>
+#include <IrSenderPwm.h>
+
+const IrSignal *irSignal;
+
+void setup() {
+    Serial.begin(115200);
+    irSignal = IrpRenderer::newIrSignal(IrpProtocol::getProtocol(IrpProtocol::sony12), 1, 18);
+}
+
+void loop() {
+    // Print a textual representation to Serial.
+    irSignal->dump(Serial, true);
+
+    // Send it 3 times, as Sony devices require.
+    IrSenderPwm::getInstance(true)->sendIrSignal(*irSignal, 3);
+
+    // Wait 10 seconds.
+    delay(10000);
+}
@@ -54,6 +54,10 @@ communicating over a serial line, likely in USB disguise.
 #include <Pronto.h>
 #endif
 
+#ifdef BINARY
+#include <BinaryFrame.h>
+#endif
+
 #ifdef RENDERER
 #ifndef TRANSMIT
 #error RENDER without TRANSMIT is nonsensical, aborting.
@@ -63,6 +67,8 @@ communicating over a serial line, likely in USB disguise.
 #include <Rc5Renderer.h>
 #endif
 
+#include <HeapStatistics.h>
+
 #include "Tokenizer.h"
 
 #ifdef TRANSMIT
@@ -101,6 +107,12 @@ communicating over a serial line, likely in USB disguise.
 #define TRANSMITTERS_NAME
 #endif
 
+#ifdef BINARY
+#define BINARY_NAME Binary
+#else
+#define BINARY_NAME
+#endif
+
 #ifdef PARAMETERS
 #define PARAMETERS_NAME Parameters
 #define PARAMETER_CONST
@@ -124,7 +136,7 @@ static PARAMETER_CONST uint16_t captureSize = DEFAULT_CAPTURESIZE;
 #define QUOTE(str) #str
 #define EXPAND_AND_QUOTE(str) QUOTE(str)
 
-#define modulesSupported EXPAND_AND_QUOTE(Base TRANSMIT_NAME CAPTURE_NAME RENDERER_NAME RECEIVE_NAME PARAMETERS_NAME PRONTO_NAME )
+#define modulesSupported EXPAND_AND_QUOTE(Base TRANSMIT_NAME CAPTURE_NAME RENDERER_NAME RECEIVE_NAME PARAMETERS_NAME PRONTO_NAME BINARY_NAME )
 #ifndef PROGNAME
 #define PROGNAME "MicroGirs"
 #endif
@@ -133,6 +145,28 @@ static PARAMETER_CONST uint16_t captureSize = DEFAULT_CAPTURESIZE;
 #define errorString "ERROR"
 #define timeoutString "."
 
+#ifdef BINARY
+// If true, signals in send, receive, and capture are exchanged as binary frames.
+static bool binaryMode = false;
+
+#ifdef TRANSMIT
+// Reads a frame from the stream into the parser, giving up after SERIAL_TIMEOUT without data.
+static bool readFrame(Stream& stream, BinaryFrame::Parser& parser) {
+    parser.reset();
+    unsigned long start = millis();
+    while (parser.getStatus() == BinaryFrame::Parser::incomplete) {
+        if (stream.available() > 0) {
+            parser.feed((uint8_t) stream.read());
+            start = millis();
+        } else if (millis() - start >= SERIAL_TIMEOUT)
+            return false;
+    }
+    return parser.getStatus() == BinaryFrame::Parser::complete
+            && parser.getType() == BinaryFrame::signalType;
+}
+#endif
+#endif // BINARY
+
 static void printVariable(Stream& stream, const char *variableName, unsigned long value) {
     stream.print(variableName);
     stream.print("=");
@@ -141,24 +175,26 @@ static void printVariable(Stream& stream, const char *variableName, unsigned lon
 
 #ifdef TRANSMIT
 
-static bool sendIrSignal(const IrSignal &irSignal, unsigned int noSends=1) {
-    if (noSends == 0)
+// Buffer for the durations of the send command, and the numbers of the hex command.
+// The durations are written into it directly by the tokenizer.
+static union {
+    microseconds_t durations[SIGNAL_BUFFER_SIZE];
+    uint16_t prontoData[SIGNAL_BUFFER_SIZE];
+} signalBuffer;
+
+static bool sendIrSignal(const IrSignal &irSignal, long noSends=1L) {
+    if (noSends < 1L || noSends > MAX_NO_SENDS) // also Tokenizer::invalid
         return false;
-    IrSender *irSender =
 #ifdef NON_MOD
-            (irSignal.getFrequency() == 0) ? (IrSender*) new IrSenderNonMod(NON_MOD_PIN) :
+    static IrSenderNonMod irSenderNonMod(NON_MOD_PIN);
 #endif
-            (IrSender*) IrSenderPwm::getInstance(true);
-
-    irSender->sendIrSignal(irSignal, noSends);
-
+    IrSender *irSender =
 #ifdef NON_MOD
-    if (irSignal.getFrequency() == 0)
-        delete irSender;
-    else
+            (irSignal.getFrequency() == 0) ? (IrSender*) &irSenderNonMod :
 #endif
-        IrSenderPwm::deleteInstance();
+            (IrSender*) IrSenderPwm::getInstance(true);
 
+    irSender->sendIrSignal(irSignal, (unsigned int) noSends);
     return true;
 }
 
@@ -174,6 +210,15 @@ static void flushIn(Stream &stream) {
 #ifdef RECEIVE
 
 static void decodeOrDump(IrReader *irReader, Stream& stream) {
+#ifdef BINARY
+    if (binaryMode) {
+        if (irReader->isEmpty())
+            BinaryFrame::writeTimeout(stream);
+        else
+            BinaryFrame::write(stream, *irReader);
+        return;
+    }
+#endif
     if (irReader->isEmpty())
         stream.println(F(timeoutString));
     else
@@ -221,6 +266,14 @@ static bool capture(Stream& stream) {
     flushIn(stream);
     irWidget->capture();
 
+#ifdef BINARY
+    if (binaryMode) {
+        if (irWidget->isEmpty())
+            BinaryFrame::writeTimeout(stream);
+        else
+            BinaryFrame::write(stream, *irWidget);
+    } else
+#endif
     if (!irWidget->isEmpty()) {
         // Trying to decode the capture does not make sense,
         // that is what "receive" is for.
@@ -233,6 +286,10 @@ static bool capture(Stream& stream) {
 #endif // CAPTURE
 
 void setup() {
+#ifdef HEAP_STATISTICS
+    HeapStatistics::paintStack();
+#endif
+
 #ifdef IRRECEIVER_1_GND
     pinMode(IRRECEIVER_1_GND, OUTPUT);
     digitalWrite(IRRECEIVER_1_GND, LOW);
@@ -265,96 +322,120 @@ void setup() {
     Serial.setTimeout(SERIAL_TIMEOUT);
 }
 
-static inline bool isPrefix(const String& cmd, const char *string) {
-    return strncmp(cmd.c_str(), string, cmd.length()) == 0;
-}
-
-static inline bool isPrefix(const char *string, const String& cmd) {
-    return strncmp(cmd.c_str(), string, strlen(string)) == 0;
+// Is cmd a prefix of string?
+static inline bool isPrefix(const char *cmd, const char *string) {
+    return strncmp(cmd, string, strlen(cmd)) == 0;
 }
 
-/*
-bool isPrefix(const String& cmd, const __FlashStringHelper *pstring) {
-    return strncmp_PF(cmd.c_str(), static_cast<const char*>(pstring), cmd.length()) == 0;
+// Is string a prefix of token?
+static inline bool hasPrefix(const char *token, const char *string) {
+    return strncmp(token, string, strlen(string)) == 0;
 }
 
-bool isPrefix(const __FlashStringHelper *pstring, const String& cmd) {
-    return strncmp_PF(cmd.c_str(), pstring, strlen_PF(pstring)) == 0;
-}
-*/
-
-static String readCommand(Stream& stream) {
-    //flushIn(stream);
-    while (stream.available() == 0)
-        yield();
-
-    String line = stream.readStringUntil(EOLCHAR);
-    line.trim();
-    return line;
-}
+static Tokenizer tokenizer(Serial, EOLCHAR, SERIAL_TIMEOUT);
 
-static bool processCommand(const String& line, Stream& stream) {
-    Tokenizer tokenizer(line);
-    String cmd = tokenizer.getToken();
+static bool processCommand(Tokenizer& tokenizer, Stream& stream) {
+    const char *cmd = tokenizer.getToken();
 
     // Decode command
-    if (cmd.length() == 0) {
+    if (cmd[0] == '\0') {
         // empty command, do nothing
         stream.println(F(okString));
     } else
 
 #ifdef CAPTURE
         if (cmd[0] == 'a' || cmd[0] == 'c') {
+        tokenizer.skipRest();
         capture(stream);
     } else
 #endif // CAPTURE
 
+#ifdef BINARY
+        if (isPrefix(cmd, "binary")) {
+        // "binary" or "binary 1" turns binary frames on, "binary 0" turns them off.
+        long value = tokenizer.getInt();
+        binaryMode = value != 0L;
+        stream.println(F(okString));
+    } else
+#endif // BINARY
+
         if (isPrefix(cmd, "modules")) {
         stream.println(F(modulesSupported));
     } else
 
+#ifdef HEAP_STATISTICS
+        if (isPrefix(cmd, "memory")) {
+        // "memory" reports heap usage per subsystem and the stack high-water mark,
+        // "memory reset" also restarts the counts and peaks.
+        const char *argument = tokenizer.getToken();
+        HeapStatistics::dump(stream);
+        if (isPrefix(argument, "reset") && argument[0] != '\0')
+            HeapStatistics::reset();
+    } else
+#endif // HEAP_STATISTICS
+
+#if defined(RECEIVE) && defined(ISR_STATISTICS)
+        if (isPrefix(cmd, "info")) {
+        // "info" reports the timing of the sampler ISR during the receives so far,
+        // "info reset" also restarts it.
+        const char *argument = tokenizer.getToken();
+        IrReceiverSampler::dumpIsrStatistics(stream);
+        if (isPrefix(argument, "reset") && argument[0] != '\0')
+            IrReceiverSampler::resetIsrStatistics();
+    } else
+#endif // RECEIVE && ISR_STATISTICS
+
 #ifdef PARAMETERS
         if (cmd[0] == 'p') { // parameter
-        String variableName = tokenizer.getToken();
+        const char *variableName = tokenizer.getToken();
         long value = tokenizer.getInt();
         unsigned long *variable32 = NULL;
         uint16_t *variable16 = NULL;
         uint8_t *variable8 = NULL;
 #if defined(RECEIVE) || defined(CAPTURE)
-           if (isPrefix("beg", variableName))
+           if (hasPrefix(variableName, "beg"))
             variable32 = &beginTimeout;
         else
 #endif
 #ifdef CAPTURE
-            if (isPrefix("capturee", variableName))
+            if (hasPrefix(variableName, "capturee"))
             variable32 = &captureEndingTimeout;
 #endif
 #ifdef RECEIVE
-           if (isPrefix("receivee", variableName))
+           if (hasPrefix(variableName, "receivee"))
             variable32 = &receiveEndingTimeout;
         else
 #endif
 #ifdef CAPTURE
-        if (isPrefix("captures", variableName)) {
+        if (hasPrefix(variableName, "captures")) {
         // TODO: check evenness of value
         variable16 = &captureSize;
         } else
+#endif
+#ifdef RECEIVE
+        if (hasPrefix(variableName, "tick")) {
+            // sampling period of receive, in microseconds
+            if (value != Tokenizer::invalid && !Board::setMicrosPerTick((unsigned long) value))
+                stream.println(F(errorString));
+            else
+                printVariable(stream, variableName, Board::getMicrosPerTick());
+        } else
 #endif
         if (variable32 != NULL) {
             if (value != Tokenizer::invalid)
                 *variable32 = value;
 
-            printVariable(stream, variableName.c_str(), *variable32);
+            printVariable(stream, variableName, *variable32);
         } else if (variable16 != NULL) {
             if (value != Tokenizer::invalid)
                 *variable16 = (uint16_t) value;
 
-            printVariable(stream, variableName.c_str(), *variable16);
+            printVariable(stream, variableName, *variable16);
         } else if (variable8 != NULL) {
             if (value != Tokenizer::invalid)
                 *variable8 = (uint8_t) value;
 
-            printVariable(stream, variableName.c_str(), *variable8);
+            printVariable(stream, variableName, *variable8);
         } else
             stream.println(F("No such variable"));
     } else
@@ -363,6 +444,7 @@ static bool processCommand(const String& line, Stream& stream) {
 #ifdef RECEIVE
         // TODO: option for force decoding off
         if (isPrefix(cmd, "receive")) { // receive
+        tokenizer.skipRest();
         bool status = receive(stream);
         if (!status)
             stream.println(F(errorString));
@@ -371,32 +453,58 @@ static bool processCommand(const String& line, Stream& stream) {
 
 #ifdef TRANSMIT
         if (cmd[0] == 's') { // send
-        // TODO: handle unparsable data gracefully
-        uint16_t noSends = (uint16_t) tokenizer.getInt();
+        long noSends = tokenizer.getInt();
+#ifdef BINARY
+        if (binaryMode) {
+            // The signal follows the command line as a binary frame.
+            tokenizer.skipRest();
+            BinaryFrame::Parser parser(signalBuffer.durations, SIGNAL_BUFFER_SIZE);
+            bool status = readFrame(stream, parser)
+                    && sendIrSignal(parser.toIrSignal(), noSends); // waits
+            stream.println(status ? F(okString) : F(errorString));
+            return true;
+        }
+#endif
         frequency_t frequency = tokenizer.getFrequency();
-        uint16_t introLength = (uint16_t) tokenizer.getInt();
-        uint16_t repeatLength = (uint16_t) tokenizer.getInt();
-        uint16_t endingLength = (uint16_t) tokenizer.getInt();
-        microseconds_t intro[introLength];
-        microseconds_t repeat[repeatLength];
-        microseconds_t ending[endingLength];
-        for (uint16_t i = 0; i < introLength; i++)
-            intro[i] = tokenizer.getMicroseconds();
-        for (uint16_t i = 0; i < repeatLength; i++)
-            repeat[i] = tokenizer.getMicroseconds();
-        for (uint16_t i = 0; i < endingLength; i++)
-            ending[i] = tokenizer.getMicroseconds();
-        IrSignal irSignal(intro, introLength, repeat, repeatLength, ending, endingLength, frequency);
-        bool status = sendIrSignal(irSignal, noSends); // waits
+        long introLength = tokenizer.getInt();
+        long repeatLength = tokenizer.getInt();
+        long endingLength = tokenizer.getInt();
+        bool status = noSends >= 1L && noSends <= MAX_NO_SENDS
+                && frequency != IrSignal::invalidFrequency
+                && introLength >= 0L && repeatLength >= 0L && endingLength >= 0L
+                && introLength + repeatLength + endingLength <= (long) SIGNAL_BUFFER_SIZE;
+        if (status) {
+            microseconds_t *intro = signalBuffer.durations;
+            microseconds_t *repeat = intro + introLength;
+            microseconds_t *ending = repeat + repeatLength;
+            size_t length = (size_t) (introLength + repeatLength + endingLength);
+            for (size_t i = 0U; i < length && status; i++) {
+                intro[i] = tokenizer.getMicroseconds();
+                status = intro[i] > 0U && (!tokenizer.isEndOfLine() || i == length - 1U);
+            }
+            tokenizer.skipRest();
+            if (status) {
+                IrSignal irSignal(intro, (size_t) introLength, repeat, (size_t) repeatLength,
+                        ending, (size_t) endingLength, frequency);
+                status = sendIrSignal(irSignal, noSends); // waits
+            }
+        } else
+            tokenizer.skipRest();
         stream.println(status ? F(okString) : F(errorString));
     } else
 #endif // TRANSMIT
 
 #ifdef PRONTO
         if (isPrefix(cmd, "hex")) { // pronto hex send
-        uint16_t noSends = (uint16_t) tokenizer.getInt();
-        String rest = tokenizer.getRest();
-        IrSignal *irSignal = Pronto::parse(rest.c_str());
+        long noSends = tokenizer.getInt();
+        size_t length = 0U;
+        long number;
+        while (length < SIGNAL_BUFFER_SIZE && (number = tokenizer.getHex()) >= 0L && number <= 0xFFFFL)
+            signalBuffer.prontoData[length++] = (uint16_t) number;
+        // Stopped before the end of the line by a full buffer, or a bad number
+        bool overflow = !tokenizer.isEndOfLine();
+        tokenizer.skipRest();
+        IrSignal *irSignal = overflow ? NULL : Pronto::parse(signalBuffer.prontoData, length);
         bool status = false;
         if (irSignal != NULL) {
             status = sendIrSignal(*irSignal, noSends); // waits
@@ -408,28 +516,30 @@ static bool processCommand(const String& line, Stream& stream) {
 
 #ifdef RENDERER
         if (cmd[0] == 't') { // transmit
-        // TODO: handle unparseable data gracefully
-        uint16_t noSends = (uint16_t) tokenizer.getInt();
-        String protocol = tokenizer.getToken();
+        long noSends = tokenizer.getInt();
+        const char *protocol = tokenizer.getToken();
         const IrSignal *irSignal = NULL;
         if (isPrefix(protocol, "nec1")) {
-            unsigned int D = (unsigned) tokenizer.getInt();
-            unsigned int S = (unsigned) tokenizer.getInt();
-            unsigned int F = (unsigned) tokenizer.getInt();
-            irSignal = (F == Tokenizer::invalid)
-                    ? Nec1Renderer::newIrSignal(D, S)
-                    : Nec1Renderer::newIrSignal(D, S, F);
+            long D = tokenizer.getInt();
+            long S = tokenizer.getInt();
+            long F = tokenizer.getInt();
+            if (D >= 0L && S >= 0L)
+                irSignal = (F == Tokenizer::invalid)
+                        ? Nec1Renderer::newIrSignal((unsigned) D, (unsigned) S)
+                        : F >= 0L ? Nec1Renderer::newIrSignal((unsigned) D, (unsigned) S, (unsigned) F) : NULL;
         } else if (isPrefix(protocol, "rc5")) {
-            unsigned int D = (unsigned) tokenizer.getInt();
-            unsigned int F = (unsigned) tokenizer.getInt();
-            unsigned int T = (unsigned) tokenizer.getInt();
-            irSignal = (T == Tokenizer::invalid)
-                    ? Rc5Renderer::newIrSignal(D, F)
-                    : Rc5Renderer::newIrSignal(D, F, T);
+            long D = tokenizer.getInt();
+            long F = tokenizer.getInt();
+            long T = tokenizer.getInt();
+            if (D >= 0L && F >= 0L)
+                irSignal = (T == Tokenizer::invalid)
+                        ? Rc5Renderer::newIrSignal((unsigned) D, (unsigned) F)
+                        : T >= 0L ? Rc5Renderer::newIrSignal((unsigned) D, (unsigned) F, (unsigned) T) : NULL;
         } else {
             stream.print(F("no such protocol: "));
             stream.println(protocol);
         }
+        tokenizer.skipRest();
         bool status = false;
         if (irSignal != NULL) {
             status = sendIrSignal(*irSignal, noSends); // waits, blinks
@@ -445,11 +555,15 @@ static bool processCommand(const String& line, Stream& stream) {
         stream.println(F(errorString));
     }
 
+    tokenizer.skipRest();
     return true;
 }
 
 void loop() {
     Stream& stream = Serial;
-    String line = readCommand(stream);
-    processCommand(line, stream);
+    while (stream.available() == 0)
+        yield();
+
+    tokenizer.newLine();
+    processCommand(tokenizer, stream);
 }
@@ -1,59 +1,121 @@
-#include <Arduino.h>
 #include "Tokenizer.h"
 
-Tokenizer::Tokenizer(const String& str) : index(0), payload(str) {
-    trim();
+Tokenizer::Tokenizer(Stream& stream_, char eol_, unsigned long timeout_)
+: stream(stream_), timeout(timeout_), eol(eol_), endOfLine(false), pending(noChar) {
+    token[0] = '\0';
 }
 
-void Tokenizer::trim() {
-};
+void Tokenizer::newLine() {
+    endOfLine = false;
+}
+
+int Tokenizer::readChar() {
+    unsigned long start = millis();
+    while (stream.available() == 0) {
+        if (millis() - start >= timeout)
+            return noChar;
+        yield();
+    }
+    return stream.read();
+}
+
+int Tokenizer::peekChar() {
+    if (endOfLine)
+        return noChar;
+    if (pending == noChar)
+        pending = readChar();
+    if (pending == noChar || pending == eol) {
+        pending = noChar;
+        endOfLine = true;
+        return noChar;
+    }
+    return pending;
+}
+
+void Tokenizer::consumeChar() {
+    pending = noChar;
+}
 
-Tokenizer::~Tokenizer() {
+bool Tokenizer::isSpace(int ch) {
+    return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
 }
 
-String Tokenizer::getRest() {
-    String result = index == invalidIndex ? String("") :
-            payload.substring(index);
-    index = invalidIndex;
-    return result;
+bool Tokenizer::skipSpaces() {
+    int ch;
+    while (isSpace(ch = peekChar()))
+        consumeChar();
+    return ch != noChar;
 }
 
-String Tokenizer::getLine() {
-    if (index == invalidIndex)
-        return String("");
+const char *Tokenizer::getToken() {
+    size_t length = 0U;
+    if (skipSpaces()) {
+        int ch;
+        while ((ch = peekChar()) != noChar && !isSpace(ch)) {
+            if (length < maxTokenLength)
+                token[length++] = (char) ch;
+            consumeChar();
+        }
+    }
+    token[length] = '\0';
+    return token;
+}
 
-    int i = payload.indexOf('\n', index);
-    String s = (i > 0) ?
-            payload.substring(index, i) : payload.substring(index);
-    index = (i > 0) ? i + 1 : invalidIndex;
-    return s;
+int Tokenizer::digitValue(int ch, unsigned int base) {
+    int value = (ch >= '0' && ch <= '9') ? ch - '0'
+            : (ch >= 'a' && ch <= 'f') ? ch - 'a' + 10
+            : (ch >= 'A' && ch <= 'F') ? ch - 'A' + 10
+            : -1;
+    return value < (int) base ? value : -1;
 }
 
-String Tokenizer::getToken() {
-    if (index < 0)
-        return String("");
+long Tokenizer::getNumber(unsigned int base) {
+    if (!skipSpaces())
+        return invalid;
 
-    int i = payload.indexOf(' ', index);
-    String s = (i > 0) ?
-            payload.substring(index, i) : payload.substring(index);
-    index = (i > 0) ? i : invalidIndex;
-    if (index != invalidIndex)
-        while (payload.charAt(index) == ' ')
-            index++;
-    return s;
+    bool negative = peekChar() == '-';
+    if (negative)
+        consumeChar();
+    long result = 0L;
+    bool ok = false;
+    int ch;
+    while ((ch = peekChar()) != noChar && !isSpace(ch)) {
+        int digit = digitValue(ch, base);
+        if (digit < 0 || result > (LONG_MAX - digit) / (long) base) {
+            ok = false;
+            // Consume the rest of the malformed, or too large, token
+            while ((ch = peekChar()) != noChar && !isSpace(ch))
+                consumeChar();
+            break;
+        }
+        result = (long) base * result + digit;
+        ok = true;
+        consumeChar();
+    }
+    return ok ? (negative ? -result : result) : invalid;
 }
 
 long Tokenizer::getInt() {
-    String token = getToken();
-    return token == "" ? (long) invalid : token.toInt();
+    return getNumber(10U);
+}
+
+long Tokenizer::getHex() {
+    return getNumber(16U);
 }
 
 microseconds_t Tokenizer::getMicroseconds() {
-    long t = getToken().toInt();
-    return (microseconds_t) ((t < MICROSECONDS_T_MAX) ? t : MICROSECONDS_T_MAX);
+    long t = getInt();
+    return t <= 0L ? 0U // also invalid
+            : (microseconds_t) (((unsigned long) t < MICROSECONDS_T_MAX) ? t : MICROSECONDS_T_MAX);
 }
 
 frequency_t Tokenizer::getFrequency() {
-    long t = getToken().toInt();
-    return (frequency_t) t;
+    long t = getInt();
+    return t < 0L || (unsigned long) t > IrSignal::maxFrequency ? IrSignal::invalidFrequency // also invalid
+            : (frequency_t) t;
+}
+
+void Tokenizer::skipRest() {
+    while (peekChar() != noChar)
+        consumeChar();
 }
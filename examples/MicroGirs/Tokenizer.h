@@ -1,26 +1,86 @@
 #pragma once
 
+#include <Arduino.h>
 #include <InfraredTypes.h>
+#include <IrSignal.h>
 #include <limits.h>
 
+/**
+ * Streaming tokenizer for the command lines of MicroGirs.
+ * The characters are read from the Stream as they are needed, and numbers are
+ * converted on the fly, so no String or other dynamic memory is used.
+ * Only the current word token is stored, in a fixed buffer.
+ * A line is terminated by eol, or by a timeout.
+ */
 class Tokenizer {
 private:
-    static const int invalidIndex = -1;
+    static const size_t maxTokenLength = 15U;
+    static const int noChar = -1;
 
-    int index; // signed since invalidIndex is possible
-    const String& payload;
-    void trim();
+    Stream& stream;
+    unsigned long timeout;
+    char eol;
+    bool endOfLine;
+    int pending; // character read but not consumed, or noChar
+    char token[maxTokenLength + 1];
+
+    int readChar();
+    int peekChar();
+    void consumeChar();
+    static bool isSpace(int ch);
+    bool skipSpaces();
+    static int digitValue(int ch, unsigned int base);
+    long getNumber(unsigned int base);
 
 public:
-    Tokenizer(const String &str);
-    virtual ~Tokenizer();
+    /**
+     * Constructor.
+     * @param stream Stream to read from
+     * @param eol character terminating a line
+     * @param timeout milliseconds to wait for a character before considering the line ended
+     */
+    Tokenizer(Stream& stream, char eol, unsigned long timeout);
+
+    /** Prepares for reading a new line. */
+    void newLine();
 
-    String getToken();
-    String getRest();
-    String getLine();
+    /**
+     * Reads the next whitespace delimited token. Longer tokens are truncated.
+     * @return token, valid until the next call to getToken; empty at the end of the line.
+     */
+    const char *getToken();
+
+    /**
+     * Reads the next token as a decimal number.
+     * @return number, or invalid if the line has ended, or the token is not a number or too large for a long.
+     */
     long getInt();
+
+    /**
+     * Reads the next token as a hexadecimal number.
+     * @return number, or invalid if the line has ended, or the token is not a number or too large for a long.
+     */
+    long getHex();
+
+    /**
+     * Reads the next token as a duration, limited to MICROSECONDS_T_MAX.
+     * @return duration, or 0 if the line has ended or the token is not a positive number.
+     */
     microseconds_t getMicroseconds();
+
+    /**
+     * Reads the next token as a modulation frequency in Hz, 0 for none.
+     * @return frequency, or IrSignal::invalidFrequency if missing, negative, or above IrSignal::maxFrequency.
+     */
     frequency_t getFrequency();
 
-    static const int invalid = INT_MAX;
+    bool isEndOfLine() const {
+        return endOfLine;
+    }
+
+    /** Consumes the rest of the line. */
+    void skipRest();
+
+    /** Returned for a missing or malformed number; not a value that can be read. */
+    static const long invalid = LONG_MIN;
 };
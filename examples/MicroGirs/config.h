@@ -28,6 +28,10 @@
 // Support sending signals without modulation, e.g. with RF module.
 #define NON_MOD
 
+// Support the compact binary framing (see BinaryFrame.h) for send, receive,
+// and capture, switched on by the "binary" command.
+#define BINARY
+
 // Character that ends the command lines
 #define EOLCHAR '\r'
 
@@ -40,6 +44,13 @@
 // Size of capture and receive arrays
 #define DEFAULT_CAPTURESIZE 400U // must be even
 
+// Capacity, in durations (or Pronto numbers), of the statically allocated
+// buffer for the send and hex commands.
+#define SIGNAL_BUFFER_SIZE 200U
+
+// Largest number of sends in one command; more would keep the unit busy for minutes.
+#define MAX_NO_SENDS 100L
+
 #ifdef RECEIVE
 // This quantity is added to all gaps and subtracted from all marks when receiving.
 #define IRRECEIVER_MARK_EXCESS 50
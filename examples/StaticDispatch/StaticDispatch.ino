@@ -0,0 +1,101 @@
+// This sketch compares decoding through the virtual IrReader interface
+// with decoding through the template constructor of Nec1Decoder, which knows
+// the concrete reader class, see "Static dispatch" in README.md.
+// It prints the cycles per call of getDuration() and of decoding a NEC1 signal,
+// measured with micros() over many calls; no IR hardware is needed.
+//
+// For the flash and RAM sizes, build it with DISPATCH set to 1 and to 2,
+// and compare the sizes printed by the IDE (avr-size).
+
+#include <IrSequenceReader.h>
+#include <Nec1Decoder.h>
+
+// 0: measure both, 1: only the virtual version, 2: only the static version
+#define DISPATCH 0
+
+static const unsigned long BAUD = 115200UL;
+static const unsigned int repetitions = 1000U;
+
+// NEC(1) 122 29 with no repetition
+static const microseconds_t array[] = {
+   9024, 4512, 564, 564, 564, 1692, 564, 564, 564, 1692, 564, 1692,
+   564, 1692, 564, 1692, 564, 564, 564, 1692, 564, 564, 564, 1692,
+   564, 564, 564, 564, 564, 564, 564, 564, 564, 1692, 564, 1692, 564,
+   564, 564, 1692, 564, 1692, 564, 1692, 564, 564, 564, 564, 564, 564,
+   564, 564, 564, 1692, 564, 564, 564, 564, 564, 564, 564, 1692, 564,
+   1692, 564, 1692, 564, 39756
+};
+
+static const IrSequence irSequence(array, sizeof(array) / sizeof(microseconds_t));
+static IrSequenceReader reader(irSequence);
+static volatile uint32_t sink;
+
+#if DISPATCH != 2
+static void __attribute__((noinline)) sumVirtual(const IrReader& irReader) {
+    uint32_t sum = 0UL;
+    for (size_t i = 0U; i < irReader.getDataLength(); i++)
+        sum += irReader.getDuration(i);
+    sink = sum;
+}
+
+static bool __attribute__((noinline)) decodeVirtual(const IrReader& irReader) {
+    Nec1Decoder decoder(irReader);
+    return decoder.isValid();
+}
+#endif
+
+#if DISPATCH != 1
+static void __attribute__((noinline)) sumStatic(const IrSequenceReader& irReader) {
+    uint32_t sum = 0UL;
+    for (size_t i = 0U; i < irReader.getDataLength(); i++)
+        sum += irReader.getDuration(i);
+    sink = sum;
+}
+
+static bool __attribute__((noinline)) decodeStatic(const IrSequenceReader& irReader) {
+    Nec1Decoder decoder(irReader);
+    return decoder.isValid();
+}
+#endif
+
+static void report(const char *what, unsigned long elapsed, unsigned int calls) {
+    Serial.print(what);
+    Serial.print(F(": "));
+    Serial.print((uint32_t) ((uint64_t) elapsed * (F_CPU / 1000000UL) / calls));
+    Serial.println(F(" cycles per call"));
+}
+
+void setup() {
+    Serial.begin(BAUD);
+    while (!Serial)
+        ;
+    unsigned long start;
+    bool ok = true;
+#if DISPATCH != 2
+    start = micros();
+    for (unsigned int i = 0U; i < repetitions; i++)
+        sumVirtual(reader);
+    report("getDuration, virtual", micros() - start, repetitions * reader.getDataLength());
+
+    start = micros();
+    for (unsigned int i = 0U; i < repetitions; i++)
+        ok = decodeVirtual(reader) && ok;
+    report("Nec1Decoder, virtual", micros() - start, repetitions);
+#endif
+#if DISPATCH != 1
+    start = micros();
+    for (unsigned int i = 0U; i < repetitions; i++)
+        sumStatic(reader);
+    report("getDuration, static", micros() - start, repetitions * reader.getDataLength());
+
+    start = micros();
+    for (unsigned int i = 0U; i < repetitions; i++)
+        ok = decodeStatic(reader) && ok;
+    report("Nec1Decoder, static", micros() - start, repetitions);
+#endif
+    if (!ok)
+        Serial.println(F("decode failed"));
+}
+
+void loop() {
+}
@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include <string>
 #include <iostream>
 #include <sys/time.h>
@@ -14,6 +15,7 @@
 
 #include "InfraredTypes.h"
 #include "PinModeStatus.h"
+#include "SimulatedClock.h"
 
 typedef void *uint_farptr_t;
 typedef void __FlashStringHelper;
@@ -28,6 +30,8 @@ typedef void __FlashStringHelper;
 #define substring substr
 
 #define F(x) x
+#define PROGMEM
+#define memcpy_P memcpy
 
 #define A0 100
 #define A1 101
@@ -39,56 +43,24 @@ typedef void __FlashStringHelper;
 #define A7 107
 #define  LED_BUILTIN 13
 
-// Can't use pin_t yet
-extern uint8_t currentWritePin; // SIL.cpp
-extern struct timeval simulatedTime;
+// Can't use pin_t yet. The pin state is kept in SIL.cpp, see SIL.h.
+void pinMode(uint8_t pin, PinMode mode);
 
-static timeval getTimeOfDay() {
 #ifdef REAL_TIME
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    return tv;
-#else
-    return simulatedTime;
-#endif
-}
-
-static struct timeval last = getTimeOfDay();
-static PinStatus lastValue = LOW;
-
-inline void pinMode(uint8_t pin, PinMode mode) {
-    std::cout << "pinMode(" << (int) pin << ", "
-            << (mode == INPUT ? "INPUT" : mode == OUTPUT ? "OUTPUT" : mode == INPUT_PULLUP ? "INPUT_PULLUP" : "INPUT_PULLDOWN")
-            << ")" << std::endl;
-    if (mode == OUTPUT) {
-        currentWritePin = pin;
-        lastValue = LOW;
-    }
-};
 
 inline void delayMicroseconds(unsigned int t) {
-#ifdef REAL_TIME
     usleep(t);
-#else
-    simulatedTime.tv_sec += t/1000000U;
-    simulatedTime.tv_usec += t % 1000000U;
-    while (simulatedTime.tv_usec > 1000000U) {
-        simulatedTime.tv_usec -= 1000000U;
-        simulatedTime.tv_sec++;
-    }
-#endif
 };
 
 inline void delay(unsigned long t) {
-    delayMicroseconds(1000U * t);
+    usleep(1000U * t);
 };
 
-inline void noInterrupts() {};
-inline void interrupts() {};
 inline void yield() {};
 
 inline unsigned long micros() {
-    struct timeval tv = getTimeOfDay();
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
     // Probably overflows, but this should be OK in 99.99% of all cases, which is enough here.
     return 1000000UL * tv.tv_sec + tv.tv_usec;
 }
@@ -100,36 +72,72 @@ inline unsigned long millis() {
     return 1000*tv.tv_sec + tv.tv_usec/1000;
 }
 
-inline uint8_t digitalRead(uint8_t pin __attribute__((unused))) {
-    return 0;
+inline void noInterrupts() {};
+inline void interrupts() {};
+
+#else // ! REAL_TIME
+
+inline void delayMicroseconds(unsigned int t) {
+    SimulatedClock::advance(t);
+};
+
+inline void delay(unsigned long t) {
+    SimulatedClock::advance(1000ULL * t);
+};
+
+// Polling loops on the host would otherwise never see the simulated time pass.
+inline void yield() {
+    SimulatedClock::advance(1U);
+};
+
+inline unsigned long micros() {
+    return (unsigned long) SimulatedClock::now();
+}
+
+inline unsigned long millis() {
+    return (unsigned long) (SimulatedClock::now() / 1000U);
+}
+
+inline void noInterrupts() {
+    SimulatedClock::disableInterrupts();
 };
 
-inline void digitalWrite(uint8_t pin __attribute__((unused)), PinStatus value) {
-#ifdef REPORT_TIMES
-//    if (pin != currentPin)
-//        return;
-    struct timeval now = getTimeOfDay();
-    if (lastValue == -1)
-        if (value == LOW)
-            return;
-        else {
-            lastValue = value;
-            last = now;
-        }
-    else if (lastValue == (value != LOW))
-        return;
-    else {
-        char sign = value ? '-' : '+';
-        std::cout << sign << 1000000UL * (now.tv_sec - last.tv_sec) + (now.tv_usec - last.tv_usec) << " ";
-        last = now;
-        lastValue = value;
-    }
-#else
-    std::cout << "digitalWrite(" << (int) pin << ", "
-            << (value == LOW ? "LOW" : "HIGH") << ")" << std::endl;
-#endif
+inline void interrupts() {
+    SimulatedClock::enableInterrupts();
 };
 
+#endif // ! REAL_TIME
+
+#define ISR(vector) void vector()
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+inline uint8_t digitalPinToInterrupt(uint8_t pin) {
+    return pin;
+}
+
+/**
+ * The function is called (as event of SimulatedClock) at the edges of the input pin
+ * played back by SIL::inject, see SIL.h.
+ */
+void attachInterrupt(uint8_t interrupt, void (*function)(), int mode);
+
+void detachInterrupt(uint8_t interrupt);
+
+/**
+ * Returns the level of a simulated input (SIL::inject) at the current time,
+ * otherwise the level last written to the pin.
+ */
+uint8_t digitalRead(uint8_t pin);
+
+/**
+ * Records the edge in the timeline of the pin, if probed (see SIL.h).
+ * With REPORT_TIMES, the time since the previous edge of the pin is also printed,
+ * with the sign of the level that ended ("+" for a mark).
+ */
+void digitalWrite(uint8_t pin, PinStatus value);
 
 #define F_CPU 16000000 // Good default, correct for Unu etc
 
@@ -140,6 +148,8 @@ private:
     std::ostream& stream;
 public:
     Stream(std::ostream& stream_) : stream(stream_) {};
+    size_t write(uint8_t c) { stream.put((char) c); return 1; };
+    size_t write(const char *buffer, size_t size) { stream.write(buffer, (std::streamsize) size); return size; };
     void print(char c) { stream << c; };
     void print(const char *c) { stream << c; };
     void print(const std::string& string) { stream << string; };
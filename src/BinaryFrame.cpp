@@ -0,0 +1,219 @@
+#include "BinaryFrame.h"
+
+uint8_t BinaryFrame::varintLength(uint32_t value) {
+    uint8_t length = 1U;
+    while (value >= 0x80UL) {
+        value >>= 7U;
+        length++;
+    }
+    return length;
+}
+
+uint16_t BinaryFrame::crc16(uint16_t crc, uint8_t byte) {
+    crc ^= (uint16_t) byte << 8U;
+    for (uint8_t i = 0U; i < 8U; i++)
+        crc = (crc & 0x8000U) ? (uint16_t) ((crc << 1U) ^ 0x1021U) : (uint16_t) (crc << 1U);
+    return crc;
+}
+
+BinaryFrame::Writer::Writer(Stream& stream_, uint8_t type, uint32_t payloadLength) : stream(stream_), crc(0xFFFFU) {
+    stream.write(sync);
+    put(type);
+    putVarint(payloadLength);
+}
+
+void BinaryFrame::Writer::put(uint8_t byte) {
+    stream.write(byte);
+    crc = crc16(crc, byte);
+}
+
+void BinaryFrame::Writer::putVarint(uint32_t value) {
+    while (value >= 0x80UL) {
+        put((uint8_t) (value | 0x80U));
+        value >>= 7U;
+    }
+    put((uint8_t) value);
+}
+
+void BinaryFrame::Writer::finish() {
+    uint16_t finalCrc = crc;
+    stream.write((uint8_t) (finalCrc >> 8U));
+    stream.write((uint8_t) (finalCrc & 0xFFU));
+}
+
+uint32_t BinaryFrame::payloadLength(const IrSequence& irSequence) {
+    uint32_t length = 0UL;
+    for (size_t i = 0U; i < irSequence.getLength(); i++)
+        length += varintLength(irSequence.getDurations()[i]);
+    return length;
+}
+
+void BinaryFrame::writeDurations(Writer& writer, const IrSequence& irSequence) {
+    for (size_t i = 0U; i < irSequence.getLength(); i++)
+        writer.putVarint(irSequence.getDurations()[i]);
+}
+
+void BinaryFrame::write(Stream& stream, const IrReader& irReader) {
+    size_t length = irReader.getDataLength();
+    uint32_t payload = varintLength(irReader.getFrequency()) + varintLength(length) + 2U;
+    for (size_t i = 0U; i < length; i++)
+        payload += varintLength(irReader.getDuration(i));
+
+    Writer writer(stream, signalType, payload);
+    writer.putVarint(irReader.getFrequency());
+    writer.putVarint(length);
+    writer.putVarint(0U);
+    writer.putVarint(0U);
+    for (size_t i = 0U; i < length; i++)
+        writer.putVarint(irReader.getDuration(i));
+    writer.finish();
+}
+
+void BinaryFrame::write(Stream& stream, const IrSignal& irSignal) {
+    uint32_t payload = varintLength(irSignal.getFrequency())
+            + varintLength(irSignal.getIntro().getLength())
+            + varintLength(irSignal.getRepeat().getLength())
+            + varintLength(irSignal.getEnding().getLength())
+            + payloadLength(irSignal.getIntro())
+            + payloadLength(irSignal.getRepeat())
+            + payloadLength(irSignal.getEnding());
+
+    Writer writer(stream, signalType, payload);
+    writer.putVarint(irSignal.getFrequency());
+    writer.putVarint(irSignal.getIntro().getLength());
+    writer.putVarint(irSignal.getRepeat().getLength());
+    writer.putVarint(irSignal.getEnding().getLength());
+    writeDurations(writer, irSignal.getIntro());
+    writeDurations(writer, irSignal.getRepeat());
+    writeDurations(writer, irSignal.getEnding());
+    writer.finish();
+}
+
+void BinaryFrame::writeTimeout(Stream& stream) {
+    Writer writer(stream, timeoutType, 0U);
+    writer.finish();
+}
+
+BinaryFrame::Parser::Parser(microseconds_t *buffer_, size_t capacity_) : buffer(buffer_), capacity(capacity_) {
+    reset();
+}
+
+void BinaryFrame::Parser::reset() {
+    state = stateSync;
+    status = incomplete;
+    type = timeoutType;
+    crc = 0xFFFFU;
+    receivedCrc = 0U;
+    payloadLength = 0UL;
+    payloadRead = 0UL;
+    value = 0UL;
+    shift = 0U;
+    for (uint8_t i = 0U; i < headerLength; i++)
+        header[i] = 0UL;
+    headerRead = 0U;
+    durationsLength = 0U;
+    durationsRead = 0U;
+}
+
+BinaryFrame::Parser::Status BinaryFrame::Parser::fail() {
+    state = stateDone;
+    status = error;
+    return status;
+}
+
+// Returns true when a complete varint has been assembled in value.
+bool BinaryFrame::Parser::feedVarint(uint8_t byte) {
+    if (shift > 28U)
+        return false;
+    value |= (uint32_t) (byte & 0x7FU) << shift;
+    shift = (uint8_t) (shift + 7U);
+    return (byte & 0x80U) == 0U;
+}
+
+BinaryFrame::Parser::Status BinaryFrame::Parser::feed(uint8_t byte) {
+    if (state != stateSync && state != stateCrcHigh && state != stateCrcLow && state != stateDone)
+        crc = crc16(crc, byte);
+
+    switch (state) {
+        case stateSync:
+            // Garbage before the sync byte is ignored
+            if (byte == sync)
+                state = stateType;
+            break;
+
+        case stateType:
+            type = byte;
+            state = stateLength;
+            break;
+
+        case stateLength:
+            if (shift > 28U)
+                return fail();
+            if (feedVarint(byte)) {
+                payloadLength = value;
+                value = 0UL;
+                shift = 0U;
+                state = payloadLength > 0UL ? statePayload : stateCrcHigh;
+            }
+            break;
+
+        case statePayload:
+            payloadRead++;
+            if (payloadRead > payloadLength || shift > 28U)
+                return fail();
+            if (feedVarint(byte)) {
+                if (headerRead < headerLength) {
+                    header[headerRead++] = value;
+                    if (headerRead == 1U && value > IrSignal::maxFrequency)
+                        return fail();
+                    if (headerRead == headerLength) {
+                        // Each length on its own first, so that the sum cannot wrap.
+                        for (uint8_t i = 1U; i < headerLength; i++)
+                            if (header[i] > capacity)
+                                return fail();
+                        uint64_t total = (uint64_t) header[1] + header[2] + header[3];
+                        if (total > capacity)
+                            return fail();
+                        durationsLength = (size_t) total;
+                    }
+                } else {
+                    if (durationsRead >= durationsLength || value == 0UL || toMicroseconds(value) != value)
+                        return fail();
+                    buffer[durationsRead++] = (microseconds_t) value;
+                }
+                value = 0UL;
+                shift = 0U;
+            }
+            if (payloadRead == payloadLength)
+                state = stateCrcHigh;
+            break;
+
+        case stateCrcHigh:
+            receivedCrc = (uint16_t) byte << 8U;
+            state = stateCrcLow;
+            break;
+
+        case stateCrcLow:
+            receivedCrc |= byte;
+            state = stateDone;
+            if (receivedCrc != crc || shift != 0U)
+                return fail();
+            if (type == signalType && (headerRead < headerLength || durationsRead != durationsLength))
+                return fail();
+            status = complete;
+            break;
+
+        default:
+            break;
+    }
+    return status;
+}
+
+IrSignal BinaryFrame::Parser::toIrSignal() const {
+    size_t introLength = (size_t) header[1];
+    size_t repeatLength = (size_t) header[2];
+    return IrSignal(buffer, introLength,
+            buffer + introLength, repeatLength,
+            buffer + introLength + repeatLength, (size_t) header[3],
+            getFrequency());
+}
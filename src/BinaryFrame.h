@@ -0,0 +1,175 @@
+/*
+Copyright (C) 2020 Bengt Martensson.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see http://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include "IrReader.h"
+#include "IrSignal.h"
+
+/**
+ * Compact binary framing of IR signals, for serial communication.
+ *
+ * A frame consists of the sync byte, a type byte, the length of the payload as varint,
+ * the payload, and a CRC-16/CCITT (polynomial 0x1021, initial value 0xFFFF),
+ * most significant byte first, computed over type, length, and payload.
+ *
+ * The payload of a signal frame consists of the frequency, the lengths of intro,
+ * repeat, and ending, and the durations, all as varints.
+ * A varint stores 7 bits per byte, least significant group first;
+ * the high bit is set on all but the last byte. Thus a typical duration takes two bytes.
+ * A timeout frame has an empty payload.
+ */
+class BinaryFrame {
+public:
+    static const uint8_t sync = 0xA5U;
+    static const uint8_t timeoutType = 0x00U;
+    static const uint8_t signalType = 0x01U;
+
+    /**
+     * Writes the content of the IrReader as a signal frame, with the durations as intro.
+     * @param stream Stream to write to
+     * @param irReader IrReader with data
+     */
+    static void write(Stream& stream, const IrReader& irReader);
+
+    /**
+     * Writes the IrSignal as a signal frame.
+     * @param stream Stream to write to
+     * @param irSignal IrSignal
+     */
+    static void write(Stream& stream, const IrSignal& irSignal);
+
+    /**
+     * Writes a timeout frame.
+     * @param stream Stream to write to
+     */
+    static void writeTimeout(Stream& stream);
+
+    /**
+     * Returns the number of bytes the value takes as varint.
+     * @param value value to be encoded
+     * @return number of bytes, 1..5
+     */
+    static uint8_t varintLength(uint32_t value);
+
+    /**
+     * Updates a CRC-16/CCITT with one byte.
+     * @param crc previous value
+     * @param byte new byte
+     * @return new value
+     */
+    static uint16_t crc16(uint16_t crc, uint8_t byte);
+
+    /**
+     * Push parser for signal frames. The bytes are fed one at a time, and the
+     * durations are written directly into the buffer supplied by the user.
+     */
+    class Parser {
+    public:
+        enum Status {
+            incomplete, ///< more bytes are needed
+            complete, ///< a valid frame has been read
+            error ///< the frame is invalid (e.g. a zero duration, or a frequency above IrSignal::maxFrequency), too large, or has wrong CRC
+        };
+
+        /**
+         * Constructor.
+         * @param buffer buffer for the durations
+         * @param capacity number of durations the buffer can hold
+         */
+        Parser(microseconds_t *buffer, size_t capacity);
+
+        /** Prepares for a new frame. */
+        void reset();
+
+        /**
+         * Processes one byte.
+         * @param byte next byte of the frame
+         * @return status after the byte
+         */
+        Status feed(uint8_t byte);
+
+        Status getStatus() const {
+            return status;
+        }
+
+        uint8_t getType() const {
+            return type;
+        }
+
+        frequency_t getFrequency() const {
+            return (frequency_t) header[0];
+        }
+
+        /**
+         * Returns an IrSignal referring to the buffer, without copying.
+         * @return IrSignal
+         */
+        IrSignal toIrSignal() const;
+
+    private:
+        enum State {
+            stateSync,
+            stateType,
+            stateLength,
+            statePayload,
+            stateCrcHigh,
+            stateCrcLow,
+            stateDone
+        };
+
+        static const uint8_t headerLength = 4U;
+
+        microseconds_t *buffer;
+        size_t capacity;
+        State state;
+        Status status;
+        uint8_t type;
+        uint16_t crc;
+        uint16_t receivedCrc;
+        uint32_t payloadLength;
+        uint32_t payloadRead;
+        uint32_t value;
+        uint8_t shift;
+        uint32_t header[headerLength];
+        uint8_t headerRead;
+        /** Sum of the lengths in the header, validated against capacity. */
+        size_t durationsLength;
+        size_t durationsRead;
+
+        bool feedVarint(uint8_t byte);
+        Status fail();
+    };
+
+private:
+    BinaryFrame();
+
+    class Writer {
+    public:
+        Writer(Stream& stream, uint8_t type, uint32_t payloadLength);
+        void putVarint(uint32_t value);
+        void finish();
+
+    private:
+        Stream& stream;
+        uint16_t crc;
+        void put(uint8_t byte);
+    };
+
+    static uint32_t payloadLength(const IrSequence& irSequence);
+    static void writeDurations(Writer& writer, const IrSequence& irSequence);
+};
@@ -0,0 +1,44 @@
+#include "Biphase.h"
+
+BiphaseWriter::BiphaseWriter(microseconds_t *durations_, microseconds_t half_)
+: durations(durations_), half(half_), index(0U), pendingSpace(0UL), total(0UL) {
+}
+
+void BiphaseWriter::emit(bool isMark, unsigned int halves) {
+    uint32_t duration = (uint32_t) halves * half;
+    if (!isMark) {
+        pendingSpace += duration;
+        return;
+    }
+    if (pendingSpace > 0UL && index > 0U) {
+        durations[index] = (microseconds_t) pendingSpace;
+        index++;
+        total += pendingSpace;
+    }
+    pendingSpace = 0UL;
+    if (index % 2U == 1U) // the last duration is a mark
+        durations[index - 1U] = (microseconds_t) (durations[index - 1U] + duration);
+    else {
+        durations[index] = (microseconds_t) duration;
+        index++;
+    }
+    total += duration;
+}
+
+void BiphaseWriter::bit(unsigned int value, bool oneIsMarkFirst, unsigned int width) {
+    bool markFirst = ((value & 1U) != 0U) == oneIsMarkFirst;
+    emit(markFirst, width);
+    emit(!markFirst, width);
+}
+
+void BiphaseWriter::msb(unsigned int x, unsigned int count, bool oneIsMarkFirst) {
+    for (unsigned int mask = 1U << (count - 1U); mask != 0U; mask >>= 1U)
+        bit((x & mask) != 0U ? 1U : 0U, oneIsMarkFirst);
+}
+
+size_t BiphaseWriter::end(microseconds_t gap) {
+    durations[index] = gap;
+    index++;
+    pendingSpace = 0UL;
+    return index;
+}
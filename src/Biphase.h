@@ -0,0 +1,201 @@
+/*
+Copyright (C) 2020 Bengt Martensson.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see http://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include "InfraredTypes.h"
+
+/**
+ * Reads biphase (Manchester) coded bits from the durations of a reader, in one pass.
+ * Used by Rc5Decoder and Rc6Decoder.
+ *
+ * Every duration is rounded to a number of half bits, and rejected
+ * if it deviates from that by more than the tolerance.
+ * The final duration is taken as a space of arbitrary length,
+ * into which the last half bit may merge.
+ */
+template<class Reader>
+class BiphaseReader {
+public:
+    /**
+     * @param reader IrReader (or subclass) with data
+     * @param half duration of a half bit
+     * @param tolerance largest deviation of a duration from a multiple of half
+     */
+    BiphaseReader(const Reader& reader_, microseconds_t half_, microseconds_t tolerance_)
+    : reader(reader_), length(reader_.getDataLength()), half(half_), tolerance(tolerance_),
+            index(0U), remaining(0U), mark(false), ending(false) {
+    }
+
+    /**
+     * Pretends that the data is preceded by a space of some half bits;
+     * for protocols starting with a bit whose first half is a space.
+     * @param halves number of half bits
+     */
+    void assumeSpace(unsigned int halves) {
+        mark = false;
+        remaining = halves;
+    }
+
+    /**
+     * Consumes a mark or a space of a number of half bits, like a leader.
+     * @param isMark true for a mark
+     * @param halves number of half bits
+     * @return true if present
+     */
+    bool expect(bool isMark, unsigned int halves) {
+        return level(halves) == (isMark ? 1 : 0);
+    }
+
+    /**
+     * Reads one bit.
+     * @param oneIsMarkFirst true if a one is coded as mark, space (RC6), false if space, mark (RC5)
+     * @param width number of half bits of every half; 2 for the RC6 trailer bit
+     * @return 0, 1, or -1 if no valid bit
+     */
+    int bit(bool oneIsMarkFirst, unsigned int width = 1U) {
+        int first = level(width);
+        if (first < 0)
+            return -1;
+        int second = level(width);
+        if (second < 0 || second == first)
+            return -1;
+        return (first == 1) == oneIsMarkFirst ? 1 : 0;
+    }
+
+    /**
+     * Reads a number of bits, most significant first.
+     * @param oneIsMarkFirst as for bit()
+     * @param count number of bits
+     * @return value, or -1 if not valid
+     */
+    int msb(bool oneIsMarkFirst, unsigned int count) {
+        int sum = 0;
+        for (unsigned int i = 0U; i < count; i++) {
+            int b = bit(oneIsMarkFirst);
+            if (b < 0)
+                return -1;
+            sum = (sum << 1) | b;
+        }
+        return sum;
+    }
+
+    /**
+     * @return true if the data has been consumed, except for the final duration
+     */
+    bool atEnd() const {
+        return ending || (remaining == 0U && index == length - 1U);
+    }
+
+private:
+    const Reader& reader;
+    size_t length;
+    microseconds_t half;
+    microseconds_t tolerance;
+    unsigned int index;     // next duration to read
+    unsigned int remaining; // half bits left of the present duration
+    bool mark;              // the present duration is a mark
+    bool ending;            // the present duration is the final one
+
+    bool load() {
+        if (ending || index >= length)
+            return false;
+        mark = (index & 1U) == 0U;
+        ending = index == length - 1U;
+        microseconds_t duration = reader.getDuration(index++);
+        if (ending)
+            return !mark;
+        remaining = (duration + half / 2U) / half;
+        uint32_t nominal = (uint32_t) remaining * half;
+        return remaining > 0U
+                && (duration >= nominal ? duration - nominal : nominal - duration) <= tolerance;
+    }
+
+    // Consumes halves half bits of the same kind; returns 1 for mark, 0 for space, -1 on error.
+    int level(unsigned int halves) {
+        int result = -1;
+        for (unsigned int i = 0U; i < halves; i++) {
+            if (!ending && remaining == 0U && !load())
+                return -1;
+            if (result >= 0 && result != (mark ? 1 : 0))
+                return -1;
+            result = mark ? 1 : 0;
+            if (!ending)
+                remaining--;
+        }
+        return result;
+    }
+};
+
+/**
+ * Writes biphase (Manchester) coded bits as durations into a buffer supplied by the caller,
+ * merging adjacent half bits of the same kind.
+ * A leading space is dropped, and a trailing space replaced by the ending gap.
+ * Used by Rc5Renderer and Rc6Renderer.
+ */
+class BiphaseWriter {
+public:
+    /**
+     * @param durations buffer, long enough for the signal
+     * @param half duration of a half bit
+     */
+    BiphaseWriter(microseconds_t *durations, microseconds_t half);
+
+    /**
+     * Writes a mark or a space, like a leader.
+     * @param isMark true for a mark
+     * @param halves number of half bits
+     */
+    void emit(bool isMark, unsigned int halves);
+
+    /**
+     * Writes one bit.
+     * @param value bit, only the lowest bit is used
+     * @param oneIsMarkFirst true if a one is coded as mark, space (RC6), false if space, mark (RC5)
+     * @param width number of half bits of every half; 2 for the RC6 trailer bit
+     */
+    void bit(unsigned int value, bool oneIsMarkFirst, unsigned int width = 1U);
+
+    /**
+     * Writes the lowest count bits of x, most significant first.
+     * @param x value
+     * @param count number of bits
+     * @param oneIsMarkFirst as for bit()
+     */
+    void msb(unsigned int x, unsigned int count, bool oneIsMarkFirst);
+
+    /**
+     * @return total duration written so far, not counting a trailing space
+     */
+    uint32_t getTotal() const {
+        return total;
+    }
+
+    /**
+     * Terminates the signal with the ending gap, replacing a trailing space.
+     * @param gap final space
+     * @return number of durations written
+     */
+    size_t end(microseconds_t gap);
+
+private:
+    microseconds_t *durations;
+    microseconds_t half;
+    size_t index;
+    uint32_t pendingSpace;
+    uint32_t total;
+};
@@ -32,4 +32,6 @@ void Board::delayMicroseconds(microseconds_t t) {
     }
 }
 
-Board* Board::instance = new CURRENT_CLASS();
+static CURRENT_CLASS boardInstance;
+Board* Board::instance = &boardInstance;
+unsigned long Board::microsPerTick = Board::defaultMicrosPerTick;
@@ -22,7 +22,9 @@ this program. If not, see http://www.gnu.org/licenses/.
  * (exception: code that runs exclusively on the host).
  *
  * It is a singleton class (since there is only one board), instantiated
- * automatically to one of its subclasses.
+ * automatically to one of its subclasses, CURRENT_CLASS. Since there is only
+ * one board class in a build, Board has no virtual functions; instead it calls
+ * the functions of CURRENT_CLASS directly.
  */
 
 #pragma once
@@ -39,24 +41,59 @@ protected:
 public:
     static void delayMicroseconds(microseconds_t);
 
-    virtual void writeLow();
-    virtual void writeHigh();
+    void writeLow();
+    void writeHigh();
 
-    virtual void writeLow(pin_t pin) { digitalWrite(pin, LOW); };
-    virtual void writeHigh(pin_t pin) { digitalWrite(pin, HIGH); };
+    /**
+     * Writes the pin low. Where the board supports it (HAS_FAST_PIN),
+     * this is done by direct port register access instead of digitalWrite.
+     * @param pin
+     */
+    void writeLow(pin_t pin);
+
+    /**
+     * Writes the pin high. Where the board supports it (HAS_FAST_PIN),
+     * this is done by direct port register access instead of digitalWrite.
+     * @param pin
+     */
+    void writeHigh(pin_t pin);
 
     void setPinMode(pin_t pin, PinMode mode) { pinMode(pin, mode); };
-    bool readDigital(pin_t pin) { return digitalRead(pin); };
 
-    virtual pin_t getPwmPin() const;
+    /**
+     * Reads the pin. Where the board supports it (HAS_FAST_PIN),
+     * this is done by direct port register access instead of digitalRead.
+     * @param pin
+     * @return true if the pin is high
+     */
+    bool readDigital(pin_t pin);
+
+    pin_t getPwmPin() const;
 
     static Board* getInstance() {
         return instance;
     };
 
-    static const unsigned long microsPerTick = 50UL; // was USECPERTICK
+    /** Default sampling period of IrReceiverSampler, in microseconds. */
+    static const unsigned long defaultMicrosPerTick = 50UL; // was USECPERTICK
 
-    virtual void checkValidSendPin(pin_t pin __attribute__((unused))) {/* TODO */};
+    /** Range of sampling periods supported; a board class may narrow it. */
+    static const unsigned long minMicrosPerTick = 10UL;
+    static const unsigned long maxMicrosPerTick = 100UL;
+
+    /**
+     * Sets the sampling period of IrReceiverSampler. A shorter period gives finer durations,
+     * at the cost of more interrupts. Takes effect at the next IrReceiverSampler::enable().
+     * @param micros period in microseconds, between minMicrosPerTick and maxMicrosPerTick of the board
+     * @return false if not supported; then the period is not changed
+     */
+    static bool setMicrosPerTick(unsigned long micros);
+
+    static unsigned long getMicrosPerTick() {
+        return microsPerTick;
+    }
+
+    void checkValidSendPin(pin_t pin __attribute__((unused))) {/* TODO */};
 
     /**
      * Constant indicating no or invalid pin.
@@ -71,18 +108,12 @@ public:
     /**
      * Start the periodic ISR sampler routine. Called from IrReceiveSampler.
      */
-    virtual void enableSampler(pin_t pin __attribute__((unused))) {
-        timerConfigNormal();
-        timerEnableIntr();
-        timerReset();
-    }
+    void enableSampler(pin_t pin);
 
     /**
      * Turn off sampler routine.
      */
-    virtual void disableSampler() {
-        timerDisableIntr();
-    }
+    void disableSampler();
 
     /**
      * Start PWM, making output active.
@@ -90,12 +121,7 @@ public:
      * @param frequency
      * @param dutyCycle
      */
-    void enablePwm(pin_t pin, frequency_t frequency, dutycycle_t dutyCycle) {
-        checkValidSendPin(pin);
-        //pinMode(getPin(), OUTPUT);
-        //writeLow();
-        timerConfigHz(frequency, dutyCycle);
-    }
+    void enablePwm(pin_t pin, frequency_t frequency, dutycycle_t dutyCycle);
 
     /**
      * Turn off PWM.
@@ -103,52 +129,108 @@ public:
     void disablePwm() {
     }
 
-    void sendPwmMark(microseconds_t time) {
-        timerEnablePwm(); // supposed to turn on
-        delayMicroseconds(time);
-        timerDisablePwm();
-    }
+    void sendPwmMark(microseconds_t time);
 
     /**
-     * TODO
+     * Start periodic timer interrupts at the carrier frequency,
+     * for IrSenderPwmTimer, which then owns the timer ISR (IR_SENDER_TIMER),
+     * and splits every period into on- and off-time with setCarrierTimerTop.
+     * @param frequency carrier frequency
+     * @return number of timer clocks in a carrier period
      */
-    virtual void timerReset() {};
+    uint16_t enableCarrierTimer(frequency_t frequency);
+
+    /**
+     * Sets the length of the timer interval presently running; to be called early in the ISR.
+     * @param top timer clocks of the interval, minus one
+     */
+    void setCarrierTimerTop(uint16_t top);
+
+    /**
+     * Turn off the interrupts started by enableCarrierTimer.
+     */
+    void disableCarrierTimer();
+
+    /**
+     * To be called first thing in the sampler ISR; acknowledges the timer interrupt,
+     * if the hardware requires it.
+     */
+    void timerReset();
+
+    /**
+     * Returns the counter of the sampling timer, in timer clocks since the last interrupt,
+     * or 0 if the board does not implement it. See IrReceiverSampler::getIsrStatistics.
+     */
+    uint16_t getTimerCount();
 
 protected:
+    // The following functions are to be implemented by the board class
+    // (CURRENT_CLASS). They are not virtual; the public functions above
+    // call them on the board class directly, so the calls can be inlined.
+    // A board class with these functions private has to declare Board as friend.
+
+    /**
+     * Acknowledge the timer interrupt. Boards not requiring this need not implement it.
+     */
+    void timerAcknowledgeIntr() {};
+
+    /**
+     * Current value of the counter of the sampling timer, counting up from 0 at every interrupt.
+     * Only used for the ISR statistics; boards not implementing it report 0.
+     */
+    uint16_t timerCount() { return 0U; };
+
     /**
      * Start periodic sampling routine.
      */
-    virtual void timerEnableIntr() = 0;
+    void timerEnableIntr();
 
     /**
      * Turn off periodic interrupts.
      * @return
      */
-    virtual void timerDisableIntr() = 0;
+    void timerDisableIntr();
+
+    /**
+     * Configure the timer for periodic interrupts with the frequency given, without PWM output.
+     * Implemented on the boards having HAS_CARRIER_TIMER.
+     * @param hz interrupt frequency
+     * @return number of timer clocks in a period
+     */
+    uint16_t timerConfigPeriodic(frequency_t hz);
+
+    /**
+     * Sets the compare value ending the present period of timerConfigPeriodic.
+     * @param top timer clocks of the period, minus one
+     */
+    void timerSetTop(uint16_t top);
 
     /**
      * Configure hardware PWM, but do not enable it.
      * @return
      */
-    virtual void timerConfigHz(frequency_t hz, dutycycle_t dutyCycle = defaultDutyCycle) = 0;
+    void timerConfigHz(frequency_t hz, dutycycle_t dutyCycle = defaultDutyCycle);
 
     /**
      * Disables the PWM configuration.
      * @return
      */
-    virtual void timerConfigNormal() = 0;
+    void timerConfigNormal();
 
     /**
      * Start PWM output.
      * @return
      */
-    virtual void timerEnablePwm() = 0;
+    void timerEnablePwm();
 
     /**
      * Turn off PWM output.
      * @return
      */
-    virtual void timerDisablePwm() = 0;
+    void timerDisablePwm();
+
+    /** Sampling period, as used by timerConfigNormal(). */
+    static unsigned long microsPerTick;
 
 public:
     // Function defined later in this file
@@ -270,6 +352,17 @@ IrSenderPwmHard will not be available.
 
 //#define DEBUG_PIN 2
 
+// Define to measure the sampler ISR, see IrReceiverSampler::getIsrStatistics.
+// The host Makefile defines it in HOSTDEFINES.
+//#define ISR_STATISTICS
+
+// Define to let IrSenderPwmTimer own the timer interrupt, instead of IrReceiverSampler.
+// The two can not be used in the same program.
+//#define IR_SENDER_TIMER
+#if defined(IR_SENDER_TIMER) && !HAS_CARRIER_TIMER
+#error IR_SENDER_TIMER: IrSenderPwmTimer is not implemented for this board (HAS_CARRIER_TIMER)
+#endif
+
 inline void Board::setupDebugPin() {
 #ifdef DEBUG_PIN
     instance->setPinMode(DEBUG_PIN, OUTPUT);
@@ -288,6 +381,92 @@ inline void Board::debugPinLow() {
 #endif
 }
 
+// The board is always an instance of CURRENT_CLASS, so calls through it need not be virtual.
+
+inline void Board::enableSampler(pin_t pin __attribute__((unused))) {
+    CURRENT_CLASS* board = static_cast<CURRENT_CLASS*>(this);
+    board->timerConfigNormal();
+    board->timerEnableIntr();
+    board->timerAcknowledgeIntr();
+}
+
+inline void Board::disableSampler() {
+    static_cast<CURRENT_CLASS*>(this)->timerDisableIntr();
+}
+
+inline void Board::enablePwm(pin_t pin, frequency_t frequency, dutycycle_t dutyCycle) {
+    checkValidSendPin(pin);
+    static_cast<CURRENT_CLASS*>(this)->timerConfigHz(frequency, dutyCycle);
+}
+
+inline void Board::sendPwmMark(microseconds_t time) {
+    CURRENT_CLASS* board = static_cast<CURRENT_CLASS*>(this);
+    board->timerEnablePwm(); // supposed to turn on
+    delayMicroseconds(time);
+    board->timerDisablePwm();
+}
+
+inline uint16_t Board::enableCarrierTimer(frequency_t frequency) {
+    CURRENT_CLASS* board = static_cast<CURRENT_CLASS*>(this);
+    uint16_t clocks = board->timerConfigPeriodic(frequency);
+    board->timerEnableIntr();
+    board->timerAcknowledgeIntr();
+    return clocks;
+}
+
+inline void Board::setCarrierTimerTop(uint16_t top) {
+    static_cast<CURRENT_CLASS*>(this)->timerSetTop(top);
+}
+
+inline void Board::disableCarrierTimer() {
+    static_cast<CURRENT_CLASS*>(this)->timerDisableIntr();
+}
+
+inline void Board::timerReset() {
+    static_cast<CURRENT_CLASS*>(this)->timerAcknowledgeIntr();
+}
+
+inline bool Board::setMicrosPerTick(unsigned long micros) {
+    if (micros < CURRENT_CLASS::minMicrosPerTick || micros > CURRENT_CLASS::maxMicrosPerTick)
+        return false;
+    microsPerTick = micros;
+    return true;
+}
+
+inline uint16_t Board::getTimerCount() {
+    return static_cast<CURRENT_CLASS*>(this)->timerCount();
+}
+
+#if HAS_FAST_PIN
+
+// The read-modify-write of the port register must not be interrupted
+// by an ISR writing to another pin of the same port.
+inline void Board::writeLow(pin_t pin) {
+    uint8_t oldSREG = SREG;
+    noInterrupts();
+    CURRENT_CLASS::pinOutputRegister(pin) &= (uint8_t) ~CURRENT_CLASS::pinBitMask(pin);
+    SREG = oldSREG;
+}
+
+inline void Board::writeHigh(pin_t pin) {
+    uint8_t oldSREG = SREG;
+    noInterrupts();
+    CURRENT_CLASS::pinOutputRegister(pin) |= CURRENT_CLASS::pinBitMask(pin);
+    SREG = oldSREG;
+}
+
+inline bool Board::readDigital(pin_t pin) {
+    return (CURRENT_CLASS::pinInputRegister(pin) & CURRENT_CLASS::pinBitMask(pin)) != 0U;
+}
+
+#else // ! HAS_FAST_PIN
+
+inline void Board::writeLow(pin_t pin) { digitalWrite(pin, LOW); };
+inline void Board::writeHigh(pin_t pin) { digitalWrite(pin, HIGH); };
+inline bool Board::readDigital(pin_t pin) { return digitalRead(pin); };
+
+#endif // ! HAS_FAST_PIN
+
 #if !HAS_FLASH_READ
 // Dummy definition for allowing compiling some stuff
 typedef void *  uint_farptr_t;
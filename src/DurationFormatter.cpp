@@ -0,0 +1,46 @@
+#include "DurationFormatter.h"
+
+DurationFormatter::DurationFormatter(Stream& stream_, bool usingSigns_)
+: stream(stream_), usingSigns(usingSigns_), count(0U), used(0U) {
+}
+
+uint8_t DurationFormatter::format(uint32_t value, char *out) {
+    char digits[10];
+    uint8_t n = 0U;
+    // Most durations fit in 16 bits, where the division is considerably cheaper on 8-bit targets.
+    while (value > 0xFFFFUL) {
+        digits[n++] = (char) ('0' + value % 10U);
+        value /= 10U;
+    }
+    uint16_t small = (uint16_t) value;
+    do {
+        digits[n++] = (char) ('0' + small % 10U);
+        small /= 10U;
+    } while (small > 0U);
+
+    for (uint8_t i = 0U; i < n; i++)
+        out[i] = digits[n - 1U - i];
+    return n;
+}
+
+void DurationFormatter::append(uint32_t duration) {
+    if (used > bufferSize - maxItemLength)
+        flush();
+    if (count > 0U)
+        buffer[used++] = ' ';
+    if (usingSigns)
+        buffer[used++] = (count & 1U) ? '-' : '+';
+    used += format(duration, buffer + used);
+    count++;
+}
+
+void DurationFormatter::flush() {
+    if (used > 0U)
+        stream.write(buffer, used);
+    used = 0U;
+}
+
+void DurationFormatter::println() {
+    flush();
+    stream.println();
+}
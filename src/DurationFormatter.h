@@ -0,0 +1,67 @@
+/*
+Copyright (C) 2020 Bengt Martensson.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see http://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include <Arduino.h>
+#include "InfraredTypes.h"
+
+/**
+ * Formats durations as text into a small buffer on the stack,
+ * and writes it to the Stream in chunks, instead of printing every number,
+ * sign, and space separately.
+ */
+class DurationFormatter {
+public:
+    /**
+     * Constructor.
+     * @param stream Stream to write to
+     * @param usingSigns if true, prefix marks with '+' and gaps with '-'
+     */
+    DurationFormatter(Stream& stream, bool usingSigns = true);
+
+    /**
+     * Appends a duration, preceded by a space if not the first one.
+     * @param duration duration in microseconds
+     */
+    void append(uint32_t duration);
+
+    /**
+     * Writes the buffered content, followed by a line break.
+     */
+    void println();
+
+    /**
+     * Writes the decimal representation of the value, without terminating '\0'.
+     * @param value value to format
+     * @param out buffer with room for at least 10 characters
+     * @return number of characters written
+     */
+    static uint8_t format(uint32_t value, char *out);
+
+private:
+    static const size_t bufferSize = 64U;
+    static const size_t maxItemLength = 12U; // space, sign, and 10 digits
+
+    Stream& stream;
+    bool usingSigns;
+    unsigned int count;
+    size_t used;
+    char buffer[bufferSize];
+
+    void flush();
+};
@@ -0,0 +1,58 @@
+/*
+Copyright (C) 2020 Bengt Martensson.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see http://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include "Board.h"
+
+#if HAS_EEPROM
+
+#include <EEPROM.h>
+
+/**
+ * Storage backend for SignalStore, using (a region of) the on-chip EEPROM.
+ * Only bytes that actually change are written, to save EEPROM cycles.
+ */
+class EepromStorage {
+public:
+    /**
+     * Constructor.
+     * @param offset first EEPROM address used
+     * @param size number of bytes used; default is the rest of the EEPROM
+     */
+    EepromStorage(size_t offset_ = 0U, size_t size_ = 0U)
+    : offset(offset_), length(size_ > 0U ? size_ : EEPROM.length() - offset_) {
+    }
+
+    uint8_t read(size_t address) const {
+        return EEPROM.read((int) (offset + address));
+    }
+
+    void update(size_t address, uint8_t value) {
+        EEPROM.update((int) (offset + address), value);
+    }
+
+    size_t size() const {
+        return length;
+    }
+
+private:
+    size_t offset;
+    size_t length;
+};
+
+#endif // HAS_EEPROM
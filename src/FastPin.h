@@ -0,0 +1,70 @@
+/*
+Copyright (C) 2020 Bengt Martensson.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include "Board.h"
+
+/**
+ * GPIO pin with the pin number known at compile time.
+ * On boards with HAS_FAST_PIN, the accesses go directly to the port registers;
+ * on the ATmega328P the port and bit are resolved by the compiler,
+ * so that writeHigh/writeLow become single sbi/cbi instructions.
+ * On the other HAS_FAST_PIN boards, the port is looked up at run time,
+ * and the write is a read-modify-write, not protected against interrupts.
+ * On other boards, it falls back to digitalWrite/digitalRead.
+ *
+ * Note that, as opposed to digitalWrite, a hardware PWM on the pin is not turned off.
+ */
+template<pin_t pin>
+class FastPin {
+public:
+    static inline void writeHigh() {
+#if HAS_FAST_PIN
+        CURRENT_CLASS::pinOutputRegister(pin) |= CURRENT_CLASS::pinBitMask(pin);
+#else
+        digitalWrite(pin, HIGH);
+#endif
+    }
+
+    static inline void writeLow() {
+#if HAS_FAST_PIN
+        CURRENT_CLASS::pinOutputRegister(pin) &= (uint8_t) ~CURRENT_CLASS::pinBitMask(pin);
+#else
+        digitalWrite(pin, LOW);
+#endif
+    }
+
+    static inline bool read() {
+#if HAS_FAST_PIN
+        return (CURRENT_CLASS::pinInputRegister(pin) & CURRENT_CLASS::pinBitMask(pin)) != 0U;
+#else
+        return digitalRead(pin);
+#endif
+    }
+
+    static inline void setPinMode(PinMode mode) {
+        Board::getInstance()->setPinMode(pin, mode);
+    }
+
+    static constexpr pin_t getPin() {
+        return pin;
+    }
+
+private:
+    FastPin();
+};
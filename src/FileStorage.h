@@ -0,0 +1,101 @@
+/*
+Copyright (C) 2020 Bengt Martensson.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see http://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#ifdef ARDUINO
+#error FileStorage is only for the host (SIL)
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Storage backend for SignalStore on the host, standing in for the EEPROM.
+ * The content is kept in a file; a new file is filled with 0xFF, like erased EEPROM.
+ * As EepromStorage, only changed bytes are written, and these writes are counted.
+ */
+class FileStorage {
+public:
+    /**
+     * Opens or creates the file.
+     * @param filename name of backing file
+     * @param size number of bytes
+     */
+    FileStorage(const char *filename, size_t size_) : file(NULL), data(new uint8_t[size_]), length(size_), writeCount(0UL) {
+        memset(data, 0xFF, length);
+        file = fopen(filename, "r+b");
+        if (file != NULL) {
+            size_t n = fread(data, 1, length, file);
+            (void) n;
+        } else {
+            file = fopen(filename, "w+b");
+            if (file != NULL)
+                fwrite(data, 1, length, file);
+        }
+        if (file != NULL)
+            fflush(file);
+    }
+
+    ~FileStorage() {
+        if (file != NULL)
+            fclose(file);
+        delete [] data;
+    }
+
+    bool isValid() const {
+        return file != NULL;
+    }
+
+    uint8_t read(size_t address) const {
+        return data[address];
+    }
+
+    void update(size_t address, uint8_t value) {
+        if (data[address] == value)
+            return;
+        data[address] = value;
+        writeCount++;
+        if (file != NULL) {
+            fseek(file, (long) address, SEEK_SET);
+            fputc(value, file);
+            fflush(file);
+        }
+    }
+
+    size_t size() const {
+        return length;
+    }
+
+    /**
+     * Returns the number of bytes actually written since construction.
+     * @return number of writes
+     */
+    unsigned long getWriteCount() const {
+        return writeCount;
+    }
+
+private:
+    FILE *file;
+    uint8_t *data;
+    size_t length;
+    unsigned long writeCount;
+
+    FileStorage(const FileStorage&);
+    FileStorage& operator=(const FileStorage&);
+};
@@ -0,0 +1,68 @@
+#include "GlitchFilter.h"
+#include "HeapStatistics.h"
+
+GlitchFilter::GlitchFilter(IrReader& source_, microseconds_t minWidth_)
+: IrReader(source_.getBufferSize()), source(source_), durations(NULL), allocated(true),
+        dataLength(0U), minWidth(minWidth_), merged(0U), totalMerged(0UL) {
+    HeapStatistics::Scope scope(HeapStatistics::receivers);
+    durations = new microseconds_t[bufferSize];
+    init();
+}
+
+GlitchFilter::GlitchFilter(IrReader& source_, microseconds_t *buffer, size_t capacity, microseconds_t minWidth_)
+: IrReader(capacity), source(source_), durations(buffer), allocated(false),
+        dataLength(0U), minWidth(minWidth_), merged(0U), totalMerged(0UL) {
+    // The buffer may not be as large as forceEven made bufferSize.
+    bufferSize = capacity;
+    init();
+}
+
+void GlitchFilter::init() {
+    beginningTimeout = source.getBeginningTimeout();
+    endingTimeout = source.getEndingTimeout();
+    markExcess = source.getMarkExcess();
+    filter();
+}
+
+GlitchFilter::~GlitchFilter() {
+    if (allocated)
+        delete [] durations;
+}
+
+size_t GlitchFilter::filter() {
+    size_t length = source.getDataLength();
+    dataLength = 0U;
+    merged = 0U;
+    for (size_t i = 0U; i < length; i++) {
+        microseconds_t duration = source.getDuration(i);
+        if (duration >= minWidth || i == length - 1U) {
+            if (dataLength == bufferSize)
+                break;
+            durations[dataLength++] = duration;
+            continue;
+        }
+
+        // Glitch; merge it and its successor into the predecessor.
+        // Parity is preserved, since the successor is of the same kind as the predecessor.
+        merged++;
+        microseconds_t next = i + 1U < length ? source.getDuration(i + 1U) : 0U;
+        i++;
+        if (dataLength == 0U)
+            continue; // leading glitch, the following space is dropped too
+        durations[dataLength - 1U] = toMicroseconds((uint32_t) durations[dataLength - 1U] + duration + next);
+    }
+    totalMerged += merged;
+    return merged;
+}
+
+void GlitchFilter::receive() {
+    source.receive();
+    filter();
+}
+
+void GlitchFilter::reset() {
+    IrReader::reset();
+    source.reset();
+    dataLength = 0U;
+    merged = 0U;
+}
@@ -0,0 +1,126 @@
+/*
+Copyright (C) 2020 Bengt Martensson.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see http://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include "IrReader.h"
+
+/**
+ * An IrReader presenting the data of another IrReader with short glitches removed,
+ * so that it can be decoded, dumped etc. like the original.
+ *
+ * A duration shorter than minWidth is taken as a glitch (e.g. from sunlight or a lamp),
+ * and merged, together with the following duration, into the preceding one;
+ * e.g. a mark interrupted by a short space becomes one mark again.
+ * A glitch mark at the very beginning is dropped together with the following space.
+ * The final gap is never considered a glitch.
+ *
+ * The filtering is done by the constructor, and has to be redone by filter()
+ * for every new capture of the source (receive() does this).
+ * For filtering already in the ISR, see IrReceiverSampler::setMedianFilter.
+ */
+class GlitchFilter : public IrReader {
+public:
+    /** Default shortest duration not considered a glitch; shorter than any duration of common protocols. */
+    static const microseconds_t defaultMinWidth = 150U;
+
+    /**
+     * Constructs a GlitchFilter with a buffer as large as the one of the source, and filters its data.
+     * @param source IrReader to be filtered
+     * @param minWidth shortest duration not considered a glitch
+     */
+    GlitchFilter(IrReader& source, microseconds_t minWidth = defaultMinWidth);
+
+    /**
+     * Like the other constructor, but using a buffer supplied by the caller; does not allocate.
+     * @param source IrReader to be filtered
+     * @param buffer buffer for the filtered durations
+     * @param capacity size of buffer; longer data is truncated
+     * @param minWidth shortest duration not considered a glitch
+     */
+    GlitchFilter(IrReader& source, microseconds_t *buffer, size_t capacity, microseconds_t minWidth = defaultMinWidth);
+
+    virtual ~GlitchFilter();
+
+    /**
+     * Filters the present data of the source.
+     * @return number of glitches removed
+     */
+    size_t filter();
+
+    /** Receives by the source, and filters the result. */
+    void receive();
+
+    void enable() {
+        source.enable();
+    }
+
+    void disable() {
+        source.disable();
+    }
+
+    void reset();
+
+    frequency_t getFrequency() const {
+        return source.getFrequency();
+    }
+
+    bool isReady() const {
+        return source.isReady();
+    }
+
+    size_t getDataLength() const final {
+        return dataLength;
+    }
+
+    microseconds_t getDuration(unsigned int index) const final {
+        return durations[index];
+    }
+
+    microseconds_t getMinWidth() const {
+        return minWidth;
+    }
+
+    void setMinWidth(microseconds_t minWidth_) {
+        minWidth = minWidth_;
+    }
+
+    /** @return number of glitches removed by the last filter() */
+    size_t getMerged() const {
+        return merged;
+    }
+
+    /** @return number of glitches removed since construction, or resetTotalMerged() */
+    unsigned long getTotalMerged() const {
+        return totalMerged;
+    }
+
+    void resetTotalMerged() {
+        totalMerged = 0UL;
+    }
+
+private:
+    IrReader& source;
+    microseconds_t *durations;
+    bool allocated;
+    size_t dataLength;
+    microseconds_t minWidth;
+    size_t merged;
+    unsigned long totalMerged;
+
+    void init();
+};
@@ -0,0 +1,188 @@
+#include "HeapStatistics.h"
+
+#ifdef HEAP_STATISTICS
+
+#include <stdlib.h>
+#ifndef ARDUINO
+#include <new>
+#endif
+
+// Every block is preceded by its size and subsystem, keeping the alignment of malloc.
+union BlockHeader {
+    struct {
+        size_t size;
+        uint8_t subsystem;
+    } block;
+    long double alignment;
+};
+
+#ifdef __AVR__
+static const uint8_t stackPaint = 0xC5U;
+extern uint8_t __heap_start;
+extern char *__brkval;
+#endif
+
+HeapStatistics::Subsystem HeapStatistics::currentSubsystem = HeapStatistics::application;
+HeapStatistics::Counters HeapStatistics::counters[noSubsystems];
+HeapStatistics::Counters HeapStatistics::total;
+uintptr_t HeapStatistics::stackTop = 0U;
+uintptr_t HeapStatistics::stackLowest = 0U;
+
+void *HeapStatistics::allocate(size_t size) {
+    BlockHeader *header = static_cast<BlockHeader*>(malloc(sizeof(BlockHeader) + size));
+    if (header == NULL) {
+#ifdef ARDUINO
+        return NULL;
+#else
+        throw std::bad_alloc();
+#endif
+    }
+    header->block.size = size;
+    header->block.subsystem = (uint8_t) currentSubsystem;
+    Counters& c = counters[currentSubsystem];
+    c.allocations++;
+    c.current += size;
+    if (c.current > c.peak)
+        c.peak = c.current;
+    total.allocations++;
+    total.current += size;
+    if (total.current > total.peak)
+        total.peak = total.current;
+    sampleStack();
+    return header + 1;
+}
+
+void HeapStatistics::release(void *pointer) {
+    if (pointer == NULL)
+        return;
+    BlockHeader *header = static_cast<BlockHeader*>(pointer) - 1;
+    Counters& c = counters[header->block.subsystem];
+    c.frees++;
+    c.current -= header->block.size;
+    total.frees++;
+    total.current -= header->block.size;
+    free(header);
+}
+
+void HeapStatistics::reset() {
+    for (unsigned int i = 0U; i < noSubsystems; i++) {
+        counters[i].allocations = 0UL;
+        counters[i].frees = 0UL;
+        counters[i].peak = counters[i].current;
+    }
+    total.allocations = 0UL;
+    total.frees = 0UL;
+    total.peak = total.current;
+}
+
+void HeapStatistics::paintStack() {
+    uint8_t marker;
+    stackTop = (uintptr_t) &marker;
+    stackLowest = stackTop;
+#ifdef __AVR__
+    // Leave some room for this function, and for interrupts during painting.
+    uint8_t *p = __brkval != NULL ? (uint8_t*) __brkval : &__heap_start;
+    while ((uintptr_t) p + 32U < stackTop)
+        *p++ = stackPaint;
+    stackTop = RAMEND;
+#endif
+}
+
+void HeapStatistics::sampleStack() {
+    uint8_t marker;
+    if (stackTop != 0U && (uintptr_t) &marker < stackLowest)
+        stackLowest = (uintptr_t) &marker;
+}
+
+size_t HeapStatistics::getStackHighWater() {
+    if (stackTop == 0U)
+        return 0U;
+#ifdef __AVR__
+    // Bytes grabbed by the heap in the meantime look like used stack, so start above the heap.
+    const uint8_t *p = __brkval != NULL ? (const uint8_t*) __brkval : &__heap_start;
+    while ((uintptr_t) p < stackLowest && *p == stackPaint)
+        p++;
+    stackLowest = (uintptr_t) p;
+#endif
+    return (size_t) (stackTop - stackLowest);
+}
+
+void HeapStatistics::printName(Stream& stream, Subsystem subsystem) {
+    switch (subsystem) {
+        case application:
+            stream.print(F("application"));
+            break;
+        case sequences:
+            stream.print(F("sequences"));
+            break;
+        case renderers:
+            stream.print(F("renderers"));
+            break;
+        case pronto:
+            stream.print(F("pronto"));
+            break;
+        case receivers:
+            stream.print(F("receivers"));
+            break;
+        case senders:
+            stream.print(F("senders"));
+            break;
+        case storage:
+            stream.print(F("storage"));
+            break;
+        default:
+            break;
+    }
+}
+
+void HeapStatistics::printCounters(Stream& stream, const Counters& c) {
+    stream.print(F(": "));
+    stream.print((uint32_t) c.allocations);
+    stream.print(F(" allocations, "));
+    stream.print((uint32_t) c.frees);
+    stream.print(F(" frees, "));
+    stream.print((uint32_t) c.current);
+    stream.print(F(" bytes, "));
+    stream.print((uint32_t) c.peak);
+    stream.println(F(" bytes peak"));
+}
+
+void HeapStatistics::dump(Stream& stream) {
+    for (unsigned int i = 0U; i < noSubsystems; i++) {
+        if (counters[i].peak == 0U && counters[i].allocations == 0UL)
+            continue;
+        printName(stream, (Subsystem) i);
+        printCounters(stream, counters[i]);
+    }
+    stream.print(F("total"));
+    printCounters(stream, total);
+    stream.print(F("stack: "));
+    stream.print((uint32_t) getStackHighWater());
+    stream.println(F(" bytes peak"));
+}
+
+void *operator new(size_t size) {
+    return HeapStatistics::allocate(size);
+}
+
+void *operator new[](size_t size) {
+    return HeapStatistics::allocate(size);
+}
+
+void operator delete(void *pointer) noexcept {
+    HeapStatistics::release(pointer);
+}
+
+void operator delete[](void *pointer) noexcept {
+    HeapStatistics::release(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    HeapStatistics::release(pointer);
+}
+
+void operator delete[](void *pointer, size_t) noexcept {
+    HeapStatistics::release(pointer);
+}
+
+#endif // HEAP_STATISTICS
@@ -0,0 +1,137 @@
+/*
+Copyright (C) 2020 Bengt Martensson.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see http://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include "InfraredTypes.h"
+
+// Define to account the heap usage of the library per subsystem, see HeapStatistics.
+// This replaces the global operator new and delete, and costs a few bytes per allocation.
+// The Makefile for the host defines it on the command line.
+//#define HEAP_STATISTICS
+
+/**
+ * Accounting of heap usage, per subsystem, and of the stack high-water mark.
+ *
+ * Allocations are charged to the subsystem of the innermost HeapStatistics::Scope
+ * in effect, otherwise to application. Frees are charged to the subsystem
+ * that made the allocation, so it does not matter where an object is deleted.
+ *
+ * Only available if HEAP_STATISTICS is defined; otherwise, Scope is empty,
+ * and the rest of the class does not exist.
+ * Not to be used from interrupt routines, which are not supposed to allocate anyway.
+ */
+class HeapStatistics {
+public:
+    enum Subsystem {
+        application, ///< everything outside of the library, e.g. the sketch
+        sequences,   ///< IrSequence, IrSignal, IrReader, RepeatFinder
+        renderers,   ///< Nec1Renderer, Rc5Renderer, IrpRenderer
+        pronto,      ///< Pronto
+        receivers,   ///< receivers and their capture buffers
+        senders,     ///< senders
+        storage,     ///< SignalStore
+        noSubsystems
+    };
+
+#ifdef HEAP_STATISTICS
+    struct Counters {
+        unsigned long allocations;
+        unsigned long frees;
+        size_t current; ///< bytes currently allocated
+        size_t peak;    ///< largest value of current
+    };
+
+    /** Charges the allocations during its lifetime to a subsystem. */
+    class Scope {
+    public:
+        Scope(Subsystem subsystem) : previous(currentSubsystem) {
+            currentSubsystem = subsystem;
+        }
+
+        ~Scope() {
+            currentSubsystem = previous;
+        }
+
+    private:
+        Subsystem previous;
+    };
+
+    /** Called by operator new. */
+    static void *allocate(size_t size);
+
+    /** Called by operator delete. */
+    static void release(void *pointer);
+
+    static const Counters& getCounters(Subsystem subsystem) {
+        return counters[subsystem];
+    }
+
+    /** @return Counters of all subsystems together; its peak is the peak of the sum. */
+    static const Counters& getTotal() {
+        return total;
+    }
+
+    /**
+     * Clears the allocation and free counts, and lets the peaks start from the current usage.
+     * The stack high-water mark is not affected; use paintStack() for that.
+     */
+    static void reset();
+
+    /**
+     * Starts measuring the stack. On AVR, the free memory between heap and stack
+     * is filled with a pattern, and getStackHighWater() finds the deepest overwritten byte;
+     * this should be called early in setup().
+     * Elsewhere, the current stack position is taken as top of the stack,
+     * and the stack is sampled at every allocation (and sampleStack()) only.
+     */
+    static void paintStack();
+
+    /** Records the current stack position, for boards where the stack is not painted. */
+    static void sampleStack();
+
+    /** @return largest stack usage in bytes since paintStack(), 0 if not called */
+    static size_t getStackHighWater();
+
+    /**
+     * Prints one line per subsystem used, then the total, and the stack high-water mark.
+     * @param stream where to print
+     */
+    static void dump(Stream& stream);
+
+private:
+    HeapStatistics();
+
+    static Subsystem currentSubsystem;
+    static Counters counters[noSubsystems];
+    static Counters total;
+    static uintptr_t stackTop;
+    static uintptr_t stackLowest;
+
+    static void printName(Stream& stream, Subsystem subsystem);
+    static void printCounters(Stream& stream, const Counters& c);
+
+#else // ! HEAP_STATISTICS
+
+    class Scope {
+    public:
+        Scope(Subsystem) {
+        }
+    };
+
+#endif // ! HEAP_STATISTICS
+};
@@ -7,16 +7,38 @@
  * @brief This file defines some general data types that are used in the library.
  */
 
+// Define to make microseconds_t 32 bits, so that durations longer than 65535
+// microseconds, like the 96ms repeat gap of NEC1, are kept instead of being clamped.
+// Doubles the size of IrSequences and of the buffer of IrReceiverPoll;
+// IrReceiverSampler and IrWidget keep their capture buffers in 16 bit timer ticks.
+//#define LONG_DURATIONS
+
 /**
- * Type for durations in micro seconds. Change to a longer type if needed,
- * AND you know what you are doing.
- * But DO NOT use a system dependent type like int!
+ * Type for durations in micro seconds; 32 bits if LONG_DURATIONS is defined, otherwise 16 bits.
+ * DO NOT use a system dependent type like int!
  */
+#ifdef LONG_DURATIONS
+typedef uint32_t microseconds_t;
+/** Largest microseconds_t number possible */
+#define MICROSECONDS_T_MAX 4294967295UL
+#else
 typedef uint16_t microseconds_t;
-//typedef uint32_t microseconds_t;
 /** Largest microseconds_t number possible */
 #define MICROSECONDS_T_MAX 65535
-//#define MICROSECONDS_T_MAX 4294967295
+#endif
+
+/**
+ * Converts a duration to microseconds_t, clamping it to MICROSECONDS_T_MAX.
+ * @param duration duration in microseconds
+ * @return duration, or MICROSECONDS_T_MAX if it does not fit
+ */
+inline microseconds_t toMicroseconds(uint32_t duration) {
+#ifdef LONG_DURATIONS
+    return duration;
+#else
+    return duration <= MICROSECONDS_T_MAX ? (microseconds_t) duration : MICROSECONDS_T_MAX;
+#endif
+}
 
 /**
  * Type for durations in milli seconds.
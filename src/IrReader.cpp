@@ -16,20 +16,20 @@ this program. If not, see http://www.gnu.org/licenses/.
 */
 
 #include "IrReader.h"
+#include "HeapStatistics.h"
+#include "DurationFormatter.h"
 
 // Cannot use IrSequence.dump directly!
 void IrReader::dump(Stream &stream) const {
     size_t count = getDataLength();
-    for (unsigned int i = 0U; i < count; i++) {
-        if (i > 0U)
-            stream.print(" ");
-        stream.print((i & 1U) ? '-' : '+');
-        stream.print(getDuration(i), DEC);
-    }
-    stream.println();
+    DurationFormatter formatter(stream);
+    for (unsigned int i = 0U; i < count; i++)
+        formatter.append(getDuration(i));
+    formatter.println();
 }
 
 IrSequence *IrReader::toIrSequence() const {
+    HeapStatistics::Scope scope(HeapStatistics::sequences);
     microseconds_t *durations = new microseconds_t[getDataLength()];
     for (unsigned int i = 0; i < getDataLength(); i++)
         durations[i] = getDuration(i);
@@ -46,7 +46,7 @@ protected:
     /** True if last receive ended with a timeout */
     bool timeouted;
 
-    static unsigned int forceEven(unsigned int x) {
+    static constexpr unsigned int forceEven(unsigned int x) {
         return (x & 1) ? x + 1 : x;
     }
 
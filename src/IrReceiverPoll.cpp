@@ -1,5 +1,6 @@
 #include <Arduino.h>
 #include "IrReceiverPoll.h"
+#include "HeapStatistics.h"
 
 IrReceiverPoll::IrReceiverPoll(size_t captureLength,
         pin_t pin_,
@@ -7,14 +8,31 @@ IrReceiverPoll::IrReceiverPoll(size_t captureLength,
         microseconds_t markExcess,
         milliseconds_t beginningTimeout,
         milliseconds_t endingTimeout) : IrReceiver(captureLength, pin_, pullup, markExcess) {
+    HeapStatistics::Scope scope(HeapStatistics::receivers);
     setBeginningTimeout(beginningTimeout);
     setEndingTimeout(endingTimeout);
     durationData = new microseconds_t[bufferSize];
+    allocated = true;
+    dataLength = 0;
+}
+
+IrReceiverPoll::IrReceiverPoll(microseconds_t *buffer,
+        size_t captureLength,
+        pin_t pin_,
+        bool pullup,
+        microseconds_t markExcess,
+        milliseconds_t beginningTimeout,
+        milliseconds_t endingTimeout) : IrReceiver(captureLength, pin_, pullup, markExcess) {
+    setBeginningTimeout(beginningTimeout);
+    setEndingTimeout(endingTimeout);
+    durationData = buffer;
+    allocated = false;
     dataLength = 0;
 }
 
 IrReceiverPoll::~IrReceiverPoll() {
-    delete [] durationData;
+    if (allocated)
+        delete [] durationData;
     // let the pin stay as input
 }
 
@@ -69,5 +87,5 @@ void IrReceiverPoll::collectData() {
 }
 
 void IrReceiverPoll::recordDuration(unsigned long t) {
-    durationData[dataLength++] = t <= MICROSECONDS_T_MAX ? (microseconds_t) t : MICROSECONDS_T_MAX;
+    durationData[dataLength++] = toMicroseconds((uint32_t) t);
 }
@@ -7,6 +7,7 @@
  * An implementation of IrReceiver using polling of the input pin.
  * It uses no timer or other hardware resources, and should thus run
  * on all platforms.
+ * For a version with the capture buffer in static storage, see IrReceiverPollStatic.
  */
 class IrReceiverPoll : public IrReceiver {
 private:
@@ -16,6 +17,9 @@ private:
     /** Number of valid entries in durationData */
     size_t dataLength;
 
+    /** True if durationData was allocated by the constructor. */
+    bool allocated;
+
 public:
     IrReceiverPoll(size_t captureLength = defaultCaptureLength,
             pin_t pin = defaultPin,
@@ -26,17 +30,32 @@ public:
 
     ~IrReceiverPoll();
 
+protected:
+    /**
+     * Constructor using a buffer supplied by the caller.
+     * @param buffer buffer of at least forceEven(captureLength) elements, not deleted by the destructor.
+     */
+    IrReceiverPoll(microseconds_t *buffer,
+            size_t captureLength,
+            pin_t pin,
+            bool pullup,
+            microseconds_t markExcess,
+            milliseconds_t beginningTimeout,
+            milliseconds_t endingTimeout);
+
+public:
+
     bool isReady() const {
         return timeouted || !isEmpty();
     }
 
     void reset();
 
-    size_t getDataLength() const {
+    size_t getDataLength() const final {
         return dataLength;
     }
 
-    microseconds_t getDuration(unsigned int i) const {
+    microseconds_t getDuration(unsigned int i) const final {
         return durationData[i];
     }
 
@@ -72,3 +91,23 @@ private:
 
     void recordDuration(unsigned long t);
 };
+
+/**
+ * @class IrReceiverPollStatic
+ * An IrReceiverPoll with the capture buffer as a member, with the capacity given as template parameter.
+ * The heap is not used; declared as a global, the object, including its buffer, resides in static storage.
+ */
+template<size_t captureLength = IrReader::defaultCaptureLength>
+class IrReceiverPollStatic : public IrReceiverPoll {
+private:
+    microseconds_t buffer[forceEven(captureLength)];
+
+public:
+    IrReceiverPollStatic(pin_t pin = defaultPin,
+            bool pullup = false,
+            microseconds_t markExcess = defaultMarkExcess,
+            milliseconds_t beginningTimeout = defaultBeginningTimeout,
+            milliseconds_t endingTimeout = defaultEndingTimeout)
+    : IrReceiverPoll(buffer, captureLength, pin, pullup, markExcess, beginningTimeout, endingTimeout) {
+    }
+};
@@ -1,27 +1,29 @@
 #include "IrReceiverSampler.h"
+#include "HeapStatistics.h"
 #include "Board.h"
 
 #if HAS_SAMPLING
 
-uint32_t IrReceiverSampler::millisecs2ticks(milliseconds_t ms) {
-    return (1000UL * (uint32_t) ms) / Board::microsPerTick;
-}
-
-milliseconds_t IrReceiverSampler::ticks2millisecs(uint32_t tix) {
-    return (milliseconds_t) ((tix * Board::microsPerTick)/1000UL);
+uint32_t IrReceiverSampler::millisecs2ticks(milliseconds_t ms) const {
+    return (1000UL * (uint32_t) ms) / microsPerTick;
 }
 
 IrReceiverSampler *IrReceiverSampler::instance = NULL;
+bool IrReceiverSampler::staticInstanceUsed = false;
 
 IrReceiverSampler::IrReceiverSampler(size_t captureLength,
         pin_t pin_,
         bool pullup,
         microseconds_t markExcess,
         milliseconds_t beginningTimeout,
-        milliseconds_t endingTimeout) : IrReceiver(captureLength, pin_, pullup, markExcess) {
+        milliseconds_t endingTimeout,
+        ticks_t *buffer) : IrReceiver(captureLength, pin_, pullup, markExcess),
+        microsPerTick(Board::getMicrosPerTick()), medianFilter(false), samples(0U), suppressedGlitches(0UL) {
+    HeapStatistics::Scope scope(HeapStatistics::receivers);
     setBeginningTimeout(beginningTimeout);
     setEndingTimeout(endingTimeout);
-    durationData = new microseconds_t[bufferSize];
+    allocated = buffer == NULL;
+    durationData = allocated ? new ticks_t[bufferSize] : buffer;
     dataLength = 0;
     timer = 0;
     receiverState = STATE_IDLE;
@@ -35,17 +37,20 @@ IrReceiverSampler *IrReceiverSampler::newIrReceiverSampler(size_t captureLength,
         milliseconds_t endingTimeout) {
     if (instance != NULL || pin == invalidPin)
         return NULL;
+    HeapStatistics::Scope scope(HeapStatistics::receivers);
     instance = new IrReceiverSampler(captureLength, pin, pullup, markExcess, beginningTimeout, endingTimeout);
     return instance;
 }
 
 void IrReceiverSampler::deleteInstance() {
-    delete instance;
+    if (instance != NULL && instance->allocated)
+        delete instance;
     instance = NULL;
 }
 
 IrReceiverSampler::~IrReceiverSampler() {
-    delete [] durationData;
+    if (allocated)
+        delete [] durationData;
 }
 
 /*
@@ -60,7 +65,15 @@ void IrReceiverSampler::reset() {
 void IrReceiverSampler::enable() {
     // Initialize state machine variables
     reset();
+    // The sampling period may have been changed since the last time.
+    microsPerTick = Board::getMicrosPerTick();
+    endingTimeoutInTicks = millisecs2ticks(endingTimeout);
+    beginningTimeoutInTicks = millisecs2ticks(beginningTimeout);
+    samples = 0U;
     noInterrupts();
+#ifdef ISR_STATISTICS
+    closeIsrSpan();
+#endif
     Board::getInstance()->enableSampler(getPin());
     interrupts();
 }
@@ -70,79 +83,185 @@ void IrReceiverSampler::disable() {
 }
 
 void IrReceiverSampler::setEndingTimeout(milliseconds_t timeOut) {
+    IrReceiver::setEndingTimeout(timeOut);
     endingTimeoutInTicks = millisecs2ticks(timeOut);
 }
 
 void IrReceiverSampler::setBeginningTimeout(milliseconds_t timeOut) {
+    IrReceiver::setBeginningTimeout(timeOut);
     beginningTimeoutInTicks = millisecs2ticks(timeOut);
 }
 
-milliseconds_t IrReceiverSampler::getEndingTimeout() const {
-    return ticks2millisecs(endingTimeoutInTicks);
-}
-
-milliseconds_t IrReceiverSampler::getBeginningTimeout() const {
-    return ticks2millisecs(beginningTimeoutInTicks);
-}
-
-#ifdef ISR
-/** Interrupt routine. It collects data into the data buffer. */
-ISR(TIMER_INTR_NAME) {
-    Board::debugPinHigh();
-    Board::getInstance()->timerReset();
-    IrReceiverSampler *recv = IrReceiverSampler::getInstance();
-    IrReceiver::irdata_t irdata = recv->readIr();
-    recv->timer++; // One more 50us tick
-    if (recv->dataLength >= recv->getBufferSize()) {
+void IrReceiverSampler::tick() {
+    IrReceiver::irdata_t irdata = readIr();
+    if (medianFilter)
+        irdata = median(irdata);
+    timer++; // One more 50us tick
+    if (dataLength >= getBufferSize()) {
         // Buffer full
-        recv->receiverState = IrReceiverSampler::STATE_STOP;
+        receiverState = STATE_STOP;
     }
-    switch (recv->receiverState) {
-        case IrReceiverSampler::STATE_IDLE: // Looking for first mark
+    switch (receiverState) {
+        case STATE_IDLE: // Looking for first mark
             if (irdata == IrReceiver::IR_MARK) {
                 // Got the first mark, record duration and start recording transmission
-                recv->dataLength = 0;
-                recv->timer = 0;
-                recv->receiverState = IrReceiverSampler::STATE_MARK;
+                dataLength = 0;
+                timer = 0;
+                receiverState = STATE_MARK;
             } else {
-                if (recv->timer >= recv->beginningTimeoutInTicks) {
-                    recv->durationData[recv->dataLength] = recv->timer;
-                    recv->timer = 0;
-                    recv->receiverState = IrReceiverSampler::STATE_STOP;
+                if (timer >= beginningTimeoutInTicks) {
+                    durationData[dataLength] = toTicks(timer);
+                    timer = 0;
+                    receiverState = STATE_STOP;
                 }
             }
             break;
-        case IrReceiverSampler::STATE_MARK:
+        case STATE_MARK:
             if (irdata == IrReceiver::IR_SPACE) {
                 // MARK ended, record time
-                recv->durationData[recv->dataLength++] = recv->timer;
-                recv->timer = 0;
-                recv->receiverState = IrReceiverSampler::STATE_SPACE;
+                durationData[dataLength++] = toTicks(timer);
+                timer = 0;
+                receiverState = STATE_SPACE;
             }
             break;
-        case IrReceiverSampler::STATE_SPACE:
+        case STATE_SPACE:
             if (irdata == IrReceiver::IR_MARK) {
                 // SPACE just ended, record it
-                recv->durationData[recv->dataLength++] = recv->timer;
-                recv->timer = 0;
-                recv->receiverState = IrReceiverSampler::STATE_MARK;
+                durationData[dataLength++] = toTicks(timer);
+                timer = 0;
+                receiverState = STATE_MARK;
             } else {
                 // still silence, is it over?
-                if (recv->timer > recv->endingTimeoutInTicks) {
+                if (timer > endingTimeoutInTicks) {
                     // big SPACE, indicates gap between codes
-                    recv->durationData[recv->dataLength++] = recv->timer;
-//                    recv->timer = 0;
-                    recv->receiverState = IrReceiverSampler::STATE_STOP;
+                    durationData[dataLength++] = toTicks(timer);
+//                    timer = 0;
+                    receiverState = STATE_STOP;
                 }
             }
             break;
-        case IrReceiverSampler::STATE_STOP:
+        case STATE_STOP:
             break;
         default:
             // should not happen
             break;
     }
+}
+
+#ifdef ISR_STATISTICS
+IrReceiverSampler::IsrStatistics IrReceiverSampler::isrStatistics;
+IrReceiverSampler::IsrCounters IrReceiverSampler::isrCounters;
+
+unsigned long IrReceiverSampler::spanMissedTicks(const IsrCounters& counters) {
+    if (counters.spanCalls < 2UL)
+        return 0UL;
+    unsigned long ticks = (counters.lastMicros - counters.firstMicros + counters.spanPeriod / 2UL) / counters.spanPeriod;
+    return ticks > counters.spanCalls - 1UL ? ticks - (counters.spanCalls - 1UL) : 0UL;
+}
+
+void IrReceiverSampler::closeIsrSpan() {
+    // Called with interrupts off.
+    isrStatistics.missedTicks += spanMissedTicks(isrCounters);
+    isrCounters.spanCalls = 0UL;
+}
+
+void IrReceiverSampler::getIsrStatistics(IsrStatistics& result) {
+    noInterrupts();
+    isrStatistics.totalDuration += isrCounters.totalDuration;
+    isrCounters.totalDuration = 0UL;
+    isrStatistics.totalLatency += isrCounters.totalLatency;
+    isrCounters.totalLatency = 0UL;
+    IsrCounters counters = isrCounters;
+    // Continue the span from the last call, the ticks before it are settled below.
+    if (isrCounters.spanCalls > 0UL) {
+        isrCounters.spanCalls = 1UL;
+        isrCounters.firstMicros = isrCounters.lastMicros;
+    }
+    result = isrStatistics;
+    interrupts();
+    unsigned long missed = spanMissedTicks(counters);
+    noInterrupts();
+    isrStatistics.missedTicks += missed;
+    interrupts();
+    result.calls = counters.calls;
+    result.overruns = counters.overruns;
+    result.minDuration = counters.minDuration;
+    result.maxDuration = counters.maxDuration;
+    result.maxLatency = counters.maxLatency;
+    result.missedTicks += missed;
+}
+
+void IrReceiverSampler::resetIsrStatistics() {
+    noInterrupts();
+    isrStatistics = IsrStatistics();
+    isrCounters = IsrCounters();
+    interrupts();
+}
+
+void IrReceiverSampler::recordIsr(uint16_t entryCount, uint16_t exitCount) {
+    unsigned long now = micros();
+    if (isrCounters.spanCalls == 0UL) {
+        isrCounters.spanPeriod = Board::getMicrosPerTick();
+        isrCounters.firstMicros = now;
+    }
+    isrCounters.lastMicros = now;
+    isrCounters.spanCalls++;
+
+    isrCounters.calls++;
+    if (exitCount < entryCount) {
+        // The counter wrapped, so the duration is unknown.
+        isrCounters.overruns++;
+        return;
+    }
+    uint16_t duration = exitCount - entryCount;
+    if (duration < isrCounters.minDuration || isrCounters.calls - isrCounters.overruns == 1UL)
+        isrCounters.minDuration = duration;
+    if (duration > isrCounters.maxDuration)
+        isrCounters.maxDuration = duration;
+    isrCounters.totalDuration += duration;
+    if (entryCount > isrCounters.maxLatency)
+        isrCounters.maxLatency = entryCount;
+    isrCounters.totalLatency += entryCount;
+}
+
+void IrReceiverSampler::dumpIsrStatistics(Stream& stream) {
+    IsrStatistics statistics;
+    getIsrStatistics(statistics);
+    stream.print(F("isr calls "));
+    stream.print((uint32_t) statistics.calls);
+    stream.print(F(" duration "));
+    stream.print((uint32_t) statistics.minDuration);
+    stream.print(F("/"));
+    stream.print((uint32_t) statistics.averageDuration());
+    stream.print(F("/"));
+    stream.print((uint32_t) statistics.maxDuration);
+    stream.print(F(" latency "));
+    stream.print((uint32_t) statistics.averageLatency());
+    stream.print(F("/"));
+    stream.print((uint32_t) statistics.maxLatency);
+    stream.print(F(" missed "));
+    stream.print((uint32_t) statistics.missedTicks);
+    stream.print(F(" overruns "));
+    stream.print((uint32_t) statistics.overruns);
+    stream.println();
+}
+#endif // ISR_STATISTICS
+
+#if defined(ISR) && !defined(IR_SENDER_TIMER)
+/** Interrupt routine. It collects data into the data buffer. */
+ISR(TIMER_INTR_NAME) {
+#ifdef ISR_STATISTICS
+    uint16_t entryCount = Board::getInstance()->getTimerCount();
+#endif
+    Board::debugPinHigh();
+    Board::getInstance()->timerReset();
+    IrReceiverSampler *recv = IrReceiverSampler::getInstance();
+    if (recv != NULL)
+        recv->tick();
     Board::debugPinLow();
+#ifdef ISR_STATISTICS
+    IrReceiverSampler::recordIsr(entryCount, Board::getInstance()->getTimerCount());
+#endif
 }
 #endif // ISR
 
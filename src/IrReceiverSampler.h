@@ -9,7 +9,7 @@
  * it can only be instantiated once.
  * This is enforced by the absence of public constructors:
  * it has to be instantiated by the
- * factory method newIrReceiverSampler.
+ * factory method newIrReceiverSampler, or newIrReceiverSamplerStatic.
  */
 
 // The interrupt routine must have access to some stuff here.
@@ -26,28 +26,65 @@ public:
         STATE_STOP  /**< Complete signal has been read */
     };
 
+    /**
+     * Type of the capture buffer, in ticks. Independent of microseconds_t,
+     * so that LONG_DURATIONS does not double the buffer.
+     */
+    typedef uint16_t ticks_t;
+
+    /** Largest ticks_t number possible; longer durations are clamped. */
+    static const uint32_t maxTicks = 65535UL;
+
     /** State of the state machine */
     volatile ReceiverState_t receiverState; // previously rcvstate;
 
-    // Note: use the following ones instead of beginningTimeout and endingTimeout
-    // inherited from IrReader.
+    // The timeouts in ticks, derived from beginningTimeout and endingTimeout
+    // inherited from IrReader; these are used by the ISR.
     uint32_t endingTimeoutInTicks; // previously GAP_TICKS
 
     uint32_t beginningTimeoutInTicks; // previously TIMEOUT_TICKS;
 
-    /** state timer, counts 50uS ticks. */
+    /** state timer, counts ticks (of microsPerTick microseconds). */
     volatile uint32_t timer;
 
     /** Data buffer */
-    volatile microseconds_t *durationData; // previously rawbuf;
+    volatile ticks_t *durationData; // previously rawbuf;
 
     /** Number of entries in durationData */
     volatile size_t dataLength; // previously rawlen
 
 private:
+    /** True if durationData was allocated by the constructor. */
+    bool allocated;
+
+    /** Sampling period, from Board::getMicrosPerTick() at the last enable(). */
+    unsigned long microsPerTick;
+
+    bool medianFilter;
+
+    /** The last three samples, the latest in bit 0; 1 is mark. */
+    uint8_t samples;
+
+    volatile unsigned long suppressedGlitches;
+
+    /**
+     * Median, i.e. majority, of the last three samples, including this one.
+     * Suppresses glitches of one sample, and delays every edge by one tick.
+     */
+    IrReceiver::irdata_t median(IrReceiver::irdata_t sample) {
+        samples = (uint8_t) (((samples << 1U) | (sample == IrReceiver::IR_MARK ? 1U : 0U)) & 7U);
+        if (samples == 2U || samples == 5U) // 010 or 101
+            suppressedGlitches++;
+        return (samples == 3U || samples >= 5U) ? IrReceiver::IR_MARK : IrReceiver::IR_SPACE;
+    }
+
     static IrReceiverSampler *instance;
-    static uint32_t millisecs2ticks(milliseconds_t ms);
-    static milliseconds_t ticks2millisecs(uint32_t tix);
+    static bool staticInstanceUsed;
+    uint32_t millisecs2ticks(milliseconds_t ms) const;
+
+    static ticks_t toTicks(uint32_t ticks) {
+        return ticks <= maxTicks ? (ticks_t) ticks : (ticks_t) maxTicks;
+    }
 
 protected:
     virtual ~IrReceiverSampler();
@@ -58,7 +95,8 @@ private:
             bool pullup = false,
             microseconds_t markExcess = defaultMarkExcess,
             milliseconds_t beginningTimeout = defaultBeginningTimeout,
-            milliseconds_t endingTimeout = defaultEndingTimeout);
+            milliseconds_t endingTimeout = defaultEndingTimeout,
+            ticks_t *buffer = NULL);
 
 public:
     /**
@@ -80,9 +118,39 @@ public:
             milliseconds_t beginningTimeout = defaultBeginningTimeout,
             milliseconds_t endingTimeout = defaultEndingTimeout);
 
+    /**
+     * Like newIrReceiverSampler, but both the instance and its capture buffer
+     * reside in static storage, so that no heap is used,
+     * and the RAM usage is reported by the linker.
+     * The instance is constructed at the first call; further calls return NULL.
+     *
+     * @tparam captureLength buffersize
+     * @param pin GPIO pin to use
+     * @param pullup true if the internal pullup resistor should be enabled
+     * @param markExcess markExcess to use
+     * @param beginningTimeout beginningTimeout to use
+     * @param endingTimeout endingTimeout to use
+     * @return pointer to a valid instance, or NULL.
+     */
+    template<size_t captureLength>
+    static IrReceiverSampler *newIrReceiverSamplerStatic(pin_t pin = defaultPin,
+            bool pullup = false,
+            microseconds_t markExcess = defaultMarkExcess,
+            milliseconds_t beginningTimeout = defaultBeginningTimeout,
+            milliseconds_t endingTimeout = defaultEndingTimeout) {
+        static ticks_t buffer[forceEven(captureLength)];
+        if (instance != NULL || pin == invalidPin || staticInstanceUsed)
+            return NULL;
+        staticInstanceUsed = true;
+        static IrReceiverSampler staticInstance(captureLength, pin, pullup, markExcess, beginningTimeout, endingTimeout, buffer);
+        instance = &staticInstance;
+        return instance;
+    }
+
     /**
      * Deletes the instance, thereby freeing up the resources it occupied, and
      * allowing for another instance to be created.
+     * An instance created by newIrReceiverSamplerStatic is not deleted, only released.
      */
     static void deleteInstance();
 
@@ -102,22 +170,137 @@ public:
 
     void setEndingTimeout(milliseconds_t timeOut);
 
-    milliseconds_t getEndingTimeout() const;
-
     void setBeginningTimeout(milliseconds_t timeOut);
 
-    milliseconds_t getBeginningTimeout() const;
+    /** @return sampling period, in microseconds, of the present (or last) capture */
+    unsigned long getMicrosPerTick() const {
+        return microsPerTick;
+    }
 
-    size_t getDataLength() const {
+    /**
+     * Turns the median filter of the samples on or off; takes effect at the next tick,
+     * so preferably called while disabled, not to change the filtering within a capture.
+     * Filtering costs a few cycles in the ISR; for a filter after the capture, see GlitchFilter.
+     * @param on true for on
+     */
+    void setMedianFilter(bool on) {
+        medianFilter = on;
+    }
+
+    bool getMedianFilter() const {
+        return medianFilter;
+    }
+
+    /** @return number of glitches removed by the median filter since construction, or resetSuppressedGlitches() */
+    unsigned long getSuppressedGlitches() const {
+        return suppressedGlitches;
+    }
+
+    void resetSuppressedGlitches() {
+        suppressedGlitches = 0UL;
+    }
+
+    size_t getDataLength() const final {
         return dataLength;
     }
 
-    microseconds_t getDuration(unsigned int i) const {
-        uint32_t bigvalue = Board::microsPerTick * (uint32_t) durationData[i] + (i & 1 ? markExcess : -markExcess);
-        return bigvalue <=  MICROSECONDS_T_MAX ? (microseconds_t) bigvalue : MICROSECONDS_T_MAX;
+    microseconds_t getDuration(unsigned int i) const final {
+        return toMicroseconds(microsPerTick * (uint32_t) durationData[i] + (i & 1 ? markExcess : -markExcess));
     }
 
     bool isReady() const {
         return receiverState == STATE_STOP;
     }
+
+    /**
+     * Samples the input once, and runs the state machine; the body of the timer ISR.
+     * Public, so that tests on the host can call it, in place of the timer interrupt.
+     */
+    void tick();
+
+#ifdef ISR_STATISTICS
+    /**
+     * Measurements of the sampler ISR, with ISR_STATISTICS defined (see Board.h).
+     * Durations and latencies are in clocks of the sampling timer (see Board::getTimerCount),
+     * i.e. microseconds on the host; they are 0 on boards not implementing the timer count.
+     */
+    struct IsrStatistics {
+        unsigned long calls;
+        /**
+         * Ticks lost since interrupts were blocked longer than a period;
+         * estimated from micros() when the statistics are read.
+         */
+        unsigned long missedTicks;
+        /** Calls lasting until after the next tick. */
+        unsigned long overruns;
+        uint16_t minDuration;
+        uint16_t maxDuration;
+        /** Widened from the 32 bit sums of the ISR every time the statistics are read. */
+        uint64_t totalDuration;
+        /** Time from the timer event to the start of the ISR. */
+        uint16_t maxLatency;
+        uint64_t totalLatency;
+
+        /** @return number of calls with known duration and latency */
+        unsigned long measured() const {
+            return calls - overruns;
+        }
+
+        uint16_t averageDuration() const {
+            return measured() > 0UL ? (uint16_t) (totalDuration / measured()) : 0U;
+        }
+
+        uint16_t averageLatency() const {
+            return measured() > 0UL ? (uint16_t) (totalLatency / measured()) : 0U;
+        }
+    };
+
+    /**
+     * Copies the ISR statistics, consistently.
+     * Should be called at least every hour or so while sampling,
+     * before the 32 bit sums and micros() of the ISR wrap.
+     * @param result where to copy to
+     */
+    static void getIsrStatistics(IsrStatistics& result);
+
+    static void resetIsrStatistics();
+
+    /** Prints the ISR statistics on one line. */
+    static void dumpIsrStatistics(Stream& stream);
+
+    /**
+     * Called from the ISR.
+     * @param entryCount timer count at the start of the ISR
+     * @param exitCount timer count at the end of the ISR
+     */
+    static void recordIsr(uint16_t entryCount, uint16_t exitCount);
+
+private:
+    /**
+     * The part of the statistics updated by the ISR; no division and no 64 bit arithmetic there.
+     * Missed ticks are derived from the time span of the calls since the last enable(),
+     * or the last getIsrStatistics().
+     */
+    struct IsrCounters {
+        unsigned long calls;
+        unsigned long overruns;
+        uint16_t minDuration;
+        uint16_t maxDuration;
+        uint32_t totalDuration;
+        uint16_t maxLatency;
+        uint32_t totalLatency;
+        unsigned long spanCalls;
+        unsigned long spanPeriod;
+        unsigned long firstMicros;
+        unsigned long lastMicros;
+    };
+
+    static IsrStatistics isrStatistics; // widened sums, and missed ticks of closed spans
+    static IsrCounters isrCounters;
+
+    /** Adds the missed ticks of the present span to isrStatistics, and starts a new one. */
+    static void closeIsrSpan();
+
+    static unsigned long spanMissedTicks(const IsrCounters& counters);
+#endif // ISR_STATISTICS
 };
@@ -58,23 +58,5 @@ void IrSender::sendWhile(const IrSignal& irSignal, bool(*trigger)()) {
 
 void IrSender::send(const IrSequence& irSequence, frequency_t frequency, dutycycle_t dutyCycle) {
     enable(frequency, dutyCycle);
-#ifdef CONSIDER_COMPUTATIONAL_DELAYS
-    uint32_t refTime = micros();
-#endif
-    for (unsigned int i = 0U; i < irSequence.getLength(); i++) {
-#ifdef CONSIDER_COMPUTATIONAL_DELAYS
-#error dssdfsdfsdf
-        microseconds_t duration = irSequence.getDurations()[i];
-        refTime += duration;
-        int32_t delay = refTime - micros(); // TODO verify overflow
-        if (delay <= 0)
-            return;
-#else
-        microseconds_t delay = irSequence.getDurations()[i];
-#endif
-        if (i & 1)
-            sendSpace(delay);
-        else
-            sendMark(delay);
-    }
+    sendDurations<IrSender>(irSequence);
 }
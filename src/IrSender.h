@@ -47,6 +47,24 @@ protected:
     virtual void sendSpace(microseconds_t time) { Board::delayMicroseconds(time); };
     virtual void sendMark(microseconds_t time) = 0;
 
+    /**
+     * Sends the durations of the IrSequence, by calling sendMark and sendSpace of Sender.
+     * If Sender is a final class, these calls are not virtual, and can be inlined.
+     * Sender has to declare IrSender as friend if sendMark and sendSpace are private.
+     * @param irSequence
+     */
+    template<class Sender>
+    void sendDurations(const IrSequence& irSequence) {
+        Sender* sender = static_cast<Sender*>(this);
+        for (unsigned int i = 0U; i < irSequence.getLength(); i++) {
+            microseconds_t duration = irSequence.getDurations()[i];
+            if (i & 1)
+                sender->sendSpace(duration);
+            else
+                sender->sendMark(duration);
+        }
+    }
+
 public:
     virtual ~IrSender();
 
@@ -16,6 +16,7 @@ this program. If not, see http://www.gnu.org/licenses/.
 */
 
 #include "IrSenderPwm.h"
+#include "HeapStatistics.h"
 
 #ifdef HAS_HARDWARE_PWM
 #include "IrSenderPwmHard.h"
@@ -29,6 +30,7 @@ IrSenderPwm::IrSenderPwm(pin_t outputPin) : IrSender(outputPin) {
 }
 
 IrSenderPwm *IrSenderPwm::newInstance(pin_t outputPin) {
+    HeapStatistics::Scope scope(HeapStatistics::senders);
     if (instance != NULL)
         return NULL;
     instance =
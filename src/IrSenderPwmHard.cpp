@@ -16,6 +16,7 @@ this program. If not, see http://www.gnu.org/licenses/.
 */
 
 #include <Arduino.h>
+#include "HeapStatistics.h"
 #include "Board.h"
 
 #ifdef HAS_HARDWARE_PWM
@@ -31,6 +32,7 @@ IrSenderPwmHard::~IrSenderPwmHard() {
 };
 
 IrSenderPwmHard *IrSenderPwmHard::newInstance(pin_t outputPin) {
+    HeapStatistics::Scope scope(HeapStatistics::senders);
     if (instance != NULL)
         return NULL;
     instance = new IrSenderPwmHard(outputPin);
@@ -38,6 +40,7 @@ IrSenderPwmHard *IrSenderPwmHard::newInstance(pin_t outputPin) {
 }
 
 IrSenderPwmHard *IrSenderPwmHard::getInstance(bool create, pin_t outputPin) {
+    HeapStatistics::Scope scope(HeapStatistics::senders);
     if (instance == NULL && create)
         instance = new IrSenderPwmHard(outputPin);
     return instance;
@@ -51,8 +54,13 @@ void IrSenderPwmHard::disable() {
     Board::getInstance()->disablePwm();
 }
 
-void inline IrSenderPwmHard::sendMark(milliseconds_t time) {
+void inline IrSenderPwmHard::sendMark(microseconds_t time) {
     Board::getInstance()->sendPwmMark(time);
 }
 
+void IrSenderPwmHard::send(const IrSequence& irSequence, frequency_t frequency, dutycycle_t dutyCycle) {
+    enable(frequency, dutyCycle);
+    sendDurations<IrSenderPwmHard>(irSequence);
+}
+
 #endif // HAS_HARDWARE_PWM
@@ -29,12 +29,19 @@ this program. If not, see http://www.gnu.org/licenses/.
  * Sending function using timer PWM. Due to the nature of the timers, this is a Highlander,
  * ("There can only be one"), so the class is a singleton class, with private constructor,
  * a factory method that enforces the "highlander property".
+ *
+ * The class is final, so that send() can call sendMark and sendSpace
+ * without virtual calls, see IrSender::sendDurations.
  */
-class IrSenderPwmHard : public IrSenderPwm {
+class IrSenderPwmHard final : public IrSenderPwm {
+    friend class IrSender;
+
 public:
     IrSenderPwmHard(pin_t outputPin = Board::getInstance()->defaultPwmPin());
     virtual ~IrSenderPwmHard();
 
+    void send(const IrSequence& irSequence, frequency_t frequency = IrSignal::defaultFrequency, dutycycle_t dutyCycle = Board::defaultDutyCycle);
+
 private:
     static IrSenderPwmHard *instance;
     void enable(frequency_t frequency, dutycycle_t dutyCycle = Board::defaultDutyCycle);
@@ -46,28 +46,22 @@ IrSenderPwmSoft::IrSenderPwmSoft(pin_t outputPin) : IrSenderPwm(outputPin) {
 
 void IrSenderPwmSoft::enable(frequency_t hz, dutycycle_t dutyCycle) {
     writeLow();
-    periodTime = (1000000UL + hz / 2L) / hz; // = 1000000/hz + 1/2 = round(1000000.0/hz)
-    periodOnTime = periodTime * dutyCycle / 100U /*- pulseCorrection*/;
-    periodOffTime = periodTime - periodOnTime;
+    scaledPeriod = ((1000000UL << fractionBits) + hz / 2U) / hz;
+    scaledOnTime = scaledPeriod * dutyCycle / 100U;
 }
 
 void IrSenderPwmSoft::sendMark(microseconds_t time) {
-    unsigned long start = micros();
-    unsigned long stop = start + time;
-    if (stop + periodTime < start)
-        // Counter wrap-around, happens very seldomly, but CAN happen.
-        // Just give up instead of possibly damaging the hardware.
-        return;
-
-    //unsigned long nextPeriodEnding = start;
-    unsigned long now = micros();
-    while (now < stop) {
-        unsigned long then = now + periodTime;
+    uint32_t periods = numberPeriods(time);
+    uint32_t phase = 0U;
+    uint32_t deadline = micros();
+    microseconds_t onTime;
+    microseconds_t offTime;
+    while (periods-- > 0U) {
+        nextPeriod(phase, onTime, offTime);
+        deadline += onTime + offTime;
         writeHigh();
-        sleepMicros(periodOnTime);
+        sleepMicros(onTime);
         writeLow();
-        //nextPeriodEnding += periodTime;
-        sleepUntilMicros(then);
-        now = micros();
+        sleepUntilMicros(deadline);
     }
-}
\ No newline at end of file
+}
@@ -29,13 +29,57 @@ class IrSenderPwmSoft : public IrSenderPwm {
 protected:
     IrSenderPwmSoft(pin_t outputPin); // no default!
     virtual ~IrSenderPwmSoft() {}
+
+    /**
+     * Precomputes the carrier schedule. Period and on-time are kept in
+     * 1/2^fractionBits microseconds, so that the average emitted frequency
+     * is exact, not rounded to a whole number of microseconds.
+     */
     void enable(frequency_t hz, dutycycle_t dutyCycle = Board::defaultDutyCycle);
+
+    /**
+     * Sends a mark as a counted number of carrier periods.
+     * Each period starts at an absolute deadline, so that the time
+     * spent in writeHigh/writeLow does not accumulate.
+     */
     void sendMark(microseconds_t time);
-    static const unsigned int PULSE_CORRECTION = 3U;
+    /**
+     * Microseconds per carrier period that IrSenderPwmSoftFast spends outside of delayMicroseconds
+     * (the nextPeriod step, the loop, and the pin writes), taken off the off-time.
+     * On AVR estimated from the instruction count, some 45 clock cycles, not measured;
+     * 0 elsewhere, where it is below a microsecond, and on the host, whose clock only advances in delays.
+     */
+#if defined(ARDUINO) && defined(__AVR__)
+    static const unsigned int PULSE_CORRECTION = (unsigned int) ((45UL * 1000000UL + F_CPU - 1UL) / F_CPU);
+#else
+    static const unsigned int PULSE_CORRECTION = 0U;
+#endif
+    static const unsigned int fractionBits = 8U;
 
     virtual void sleepMicros(microseconds_t us) = 0;
     virtual void sleepUntilMicros(uint32_t terminateTime) = 0;
-    microseconds_t periodTime;
-    microseconds_t periodOnTime;
-    microseconds_t periodOffTime;
+
+    /**
+     * Returns the number of whole carrier periods closest to the duration.
+     */
+    uint32_t numberPeriods(microseconds_t time) const {
+        return (((uint32_t) time << fractionBits) + scaledPeriod / 2U) / scaledPeriod;
+    }
+
+    /**
+     * Computes on- and off-time of the next carrier period, Bresenham style:
+     * the fractional microseconds dropped by one period are carried in phase to the next.
+     * @param phase fractional part of the schedule, start with 0
+     * @param onTime on-time, in whole microseconds
+     * @param offTime off-time, in whole microseconds
+     */
+    void nextPeriod(uint32_t& phase, microseconds_t& onTime, microseconds_t& offTime) const {
+        onTime = (microseconds_t) ((phase + scaledOnTime) >> fractionBits);
+        phase += scaledPeriod;
+        offTime = (microseconds_t) ((phase >> fractionBits) - onTime);
+        phase &= (1U << fractionBits) - 1U;
+    }
+
+    uint32_t scaledPeriod;
+    uint32_t scaledOnTime;
 };
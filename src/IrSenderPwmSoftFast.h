@@ -0,0 +1,74 @@
+/*
+Copyright (C) 2020 Bengt Martensson.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see http://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include <Arduino.h>
+#include "IrSenderPwmSoft.h"
+#include "FastPin.h"
+
+/**
+ * @class IrSenderPwmSoftFast
+ *
+ * This sender class generates the modulation in software, like IrSenderPwmSoftDelay,
+ * but with the output pin as template parameter. The pin is toggled through FastPin,
+ * and a mark is sent as a counted number of carrier periods, timed by delayMicroseconds,
+ * without polling micros() in the inner loop. The periods follow the schedule of IrSenderPwmSoft,
+ * i.e. alternate between whole microsecond lengths to approximate the nominal frequency;
+ * the overhead of the loop is compensated only by the estimate PULSE_CORRECTION.
+ * Interrupts are blocked during the on-times, keeping the duty cycle steady,
+ * but a timer0 interrupt still stretches an off-time now and then.
+ * The timing has not been measured on hardware; at high carrier frequencies,
+ * where the overhead is a sizable part of the period, prefer a hardware PWM sender.
+ */
+template<pin_t outputPin>
+class IrSenderPwmSoftFast : public IrSenderPwmSoft {
+public:
+    IrSenderPwmSoftFast() : IrSenderPwmSoft(outputPin) {
+    }
+
+    virtual ~IrSenderPwmSoftFast() {
+    }
+
+private:
+    void sendMark(microseconds_t time) {
+        uint32_t periods = numberPeriods(time);
+        uint32_t phase = 0U;
+        microseconds_t onTime;
+        microseconds_t offTime;
+        while (periods-- > 0U) {
+            nextPeriod(phase, onTime, offTime);
+            offTime = offTime > PULSE_CORRECTION ? (microseconds_t) (offTime - PULSE_CORRECTION) : 0U;
+            noInterrupts();
+            FastPin<outputPin>::writeHigh();
+            ::delayMicroseconds(onTime);
+            FastPin<outputPin>::writeLow();
+            interrupts();
+            ::delayMicroseconds(offTime);
+        }
+    }
+
+    void sleepMicros(microseconds_t us) {
+        Board::delayMicroseconds(us);
+    }
+
+    void sleepUntilMicros(uint32_t targetTime) {
+        int32_t time = targetTime - micros();
+        if (time > 0)
+            Board::delayMicroseconds((microseconds_t) time);
+    }
+};
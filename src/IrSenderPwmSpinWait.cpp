@@ -26,11 +26,6 @@ void inline IrSenderPwmSpinWait::sleepMicros(microseconds_t us) {
 }
 
 void inline IrSenderPwmSpinWait::sleepUntilMicros(uint32_t targetTime) {
-    while (micros() < targetTime) {
-#if ! defined(ARDUINO) && ! defined(REAL_TIME)
-        // increment the simulated time, otherwise will loop forever
-        delayMicroseconds(1);
-#endif
-        yield();
-    }
+    while ((int32_t) (targetTime - micros()) > 0)
+        yield(); // on the host, this increments the simulated time
 }
@@ -0,0 +1,100 @@
+#include "IrSenderPwmTimer.h"
+
+#if HAS_CARRIER_TIMER
+
+IrSenderPwmTimer *IrSenderPwmTimer::instance = NULL;
+
+IrSenderPwmTimer::IrSenderPwmTimer(pin_t outputPin) : IrSenderPwm(outputPin),
+        counts(NULL), capacity(0U), length(0U), index(0U), remaining(0U), busy(false),
+        mark(false), onPhase(true), onTop(0U), offTop(0U) {
+    Board::getInstance()->setPinMode(outputPin, OUTPUT);
+    writeLow();
+}
+
+IrSenderPwmTimer::~IrSenderPwmTimer() {
+    wait();
+    Board::getInstance()->disableCarrierTimer();
+    writeLow();
+    HeapStatistics::Scope scope(HeapStatistics::senders);
+    delete [] counts;
+}
+
+void IrSenderPwmTimer::enable(frequency_t frequency __attribute__((unused)), dutycycle_t dutyCycle __attribute__((unused))) {
+}
+
+void IrSenderPwmTimer::wait() const {
+    while (busy)
+        yield();
+}
+
+bool IrSenderPwmTimer::start(const IrSequence& irSequence, frequency_t frequency, dutycycle_t dutyCycle) {
+    if (busy || frequency == 0U || dutyCycle <= 0 || dutyCycle >= 100)
+        return false;
+
+    size_t len = irSequence.getLength();
+    if (len > capacity) {
+        HeapStatistics::Scope scope(HeapStatistics::senders);
+        delete [] counts;
+        counts = new count_t[len];
+        capacity = len;
+    }
+    // Round the cumulative time, not the single durations, so that the errors do not add up.
+    uint64_t elapsed = 0U;
+    uint64_t periodsBefore = 0U;
+    for (size_t i = 0U; i < len; i++) {
+        elapsed += irSequence.getDurations()[i];
+        uint64_t periods = (elapsed * frequency + 500000U) / 1000000U;
+        counts[i] = (count_t) (periods - periodsBefore);
+        periodsBefore = periods;
+    }
+
+    // The interrupt routine does nothing until busy.
+    uint16_t clocks = Board::getInstance()->enableCarrierTimer(frequency);
+    uint16_t onClocks = (uint16_t) (((uint32_t) clocks * (uint32_t) dutyCycle + 50U) / 100U);
+    if (onClocks == 0U || onClocks >= clocks) {
+        Board::getInstance()->disableCarrierTimer();
+        return false;
+    }
+    onTop = (uint16_t) (onClocks - 1U);
+    offTop = (uint16_t) (clocks - onClocks - 1U);
+    length = len;
+    index = 0U;
+    remaining = 0U;
+    onPhase = true;
+    writeLow();
+    busy = true;
+    return true;
+}
+
+void IrSenderPwmTimer::finish() {
+    Board::getInstance()->disableCarrierTimer();
+    busy = false;
+}
+
+void IrSenderPwmTimer::send(const IrSequence& irSequence, frequency_t frequency, dutycycle_t dutyCycle) {
+    wait();
+    start(irSequence, frequency, dutyCycle);
+    wait();
+}
+
+// Only for the IrSender interface; send() does not use these.
+void IrSenderPwmTimer::sendMark(microseconds_t time) {
+    IrSequence irSequence(&time, 1U, false);
+    send(irSequence);
+}
+
+void IrSenderPwmTimer::sendSpace(microseconds_t time) {
+    wait();
+    Board::delayMicroseconds(time);
+}
+
+#if defined(ISR) && defined(IR_SENDER_TIMER)
+ISR(TIMER_INTR_NAME) {
+    Board::getInstance()->timerReset();
+    IrSenderPwmTimer *sender = IrSenderPwmTimer::getInstance();
+    if (sender != NULL)
+        sender->tick();
+}
+#endif
+
+#endif // HAS_CARRIER_TIMER
@@ -0,0 +1,165 @@
+/*
+Copyright (C) 2020 Bengt Martensson.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see http://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include <Arduino.h>
+#include "IrSenderPwm.h"
+#include "FastPin.h"
+#include "HeapStatistics.h"
+
+/**
+ * Sender generating the carrier in software, from a timer interrupt, for boards or pins without
+ * hardware PWM. The timer interrupts twice every carrier period: at the start of the on-time,
+ * and at the start of the off-time, whose lengths follow the duty cycle.
+ * The lengths of marks and spaces are counted in carrier periods, computed in start()
+ * from the cumulative time of the sequence, so that there is no drift;
+ * the interrupt routine only counts down, and toggles the pin through FastPin.
+ * Thus the timing is independent of what the main program does,
+ * which however only gets the time between the interrupts.
+ * The length of the interrupt routine limits the carrier frequency; it has not been measured on hardware.
+ *
+ * The timer is the one otherwise used by IrReceiverSampler, so IR_SENDER_TIMER
+ * has to be defined in Board.h, which disables the interrupt routine of IrReceiverSampler.
+ * Only boards with HAS_CARRIER_TIMER support it.
+ * Since there is only one timer, this is a singleton; the instance is created as
+ * IrSenderPwmTimerFast<pin>, with the output pin as template parameter.
+ */
+class IrSenderPwmTimer : public IrSenderPwm {
+    friend class IrSender;
+
+public:
+    /**
+     * Returns a pointer to the instance, or NULL if not initialized.
+     */
+    static IrSenderPwmTimer *getInstance() {
+        return instance;
+    }
+
+    static void deleteInstance() {
+        delete instance;
+        instance = NULL;
+    }
+
+    virtual ~IrSenderPwmTimer();
+
+    /**
+     * Sends the IrSequence, and waits for it to finish.
+     * @param irSequence
+     * @param frequency
+     * @param dutyCycle percent, 1 to 99
+     */
+    void send(const IrSequence& irSequence, frequency_t frequency = IrSignal::defaultFrequency, dutycycle_t dutyCycle = Board::defaultDutyCycle);
+
+    /**
+     * Starts sending the IrSequence and returns immediately.
+     * The IrSequence is copied, as a number of carrier periods per duration.
+     * @param irSequence
+     * @param frequency
+     * @param dutyCycle percent, 1 to 99
+     * @return false if already busy, or if the timer can not generate the frequency and duty cycle given
+     */
+    bool start(const IrSequence& irSequence, frequency_t frequency = IrSignal::defaultFrequency, dutycycle_t dutyCycle = Board::defaultDutyCycle);
+
+    bool isBusy() const {
+        return busy;
+    }
+
+    /**
+     * Body of the interrupt routine. Not to be called by the user, except for testing on the host.
+     */
+    virtual void tick() = 0;
+
+protected:
+#ifdef LONG_DURATIONS
+    typedef uint32_t count_t;
+#else
+    typedef uint16_t count_t;
+#endif
+
+    static IrSenderPwmTimer *instance;
+
+    count_t *counts; // carrier periods of every duration
+    size_t capacity;
+    volatile size_t length;
+    volatile size_t index;
+    volatile count_t remaining; // periods left of the current duration
+    volatile bool busy;
+    bool mark;
+    bool onPhase; // the next interrupt starts a period
+    uint16_t onTop;
+    uint16_t offTop;
+
+    IrSenderPwmTimer(pin_t outputPin);
+
+    /** Called from tick() when the sequence is done. */
+    void finish();
+
+private:
+    void enable(frequency_t frequency, dutycycle_t dutyCycle = Board::defaultDutyCycle);
+    void sendMark(microseconds_t time);
+    void sendSpace(microseconds_t time);
+    void wait() const;
+};
+
+/**
+ * The IrSenderPwmTimer for the output pin given as template parameter.
+ */
+template<pin_t outputPin>
+class IrSenderPwmTimerFast final : public IrSenderPwmTimer {
+public:
+    /**
+     *  Creates a new instance (if not existing) and returns it.
+     *  Returns NULL if an instance already exists.
+     */
+    static IrSenderPwmTimer *newInstance() {
+        HeapStatistics::Scope scope(HeapStatistics::senders);
+        if (instance != NULL)
+            return NULL;
+        instance = new IrSenderPwmTimerFast();
+        return instance;
+    }
+
+    void tick() {
+        if (!busy)
+            return;
+        if (onPhase) {
+            while (remaining == 0U) {
+                if (index == length) {
+                    FastPin<outputPin>::writeLow();
+                    finish();
+                    return;
+                }
+                remaining = counts[index];
+                mark = (index & 1U) == 0U;
+                index++;
+            }
+            Board::getInstance()->setCarrierTimerTop(onTop);
+            if (mark)
+                FastPin<outputPin>::writeHigh();
+            remaining--;
+        } else {
+            Board::getInstance()->setCarrierTimerTop(offTop);
+            FastPin<outputPin>::writeLow();
+        }
+        onPhase = !onPhase;
+    }
+
+private:
+    IrSenderPwmTimerFast() : IrSenderPwmTimer(outputPin) {
+    }
+};
@@ -1,5 +1,7 @@
 #include "IrSequence.h"
+#include "HeapStatistics.h"
 #include "Board.h"
+#include "DurationFormatter.h"
 #include <string.h>
 
 IrSequence::IrSequence() : durations(NULL), length(0U), toBeFreed(false) {
@@ -23,25 +25,23 @@ IrSequence::~IrSequence() {
 const IrSequence IrSequence::emptyInstance;
 
 IrSequence *IrSequence::clone() const {
+    HeapStatistics::Scope scope(HeapStatistics::sequences);
     microseconds_t *durationsClone = new microseconds_t[length];
     memcpy(durationsClone, durations, length*sizeof(microseconds_t));
     return new IrSequence(durationsClone, length, true);
 }
 
 void IrSequence::dump(Stream& stream, bool usingSigns) const {
-    for (unsigned int i = 0U; i < length; i++) {
-        if (i > 0U)
-            stream.print(' ');
-        if (usingSigns)
-            stream.print((i & 1) ? '-' : '+');
-        stream.print(durations[i], DEC);
-    }
-    stream.println();
+    DurationFormatter formatter(stream, usingSigns);
+    for (unsigned int i = 0U; i < length; i++)
+        formatter.append(durations[i]);
+    formatter.println();
 }
 
 // If ! HAS_FLASH_READ, allow compiling, but let linking bail out, if using it.
 #if HAS_FLASH_READ
 IrSequence* IrSequence::readFlash(const microseconds_t *flashData, size_t length) {
+    HeapStatistics::Scope scope(HeapStatistics::sequences);
     microseconds_t* data = new microseconds_t[length];
     memcpy_PF(data, (uint_farptr_t) flashData, sizeof(microseconds_t) * length);
     return new IrSequence(data, length, true);
@@ -6,19 +6,20 @@
 /**
  * This class packs an IrSequence into a dummy, immutable IrReader.
  * It is basically intended for debugging and such.
+ * It does not take ownership of the durations of the IrSequence.
  */
 class IrSequenceReader : public IrReader {
 private:
     IrSequence irSequence;
 
 public:
-    IrSequenceReader() : irSequence() {
+    IrSequenceReader() : IrReader(0U),irSequence() {
     };
 
-    IrSequenceReader(const IrSequenceReader& orig) : IrReader(),irSequence(orig.irSequence) {
+    IrSequenceReader(const IrSequenceReader& orig) : IrReader(orig.irSequence.getLength()),irSequence(orig.irSequence, false) {
     };
 
-    IrSequenceReader(const IrSequence& irSequence_) : IrReader(),irSequence(irSequence_) {
+    IrSequenceReader(const IrSequence& irSequence_) : IrReader(irSequence_.getLength()),irSequence(irSequence_, false) {
     };
 
     virtual ~IrSequenceReader() {
@@ -35,11 +36,11 @@ public:
         return true;
     };
 
-    size_t getDataLength() const {
+    size_t getDataLength() const final {
         return irSequence.getLength();
     };
 
-    microseconds_t getDuration(unsigned int index) const {
+    microseconds_t getDuration(unsigned int index) const final {
         return irSequence.getDurations()[index];
     };
 };
@@ -1,5 +1,6 @@
 #include "IrSignal.h"
 #include "IrSender.h"
+#include "HeapStatistics.h"
 
 IrSignal::IrSignal(const IrSequence& intro_, const IrSequence& repeat_, const IrSequence& ending_,
         frequency_t frequency_, dutycycle_t dutyCycle_, bool toBeFreed)
@@ -54,6 +55,7 @@ IrSignal* IrSignal::readFlash(const microseconds_t *intro, size_t lengthIntro,
         const microseconds_t *ending, size_t lengthEnding,
         frequency_t frequency_,
         dutycycle_t dutyCycle_) {
+    HeapStatistics::Scope scope(HeapStatistics::sequences);
     return new IrSignal(*IrSequence::readFlash(intro, lengthIntro),
             *IrSequence::readFlash(repeat, lengthRepeat),
             *IrSequence::readFlash(ending, lengthEnding),
@@ -64,6 +66,7 @@ IrSignal* IrSignal::readFlash(const microseconds_t *intro, size_t lengthIntro,
         const microseconds_t *repeat, size_t lengthRepeat,
         frequency_t frequency_,
         dutycycle_t dutyCycle_) {
+    HeapStatistics::Scope scope(HeapStatistics::sequences);
     return new IrSignal(*IrSequence::readFlash(intro, lengthIntro),
             *IrSequence::readFlash(repeat, lengthRepeat),
              frequency_, dutyCycle_);
@@ -71,6 +74,7 @@ IrSignal* IrSignal::readFlash(const microseconds_t *intro, size_t lengthIntro,
 #endif
 
 IrSignal *IrSignal::clone() const {
+    HeapStatistics::Scope scope(HeapStatistics::sequences);
     return new IrSignal(*intro.clone(), *repeat.clone(), *ending.clone(), frequency, dutyCycle);
 }
 
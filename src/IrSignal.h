@@ -11,6 +11,8 @@ class IrSignal {
 public:
     static const frequency_t defaultFrequency = 38000U;
     static const frequency_t invalidFrequency = (frequency_t) -1;
+    /** Highest modulation frequency accepted from the outside, like a command line or a BinaryFrame. */
+    static const frequency_t maxFrequency = 500000U;
     static const dutycycle_t noDutyCycle = -1;
 private:
     static const dutycycle_t defaultDutyCycle = noDutyCycle;
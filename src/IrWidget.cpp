@@ -1,4 +1,5 @@
 #include "IrSignal.h"
+#include "HeapStatistics.h"
 #include "Board.h" // for HAS_INPUT_CAPTURE
 
 #if HAS_INPUT_CAPTURE
@@ -36,9 +37,12 @@ IrWidget::IrWidget(size_t captureLength,
         bool pullup,
         int16_t markExcess,
         milliseconds_t beginningTimeout,
-        milliseconds_t endingTimeout) : IrReader(captureLength) {
+        milliseconds_t endingTimeout,
+        uint16_t *buffer) : IrReader(captureLength) {
+    HeapStatistics::Scope scope(HeapStatistics::receivers);
     setup(pullup);
-    captureData = new microseconds_t[bufferSize];
+    allocated = buffer == NULL;
+    captureData = allocated ? new uint16_t[bufferSize] : buffer;
     setMarkExcess(markExcess);
     setBeginningTimeout(beginningTimeout);
     //endingTimeout = _BV(RANGE_EXTENSION_BITS) - 1;
@@ -50,7 +54,8 @@ IrWidget::IrWidget(size_t captureLength,
 }
 
 IrWidget::~IrWidget() {
-    delete[] captureData;
+    if (allocated)
+        delete[] captureData;
 }
 
 void IrWidget::setEndingTimeout(milliseconds_t timeOut) {
@@ -52,7 +52,8 @@ protected:
             bool pullup = false,
             int16_t markExcess = defaultMarkExcess,
             milliseconds_t beginningTimeout = defaultBeginningTimeout,
-            milliseconds_t endingTimeout = defaultEndingTimeout);
+            milliseconds_t endingTimeout = defaultEndingTimeout,
+            uint16_t *buffer = NULL);
     virtual ~IrWidget();
 
 public:
@@ -71,7 +72,7 @@ public:
         capture();
     }
 
-    size_t getDataLength() const { // was: getCaptureCount()
+    size_t getDataLength() const final { // was: getCaptureCount()
         return captureCount;
     }
 
@@ -83,10 +84,9 @@ public:
         captureCount = 0;
     }
 
-    microseconds_t inline getDuration(unsigned int i) const {
-        uint32_t result32 = timerValueToNanoSeconds(unpackTimeVal(captureData[i])) / 1000
-                            + (i & 1 ? markExcess : -markExcess);
-        return result32 <= MICROSECONDS_T_MAX ? (microseconds_t) result32 : MICROSECONDS_T_MAX;
+    microseconds_t inline getDuration(unsigned int i) const final {
+        return toMicroseconds(timerValueToNanoSeconds(unpackTimeVal(captureData[i])) / 1000
+                            + (i & 1 ? markExcess : -markExcess));
     }
 
     /**
@@ -196,6 +196,7 @@ protected:
 #endif
     }
     uint16_t *captureData; //[bufSize]; // the buffer where the catured data is stored
+    bool allocated; // true if captureData was allocated by the constructor
     uint16_t captureCount; // number of values stored in captureData
     static const uint8_t sampleSize = 2;
 
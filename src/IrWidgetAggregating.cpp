@@ -4,6 +4,7 @@
 // This is a slight reorganization of the original code, by Bengt Martensson.
 
 #include "IrWidgetAggregating.h"
+#include "HeapStatistics.h"
 
 #if HAS_INPUT_CAPTURE
 
@@ -13,11 +14,13 @@ IrWidgetAggregating::IrWidgetAggregating(size_t captureLength,
         bool pullup,
         int16_t markExcess,
         milliseconds_t beginningTimeout,
-        milliseconds_t endingTimeout)
-: IrWidget(captureLength, pullup, markExcess, beginningTimeout, endingTimeout) {
+        milliseconds_t endingTimeout,
+        uint16_t *buffer)
+: IrWidget(captureLength, pullup, markExcess, beginningTimeout, endingTimeout, buffer) {
 }
 
 IrWidgetAggregating *IrWidgetAggregating::instance = NULL;
+bool IrWidgetAggregating::staticInstanceUsed = false;
 
 IrWidgetAggregating *IrWidgetAggregating::newIrWidgetAggregating(size_t captureLength,
             bool pullup,
@@ -26,13 +29,15 @@ IrWidgetAggregating *IrWidgetAggregating::newIrWidgetAggregating(size_t captureL
             milliseconds_t endingTimeout) {
     if (instance != NULL)
         return NULL;
+    HeapStatistics::Scope scope(HeapStatistics::receivers);
     instance = new IrWidgetAggregating(captureLength, pullup, markExcess,
             beginningTimeout, endingTimeout);
     return instance;
 }
 
 void IrWidgetAggregating::deleteInstance() {
-    delete instance;
+    if (instance != NULL && instance->allocated)
+        delete instance;
     instance = NULL;
 }
 
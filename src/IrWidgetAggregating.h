@@ -15,6 +15,7 @@
 class IrWidgetAggregating : public IrWidget {
 private:
     static IrWidgetAggregating *instance;
+    static bool staticInstanceUsed;
     IrWidgetAggregating() {
     }
 
@@ -32,12 +33,34 @@ public:
             milliseconds_t beginningTimeout = defaultBeginningTimeout,
             milliseconds_t endingTimeout = defaultEndingTimeout);
 
+    /**
+     * Like newIrWidgetAggregating, but both the instance and its capture buffer
+     * reside in static storage, so that no heap is used.
+     * The instance is constructed at the first call; further calls return NULL.
+     * deleteInstance() releases, but does not delete, it.
+     */
+    template<size_t captureLength>
+    static IrWidgetAggregating *newIrWidgetAggregatingStatic(bool pullup = false,
+            int16_t markExcess = defaultMarkExcess,
+            milliseconds_t beginningTimeout = defaultBeginningTimeout,
+            milliseconds_t endingTimeout = defaultEndingTimeout) {
+        static uint16_t buffer[forceEven(captureLength)];
+        if (instance != NULL || staticInstanceUsed)
+            return NULL;
+        staticInstanceUsed = true;
+        static IrWidgetAggregating staticInstance(captureLength, pullup, markExcess,
+                beginningTimeout, endingTimeout, buffer);
+        instance = &staticInstance;
+        return instance;
+    }
+
 protected:
     IrWidgetAggregating(size_t captureLength = defaultCaptureLength,
             bool pullup = false,
             int16_t markExcess = defaultMarkExcess,
             milliseconds_t beginningTimeout = defaultBeginningTimeout,
-            milliseconds_t endingTimeout = defaultEndingTimeout);
+            milliseconds_t endingTimeout = defaultEndingTimeout,
+            uint16_t *buffer = NULL);
 
 private:
     inline uint16_t packTimeVal/*Normal*/(uint32_t val) const {
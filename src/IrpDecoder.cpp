@@ -0,0 +1,184 @@
+#include "IrpDecoder.h"
+#include <string.h>
+#include <stdio.h>
+
+IrpDecoder::Parser::Parser(const IrReader& irReader_, const IrpProtocol& protocol_)
+: irReader(irReader_), protocol(protocol_), index(0U), remaining(irReader_.getDuration(0U)), started(false) {
+}
+
+bool IrpDecoder::Parser::consumeDuration(int units) {
+    bool isFlash = units > 0;
+    if (index >= irReader.getDataLength() || ((index & 1U) == 0U) != isFlash)
+        return false;
+
+    uint32_t expected = (uint32_t) (isFlash ? units : -units) * protocol.unit;
+    uint32_t tolerance = expected / 4U + protocol.unit / 8U;
+    if (remaining + tolerance >= expected && remaining <= expected + tolerance) {
+        // Duration completely consumed
+        index++;
+        remaining = index < irReader.getDataLength() ? irReader.getDuration(index) : 0U;
+        return true;
+    }
+
+    // Partial consumption: biphase halves merged with the next one, or the ending gap
+    if (remaining > expected + tolerance
+            && ((protocol.flags & IrpProtocol::biphase)
+            || (!isFlash && remaining - expected >= (uint32_t) minEndingUnits * protocol.unit))) {
+        remaining -= expected;
+        return true;
+    }
+
+    return false;
+}
+
+bool IrpDecoder::Parser::consume(int units) {
+    if (units == 0)
+        return true;
+    if (!started) {
+        if (units < 0)
+            return true; // A signal does not start with a gap.
+        started = true;
+    }
+    return consumeDuration(units);
+}
+
+bool IrpDecoder::Parser::consumeBit(unsigned int bit, bool doubleWidth) {
+    int factor = doubleWidth ? 2 : 1;
+    const int8_t *spec = bit ? protocol.one : protocol.zero;
+    return consume(factor * spec[0]) && consume(factor * spec[1]);
+}
+
+bool IrpDecoder::Parser::parseBit(unsigned int& bit, bool doubleWidth) {
+    unsigned int savedIndex = index;
+    uint32_t savedRemaining = remaining;
+    bool savedStarted = started;
+    if (consumeBit(0U, doubleWidth)) {
+        bit = 0U;
+        return true;
+    }
+    index = savedIndex;
+    remaining = savedRemaining;
+    started = savedStarted;
+    bit = 1U;
+    return consumeBit(1U, doubleWidth);
+}
+
+bool IrpDecoder::Parser::atEnding() const {
+    return (index & 1U) == 1U && index < irReader.getDataLength()
+            && remaining >= (uint32_t) minEndingUnits * protocol.unit;
+}
+
+void IrpDecoder::init() {
+    for (uint8_t i = 0U; i < IrpProtocol::noParameters; i++)
+        parameters[i] = invalid;
+    ditto = false;
+    name[0] = '\0';
+    decode[0] = '\0';
+}
+
+IrpDecoder::IrpDecoder(const IrReader& irReader) : IrDecoder() {
+    init();
+    for (uint8_t i = 0U; i < IrpProtocol::noProtocols; i++)
+        if (tryProtocol(irReader, IrpProtocol::getProtocol((IrpProtocol::Index) i)))
+            return;
+}
+
+IrpDecoder::IrpDecoder(const IrReader& irReader, const IrpProtocol *protocol) : IrDecoder() {
+    init();
+    tryProtocol(irReader, protocol);
+}
+
+bool IrpDecoder::tryDecode(const IrReader& irReader, Stream& stream) {
+    IrpDecoder decoder(irReader);
+    return decoder.printDecode(stream);
+}
+
+bool IrpDecoder::tryProtocol(const IrReader& irReader, const IrpProtocol *protocolPtr) {
+    if (irReader.getDataLength() < 2U)
+        return false;
+    IrpProtocol protocol;
+    IrpProtocol::read(protocolPtr, protocol);
+    bool success = decodeFrame(irReader, protocol)
+            || (protocol.repeat == IrpProtocol::repeatDitto && decodeDitto(irReader, protocol));
+    if (!success) {
+        init();
+        return false;
+    }
+    strcpy(name, protocol.name);
+    formatDecode(protocol);
+    setValid(true);
+    return true;
+}
+
+bool IrpDecoder::decodeFrame(const IrReader& irReader, const IrpProtocol& protocol) {
+    Parser parser(irReader, protocol);
+    if (!parser.consume(protocol.leader[0]) || !parser.consume(protocol.leader[1]))
+        return false;
+
+    unsigned int values[IrpProtocol::noParameters] = { 0U, 0U, 0U, 0U };
+    unsigned int assigned[IrpProtocol::noParameters] = { 0U, 0U, 0U, 0U };
+    for (uint8_t i = 0U; i < protocol.noFields; i++) {
+        const IrpField& field = protocol.fields[i];
+        bool doubleWidth = field.flags & IrpField::doubleWidth;
+        unsigned int value = 0U;
+        for (uint8_t j = 0U; j < field.width; j++) {
+            uint8_t bitNumber = (protocol.flags & IrpProtocol::msbFirst) ? field.width - 1U - j : j;
+            unsigned int bit;
+            if (field.parameter == IrpProtocol::constant) {
+                // Only the expected bit is tried, resolving the ambiguity of an initial biphase bit.
+                bit = (field.shift >> bitNumber) & 1U;
+                if (!parser.consumeBit(bit, doubleWidth))
+                    return false;
+            } else if (!parser.parseBit(bit, doubleWidth))
+                return false;
+            value |= bit << bitNumber;
+        }
+        if (field.parameter == IrpProtocol::constant)
+            continue;
+        unsigned int mask = (1U << field.width) - 1U;
+        if (field.flags & IrpField::complement)
+            value = ~value & mask;
+        unsigned int shiftedMask = mask << field.shift;
+        unsigned int shiftedValue = value << field.shift;
+        // Parameter bits occurring more than once, like F and ~F, must agree
+        unsigned int& known = assigned[field.parameter];
+        if ((values[field.parameter] & known & shiftedMask) != (shiftedValue & known))
+            return false;
+        values[field.parameter] |= shiftedValue;
+        known |= shiftedMask;
+    }
+
+    if (!parser.consume(protocol.trailer) || !parser.atEnding())
+        return false;
+
+    for (uint8_t i = 0U; i < IrpProtocol::noParameters; i++)
+        parameters[i] = protocol.hasParameter(i) ? (int) values[i] : invalid;
+    return true;
+}
+
+bool IrpDecoder::decodeDitto(const IrReader& irReader, const IrpProtocol& protocol) {
+    Parser parser(irReader, protocol);
+    if (!parser.consume(protocol.dittoLeader[0])
+            || !parser.consume(protocol.dittoLeader[1])
+            || !parser.consume(protocol.trailer)
+            || !parser.atEnding())
+        return false;
+    ditto = true;
+    return true;
+}
+
+void IrpDecoder::formatDecode(const IrpProtocol& protocol) {
+    strcpy(decode, protocol.name);
+    if (ditto) {
+        strcat(decode, " ditto");
+        return;
+    }
+    char junk[7];
+    for (uint8_t i = 0U; i < IrpProtocol::noParameters; i++) {
+        if (parameters[i] == invalid
+                || (i == IrpProtocol::S && parameters[i] == protocol.defaultS((unsigned int) parameters[IrpProtocol::D])))
+            continue;
+        sprintf(junk, " %d", parameters[i]);
+        strcat(decode, junk);
+    }
+}
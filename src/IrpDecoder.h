@@ -0,0 +1,121 @@
+#pragma once
+
+#include "IrDecoder.h"
+#include "IrReader.h"
+#include "IrpProtocol.h"
+
+/**
+ * A decoder class that decodes signals by interpreting an IrpProtocol.
+ * Either a particular protocol is tried, or all the built-in protocols in IrpProtocol::protocols.
+ * Only the first frame of the signal is considered.
+ */
+class IrpDecoder : public IrDecoder {
+public:
+    /**
+     * Constructs an IrpDecoder from an IrReader, trying all built-in protocols.
+     * @param irReader IrReader with data, i.e. with isReady() true.
+     */
+    IrpDecoder(const IrReader& irReader);
+
+    /**
+     * Constructs an IrpDecoder from an IrReader, trying only the protocol given.
+     * @param irReader IrReader with data, i.e. with isReady() true.
+     * @param protocol pointer to IrpProtocol in PROGMEM
+     */
+    IrpDecoder(const IrReader& irReader, const IrpProtocol *protocol);
+
+    virtual ~IrpDecoder() {
+    }
+
+    /**
+     * Convenience function; constructs an IrpDecoder and calls its printDecode.
+     * @param irReader IrReader to use
+     * @param stream Stream
+     * @return success of operation
+     */
+    static bool tryDecode(const IrReader& irReader, Stream& stream);
+
+    /**
+     * Returns the D parameter, or -1 if invalid or not present.
+     * @return int
+     */
+    int getD() const {
+        return parameters[IrpProtocol::D];
+    }
+
+    /**
+     * Returns the S parameter, or -1 if invalid or not present.
+     * @return int
+     */
+    int getS() const {
+        return parameters[IrpProtocol::S];
+    }
+
+    /**
+     * Returns the F parameter, or -1 if invalid or not present.
+     * @return int
+     */
+    int getF() const {
+        return parameters[IrpProtocol::F];
+    }
+
+    /**
+     * Returns the T parameter, or -1 if invalid or not present.
+     * @return int
+     */
+    int getT() const {
+        return parameters[IrpProtocol::T];
+    }
+
+    /**
+     * Returns true if the signal is a ditto, i,e. a repeat sequence, like in NEC1.
+     * @return true if ditto
+     */
+    bool isDitto() const {
+        return ditto;
+    }
+
+    /**
+     * Returns the name of the matching protocol, or the empty string.
+     * @return name
+     */
+    const char *getName() const {
+        return name;
+    }
+
+    const char *getDecode() const {
+        return decode;
+    }
+
+private:
+    int parameters[IrpProtocol::noParameters];
+    bool ditto;
+    char name[IrpProtocol::nameLength];
+    char decode[IrpProtocol::nameLength + 24];
+
+    /** Consumes the durations of an IrReader, in units of the protocol. */
+    class Parser {
+    public:
+        Parser(const IrReader& irReader, const IrpProtocol& protocol);
+        bool consume(int units);
+        bool consumeBit(unsigned int bit, bool doubleWidth);
+        bool parseBit(unsigned int& bit, bool doubleWidth);
+        bool atEnding() const;
+
+    private:
+        const IrReader& irReader;
+        const IrpProtocol& protocol;
+        unsigned int index;
+        uint32_t remaining;
+        bool started;
+        bool consumeDuration(int units);
+    };
+
+    static const uint8_t minEndingUnits = 6U;
+
+    void init();
+    bool tryProtocol(const IrReader& irReader, const IrpProtocol *protocol);
+    bool decodeFrame(const IrReader& irReader, const IrpProtocol& protocol);
+    bool decodeDitto(const IrReader& irReader, const IrpProtocol& protocol);
+    void formatDecode(const IrpProtocol& protocol);
+};
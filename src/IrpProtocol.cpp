@@ -0,0 +1,54 @@
+#include "IrpProtocol.h"
+
+// The IRP forms below are from IrpTransmogrifier's IrpProtocols.xml.
+const IrpProtocol IrpProtocol::protocols[noProtocols] PROGMEM = {
+    // {38.4k,564}<1,-1|1,-3>(16,-8,D:8,S:8,F:8,~F:8,1,^108m,(16,-4,1,^108m)*) [S=255-D]
+    { "NEC1", 38400U, 564U, defaultSComplementD, repeatDitto,
+      { 1, -1 }, { 1, -3 }, { 16, -8 }, { 16, -4 }, 1U, 108U, 4U,
+      { { D, 8U, 0U, 0U }, { S, 8U, 0U, 0U }, { F, 8U, 0U, 0U }, { F, 8U, 0U, IrpField::complement } } },
+    // {38.4k,564}<1,-1|1,-3>(16,-8,D:8,S:8,F:8,~F:8,1,^108m)* [S=255-D]
+    { "NEC2", 38400U, 564U, defaultSComplementD, repeatFrame,
+      { 1, -1 }, { 1, -3 }, { 16, -8 }, { 0, 0 }, 1U, 108U, 4U,
+      { { D, 8U, 0U, 0U }, { S, 8U, 0U, 0U }, { F, 8U, 0U, 0U }, { F, 8U, 0U, IrpField::complement } } },
+    // {38k,550}<1,-1|1,-3>(8,-8,D:8,S:8,F:8,~F:8,1,^108m)* [S=D]
+    { "Samsung32", 38000U, 550U, defaultSEqualD, repeatFrame,
+      { 1, -1 }, { 1, -3 }, { 8, -8 }, { 0, 0 }, 1U, 108U, 4U,
+      { { D, 8U, 0U, 0U }, { S, 8U, 0U, 0U }, { F, 8U, 0U, 0U }, { F, 8U, 0U, IrpField::complement } } },
+    // {38k,525}<1,-1|1,-3>(16,-8,(D:8,F:8,1,^59m)*)
+    { "JVC", 38000U, 525U, 0U, repeatFrameWithoutLeader,
+      { 1, -1 }, { 1, -3 }, { 16, -8 }, { 0, 0 }, 1U, 59U, 2U,
+      { { D, 8U, 0U, 0U }, { F, 8U, 0U, 0U } } },
+    // {40k,600}<1,-1|2,-1>(4,-1,F:7,D:5,^45m)*
+    { "Sony12", 40000U, 600U, 0U, repeatFrame,
+      { 1, -1 }, { 2, -1 }, { 4, -1 }, { 0, 0 }, 0U, 45U, 2U,
+      { { F, 7U, 0U, 0U }, { D, 5U, 0U, 0U } } },
+    // {40k,600}<1,-1|2,-1>(4,-1,F:7,D:8,^45m)*
+    { "Sony15", 40000U, 600U, 0U, repeatFrame,
+      { 1, -1 }, { 2, -1 }, { 4, -1 }, { 0, 0 }, 0U, 45U, 2U,
+      { { F, 7U, 0U, 0U }, { D, 8U, 0U, 0U } } },
+    // {40k,600}<1,-1|2,-1>(4,-1,F:7,D:5,S:8,^45m)*
+    { "Sony20", 40000U, 600U, 0U, repeatFrame,
+      { 1, -1 }, { 2, -1 }, { 4, -1 }, { 0, 0 }, 0U, 45U, 3U,
+      { { F, 7U, 0U, 0U }, { D, 5U, 0U, 0U }, { S, 8U, 0U, 0U } } },
+    // {36k,msb,889}<1,-1|-1,1>(1:1,~F:1:6,T:1,D:5,F:6,^114m)*
+    { "RC5", 36000U, 889U, msbFirst | biphase, repeatFrame,
+      { 1, -1 }, { -1, 1 }, { 0, 0 }, { 0, 0 }, 0U, 114U, 5U,
+      { { constant, 1U, 1U, 0U }, { F, 1U, 6U, IrpField::complement }, { T, 1U, 0U, 0U }, { D, 5U, 0U, 0U }, { F, 6U, 0U, 0U } } },
+    // {36k,msb,444}<-1,1|1,-1>(6,-2,1:1,0:3,<-2,2|2,-2>(T:1),D:8,F:8,^107m)*
+    { "RC6", 36000U, 444U, msbFirst | biphase, repeatFrame,
+      { -1, 1 }, { 1, -1 }, { 6, -2 }, { 0, 0 }, 0U, 107U, 5U,
+      { { constant, 1U, 1U, 0U }, { constant, 3U, 0U, 0U }, { T, 1U, 0U, IrpField::doubleWidth }, { D, 8U, 0U, 0U }, { F, 8U, 0U, 0U } } },
+};
+
+bool IrpProtocol::hasParameter(uint8_t parameter) const {
+    for (uint8_t i = 0U; i < noFields; i++)
+        if (fields[i].parameter == parameter)
+            return true;
+    return false;
+}
+
+int IrpProtocol::defaultS(unsigned int D) const {
+    return (flags & defaultSComplementD) ? (int) (255U - D)
+            : (flags & defaultSEqualD) ? (int) D
+            : -1;
+}
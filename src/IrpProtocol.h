@@ -0,0 +1,130 @@
+#pragma once
+
+#include <Arduino.h>
+#include "InfraredTypes.h"
+
+/**
+ * A field of an IrpProtocol frame, like D:8, ~F:8, or F:1:6 in IRP notation.
+ */
+struct IrpField {
+    /** Parameter, or IrpProtocol::constant. */
+    uint8_t parameter;
+    /** Number of bits. */
+    uint8_t width;
+    /** Shift of the parameter, or the value of a constant. */
+    uint8_t shift;
+    /** Or-ed combination of complement and doubleWidth. */
+    uint8_t flags;
+
+    /** The parameter bits are complemented, like ~F:8. */
+    static const uint8_t complement = 1U;
+    /** The bits are coded with twice the durations of the bit spec, like the RC6 toggle. */
+    static const uint8_t doubleWidth = 2U;
+};
+
+/**
+ * Description of an IR protocol, as data. It represents a subset of the IRP notation,
+ * covering pulse distance/pulse width protocols (NEC, JVC, Sony,...) and biphase protocols
+ * (RC5, RC6), with one or two parameters in the frame.
+ * Durations are given in time units; positive for flashes, negative for gaps.
+ *
+ * The tables are intended to be put in PROGMEM, see IrpProtocol::protocols.
+ * They are interpreted by IrpRenderer and IrpDecoder.
+ */
+struct IrpProtocol {
+    static const uint8_t maxFields = 6U;
+    static const uint8_t nameLength = 10U;
+
+    // Parameters
+    static const uint8_t D = 0U;
+    static const uint8_t S = 1U;
+    static const uint8_t F = 2U;
+    static const uint8_t T = 3U;
+    static const uint8_t constant = 4U;
+    static const uint8_t noParameters = 4U;
+
+    // Flags
+    /** Bits are sent most significant bit first. */
+    static const uint8_t msbFirst = 1U;
+    /** Bits are coded as two halves, that are merged with the adjacent ones. */
+    static const uint8_t biphase = 2U;
+    /** S defaults to 255-D. */
+    static const uint8_t defaultSComplementD = 4U;
+    /** S defaults to D. */
+    static const uint8_t defaultSEqualD = 8U;
+
+    /** How the signal is repeated. */
+    enum Repeat {
+        /** The frame is sent as intro, the ditto as repeat, like NEC1. */
+        repeatDitto,
+        /** The frame is the repeat; the intro is empty. */
+        repeatFrame,
+        /** The frame is the intro, the frame without leader is the repeat, like JVC. */
+        repeatFrameWithoutLeader
+    };
+
+    char name[nameLength];
+    frequency_t frequency;
+    microseconds_t unit;
+    uint8_t flags;
+    uint8_t repeat;
+    int8_t zero[2];
+    int8_t one[2];
+    int8_t leader[2];
+    int8_t dittoLeader[2];
+    /** Flash after the data, 0 for none. */
+    uint8_t trailer;
+    /** Total length of the frame, in milliseconds. */
+    uint8_t extent;
+    uint8_t noFields;
+    IrpField fields[maxFields];
+
+    /** Indices of the built-in protocols. */
+    enum Index {
+        nec1,
+        nec2,
+        samsung32,
+        jvc,
+        sony12,
+        sony15,
+        sony20,
+        rc5,
+        rc6,
+        noProtocols
+    };
+
+    /** The built-in protocols, residing in PROGMEM. */
+    static const IrpProtocol protocols[noProtocols];
+
+    /**
+     * Returns a pointer to the built-in protocol given as argument, residing in PROGMEM.
+     * @param index protocol
+     * @return pointer to PROGMEM
+     */
+    static const IrpProtocol *getProtocol(Index index) {
+        return &protocols[index];
+    }
+
+    /**
+     * Copies a protocol from PROGMEM to RAM.
+     * @param protocol pointer to PROGMEM
+     * @param copy result
+     */
+    static void read(const IrpProtocol *protocol, IrpProtocol& copy) {
+        memcpy_P(&copy, protocol, sizeof(IrpProtocol));
+    }
+
+    /**
+     * Returns true if the parameter given as argument occurs in the frame.
+     * @param parameter D, S, F, or T
+     * @return true if present
+     */
+    bool hasParameter(uint8_t parameter) const;
+
+    /**
+     * Returns the default value of S, given D, or -1 if S has no default.
+     * @param D device
+     * @return default S
+     */
+    int defaultS(unsigned int D) const;
+};
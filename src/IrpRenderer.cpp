@@ -0,0 +1,119 @@
+#include "IrpRenderer.h"
+#include "HeapStatistics.h"
+
+IrpRenderer::Emitter::Emitter(microseconds_t *data_, microseconds_t unit_)
+: data(data_), unit(unit_), length(0U), lastDuration(0U), sum(0U), lastIsFlash(false) {
+}
+
+void IrpRenderer::Emitter::flush() {
+    if (lastDuration == 0U)
+        return;
+    data[length] = toMicroseconds(lastDuration);
+    length++;
+    lastDuration = 0U;
+}
+
+void IrpRenderer::Emitter::emit(int units) {
+    if (units == 0)
+        return;
+    bool isFlash = units > 0;
+    uint32_t duration = (uint32_t) (isFlash ? units : -units) * unit;
+    sum += duration;
+    if (!isFlash && length == 0U && lastDuration == 0U)
+        return; // A signal does not start with a gap.
+    if (isFlash != lastIsFlash)
+        flush();
+    lastDuration += duration;
+    lastIsFlash = isFlash;
+}
+
+void IrpRenderer::Emitter::emitBit(const IrpProtocol& protocol, unsigned int bit, bool doubleWidth) {
+    const int8_t *spec = bit ? protocol.one : protocol.zero;
+    int factor = doubleWidth ? 2 : 1;
+    emit(factor * spec[0]);
+    emit(factor * spec[1]);
+}
+
+void IrpRenderer::Emitter::emitExtent(uint8_t extent) {
+    uint32_t total = 1000UL * extent;
+    int32_t gap = (int32_t) (total - sum);
+    if (gap < (int32_t) unit)
+        gap = unit;
+    if (lastIsFlash)
+        flush();
+    lastDuration += gap;
+    lastIsFlash = false;
+    flush();
+}
+
+size_t IrpRenderer::maxLength(const IrpProtocol& protocol) {
+    size_t length = 4U; // leader, trailer, extent
+    for (uint8_t i = 0U; i < protocol.noFields; i++)
+        length += 2U * protocol.fields[i].width;
+    return length;
+}
+
+void IrpRenderer::render(const IrpProtocol& protocol, const unsigned int parameters[], microseconds_t *data, size_t& length, bool withLeader) {
+    Emitter emitter(data, protocol.unit);
+    if (withLeader) {
+        emitter.emit(protocol.leader[0]);
+        emitter.emit(protocol.leader[1]);
+    }
+    for (uint8_t i = 0U; i < protocol.noFields; i++) {
+        const IrpField& field = protocol.fields[i];
+        unsigned int value = field.parameter == IrpProtocol::constant ? field.shift : parameters[field.parameter] >> field.shift;
+        if (field.flags & IrpField::complement)
+            value = ~value;
+        for (uint8_t j = 0U; j < field.width; j++) {
+            uint8_t bitNumber = (protocol.flags & IrpProtocol::msbFirst) ? field.width - 1U - j : j;
+            emitter.emitBit(protocol, (value >> bitNumber) & 1U, field.flags & IrpField::doubleWidth);
+        }
+    }
+    emitter.emit(protocol.trailer);
+    emitter.emitExtent(protocol.extent);
+    length = emitter.getLength();
+}
+
+void IrpRenderer::renderDitto(const IrpProtocol& protocol, microseconds_t *data, size_t& length) {
+    Emitter emitter(data, protocol.unit);
+    emitter.emit(protocol.dittoLeader[0]);
+    emitter.emit(protocol.dittoLeader[1]);
+    emitter.emit(protocol.trailer);
+    emitter.emitExtent(protocol.extent);
+    length = emitter.getLength();
+}
+
+const IrSignal *IrpRenderer::newIrSignal(const IrpProtocol *protocolPtr, unsigned int D, int S, unsigned int F, unsigned int T) {
+    HeapStatistics::Scope scope(HeapStatistics::renderers);
+    IrpProtocol protocol;
+    IrpProtocol::read(protocolPtr, protocol);
+    unsigned int parameters[IrpProtocol::noParameters];
+    parameters[IrpProtocol::D] = D;
+    parameters[IrpProtocol::S] = S >= 0 ? (unsigned int) S : (unsigned int) protocol.defaultS(D);
+    parameters[IrpProtocol::F] = F;
+    parameters[IrpProtocol::T] = T;
+
+    size_t maxLen = maxLength(protocol);
+    microseconds_t *frame = new microseconds_t[maxLen];
+    size_t frameLength;
+    render(protocol, parameters, frame, frameLength, true);
+
+    switch (protocol.repeat) {
+        case IrpProtocol::repeatDitto:
+        {
+            microseconds_t *ditto = new microseconds_t[4];
+            size_t dittoLength;
+            renderDitto(protocol, ditto, dittoLength);
+            return new IrSignal(frame, frameLength, ditto, dittoLength, protocol.frequency, IrSignal::noDutyCycle, true);
+        }
+        case IrpProtocol::repeatFrameWithoutLeader:
+        {
+            microseconds_t *repeat = new microseconds_t[maxLen];
+            size_t repeatLength;
+            render(protocol, parameters, repeat, repeatLength, false);
+            return new IrSignal(frame, frameLength, repeat, repeatLength, protocol.frequency, IrSignal::noDutyCycle, true);
+        }
+        default:
+            return new IrSignal(NULL, 0U, frame, frameLength, protocol.frequency, IrSignal::noDutyCycle, true);
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "IrSignal.h"
+#include "IrpProtocol.h"
+
+/**
+ * A static class that generates IrSignal-s from an IrpProtocol and its parameters,
+ * by interpreting the protocol description.
+ */
+class IrpRenderer {
+public:
+    /**
+     * Generates an IrSignal from the protocol and parameters given as argument.
+     * Must be deleted explicitly by the user to avoid memory leaks.
+     * @param protocol pointer to IrpProtocol in PROGMEM, for example IrpProtocol::getProtocol(IrpProtocol::nec1)
+     * @param D parameter D, "device"
+     * @param S parameter S, "sub-device"; if negative, the default of the protocol is used
+     * @param F parameter F, "function"
+     * @param T parameter T, "toggle"
+     * @return IrSignal
+     */
+    static const IrSignal *newIrSignal(const IrpProtocol *protocol, unsigned int D, int S, unsigned int F, unsigned int T = 0U);
+
+    /**
+     * Generates an IrSignal from the protocol and parameters given as argument, using the default S.
+     * Must be deleted explicitly by the user to avoid memory leaks.
+     * @param protocol pointer to IrpProtocol in PROGMEM
+     * @param D parameter D, "device"
+     * @param F parameter F, "function"
+     * @return IrSignal
+     */
+    static const IrSignal *newIrSignal(const IrpProtocol *protocol, unsigned int D, unsigned int F) {
+        return newIrSignal(protocol, D, -1, F);
+    }
+
+private:
+    IrpRenderer();
+
+    /** Collects durations, merging adjacent ones of the same sign. */
+    class Emitter {
+    public:
+        Emitter(microseconds_t *data, microseconds_t unit);
+        void emit(int units);
+        void emitBit(const IrpProtocol& protocol, unsigned int bit, bool doubleWidth);
+        void emitExtent(uint8_t extent);
+        size_t getLength() const {
+            return length;
+        }
+
+    private:
+        microseconds_t *data;
+        microseconds_t unit;
+        size_t length;
+        uint32_t lastDuration;
+        uint32_t sum;
+        bool lastIsFlash;
+        void flush();
+    };
+
+    static size_t maxLength(const IrpProtocol& protocol);
+    static void render(const IrpProtocol& protocol, const unsigned int parameters[], microseconds_t *data, size_t& length, bool withLeader);
+    static void renderDitto(const IrpProtocol& protocol, microseconds_t *data, size_t& length);
+};
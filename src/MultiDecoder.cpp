@@ -1,6 +1,8 @@
 #include "MultiDecoder.h"
-#include "Nec1Decoder.h"
+#include "NecDecoder.h"
 #include "Rc5Decoder.h"
+#include "Rc6Decoder.h"
+#include "SonyDecoder.h"
 #include <string.h>
 
 MultiDecoder::MultiDecoder(const IrReader &IrReader) {
@@ -16,14 +18,25 @@ MultiDecoder::MultiDecoder(const IrReader &IrReader) {
         return;
     }
 
-    Nec1Decoder nec1decoder(IrReader);
-    if (nec1decoder.isValid()) {
-        strcpy(decode, nec1decoder.getDecode());
-        type = nec1decoder.isDitto() ? nec_ditto : nec;
+    NecDecoder necDecoder(IrReader);
+    if (necDecoder.isValid()) {
+        strcpy(decode, necDecoder.getDecode());
+        type = necDecoder.isDitto() ? nec_ditto : nec;
         setValid(true);
         return;
     }
 
+    // Only a few lengths are possible, so do not even construct the decoder otherwise.
+    if (SonyDecoder::isSonyLength(IrReader.getDataLength())) {
+        SonyDecoder sonyDecoder(IrReader);
+        if (sonyDecoder.isValid()) {
+            strcpy(decode, sonyDecoder.getDecode());
+            type = sony;
+            setValid(true);
+            return;
+        }
+    }
+
     Rc5Decoder rc5decoder(IrReader);
     if (rc5decoder.isValid()) {
         strcpy(decode, rc5decoder.getDecode());
@@ -32,6 +45,14 @@ MultiDecoder::MultiDecoder(const IrReader &IrReader) {
         return;
     }
 
+    Rc6Decoder rc6decoder(IrReader);
+    if (rc6decoder.isValid()) {
+        strcpy(decode, rc6decoder.getDecode());
+        type = rc6;
+        setValid(true);
+        return;
+    }
+
     // Giving up
     strcpy(decode, "***");
     type = undecoded;
@@ -4,7 +4,8 @@
 #include "IrDecoder.h"
 
 /**
- * A preliminary multi protocol decoder. Tries the Nec1- and the Rc5 decoders.
+ * A preliminary multi protocol decoder. Tries the Nec- (NEC1, NECx1, and their f16 variants),
+ * the Sony- (if the length fits), the Rc5, and the Rc6 decoders.
  */
 class MultiDecoder : public IrDecoder {
 public:
@@ -15,13 +16,15 @@ public:
         timeout,        ///< beginTimeout reached
         noise,          ///< nothing sensible found
         undecoded,      ///< decoding failed
-        nec,            ///< NEC1 intro
-        nec_ditto,      ///< NEC1 repeat
-        rc5             ///< RC5 signal (= repeat sequence)
+        nec,            ///< NEC family frame, see NecDecoder
+        nec_ditto,      ///< NEC1 or NECx1 repeat
+        rc5,            ///< RC5 signal (= repeat sequence)
+        rc6,            ///< RC6 mode 0 signal (= repeat sequence)
+        sony            ///< Sony12, Sony15, or Sony20 signal (= repeat sequence)
     };
 
 private:
-    char decode[17];
+    char decode[24];
     Type type;
 
 public:
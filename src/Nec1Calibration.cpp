@@ -0,0 +1,37 @@
+#include "Nec1Calibration.h"
+
+Nec1Calibration::Nec1Calibration() {
+    reset();
+}
+
+void Nec1Calibration::reset() {
+    count = 0U;
+    next = 0U;
+}
+
+int Nec1Calibration::find(int address) const {
+    for (uint8_t i = 0U; i < count; i++)
+        if (addresses[i] == address)
+            return i;
+    return -1;
+}
+
+microseconds_t Nec1Calibration::getUnit(int address) const {
+    int index = find(address);
+    return index >= 0 ? units[index] : 0U;
+}
+
+void Nec1Calibration::update(int address, microseconds_t unit) {
+    int index = find(address);
+    if (index >= 0) {
+        // Running average, the new measurement weighted by 1/4
+        units[index] = (microseconds_t) ((3UL * units[index] + unit + 2U) / 4U);
+        return;
+    }
+
+    addresses[next] = (int16_t) address;
+    units[next] = unit;
+    next = (uint8_t) ((next + 1U) % capacity);
+    if (count < capacity)
+        count++;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "InfraredTypes.h"
+
+/**
+ * Per-device timing calibration for the adaptive mode of Nec1Decoder.
+ * It keeps a running average of the measured time unit for the most recently seen
+ * NEC1 addresses (D parameters), so that frames from remotes with drifting
+ * resonators can be decoded, even when the leader is too distorted to be used
+ * for estimating the time unit.
+ * No dynamic memory is used.
+ */
+class Nec1Calibration {
+public:
+    /** Number of addresses that are remembered. */
+    static const uint8_t capacity = 4U;
+
+    Nec1Calibration();
+
+    /** Forgets all calibrations. */
+    void reset();
+
+    /**
+     * Returns the calibrated time unit for the address given as argument.
+     * @param address D parameter
+     * @return time unit in microseconds, or 0 if the address is unknown.
+     */
+    microseconds_t getUnit(int address) const;
+
+    /**
+     * Updates the running average for the address given as argument,
+     * possibly replacing the oldest entry.
+     * @param address D parameter
+     * @param unit measured time unit in microseconds
+     */
+    void update(int address, microseconds_t unit);
+
+    /**
+     * Returns the number of addresses with a valid calibration.
+     * @return number of entries
+     */
+    uint8_t size() const {
+        return count;
+    }
+
+    /**
+     * Returns the calibrated time unit of the entry with the index given as argument.
+     * @param index entry number, 0 &le; index &lt; size()
+     * @return time unit in microseconds.
+     */
+    microseconds_t getUnitAt(uint8_t index) const {
+        return units[index];
+    }
+
+private:
+    int16_t addresses[capacity];
+    microseconds_t units[capacity];
+    uint8_t count;
+    uint8_t next;
+
+    int find(int address) const;
+};
@@ -2,9 +2,19 @@
 
 #include "IrDecoder.h"
 #include "IrReader.h"
+#include "Nec1Calibration.h"
+#include <string.h>
+#include <stdio.h>
 
 /**
  * A decoder class for NEC1 signals.
+ *
+ * Constructed with a Nec1Calibration, the decoder works in adaptive mode:
+ * instead of using fixed tolerances around the nominal 564 microseconds,
+ * the time unit is estimated from the leader, and the bits are classified by
+ * their total length (flash + gap) relative to it. If this fails, the
+ * time units of the calibration are tried. On success, the time unit measured from
+ * the data bits is fed back into the calibration, for the decoded address.
  */
 class Nec1Decoder : public IrDecoder {
 private:
@@ -12,11 +22,16 @@ private:
     static const microseconds_t timebaseUpper = 650;
     static const microseconds_t timebaseLower = 450;
 
+    // Range of time units accepted in adaptive mode, approx 564 -30% .. +33%.
+    static const microseconds_t adaptiveUnitMin = 400;
+    static const microseconds_t adaptiveUnitMax = 750;
+
     // NOTE: use a signed type to be able to return the value invalid.
     int F;
     int D;
     int S;
     bool ditto;
+    microseconds_t unit;
 
     char decode[17];
 
@@ -24,9 +39,29 @@ private:
         return duration <= time * timebaseUpper
                 && duration >= time * timebaseLower;
     }
-    static int decodeParameter(const IrReader &irCapturer, unsigned int index);
+    static const char dittoLiteral[];
+
+    template<class Reader>
+    static int decodeParameter(const Reader& irReader, unsigned int index);
     static int decodeFlashGap(microseconds_t flash, microseconds_t gap);
 
+    template<class Reader>
+    void decodeDurations(const Reader& irReader);
+
+    static bool isAdaptiveUnit(uint32_t value) {
+        return value >= adaptiveUnitMin && value <= adaptiveUnitMax;
+    }
+    static bool isAround(microseconds_t duration, unsigned int units, microseconds_t timeUnit) {
+        return 2UL * duration >= (uint32_t) units * timeUnit && duration <= 2UL * units * timeUnit;
+    }
+    template<class Reader>
+    static int decodeParameterAdaptive(const Reader& irReader, unsigned int index, microseconds_t timeUnit, uint32_t& total);
+    template<class Reader>
+    bool decodeDataAdaptive(const Reader& irReader, microseconds_t estimate);
+    template<class Reader>
+    void decodeDurationsAdaptive(const Reader& irReader, Nec1Calibration& calibration);
+    void formatDecode();
+
 public:
     Nec1Decoder();
 
@@ -35,6 +70,34 @@ public:
      * @param irReader IrReader with data, i.e. with isReady() true.
      */
     Nec1Decoder(const IrReader& irReader);
+
+    /**
+     * Constructs a Nec1Decoder from a reader of known type, containing data.
+     * Since the type of the reader is known to the compiler, the calls
+     * to getDuration() are not virtual, and can be inlined.
+     * @param irReader IrReader subclass with data, i.e. with isReady() true.
+     */
+    template<class Reader>
+    Nec1Decoder(const Reader& irReader) : IrDecoder() {
+        decodeDurations(irReader);
+    }
+
+    /**
+     * Constructs a Nec1Decoder in adaptive mode.
+     * @param irReader IrReader with data, i.e. with isReady() true.
+     * @param calibration per-address calibration, used and updated.
+     */
+    Nec1Decoder(const IrReader& irReader, Nec1Calibration& calibration);
+
+    /**
+     * Constructs a Nec1Decoder in adaptive mode, from a reader of known type.
+     * @param irReader IrReader subclass with data, i.e. with isReady() true.
+     * @param calibration per-address calibration, used and updated.
+     */
+    template<class Reader>
+    Nec1Decoder(const Reader& irReader, Nec1Calibration& calibration) : IrDecoder() {
+        decodeDurationsAdaptive(irReader, calibration);
+    }
     virtual ~Nec1Decoder() {};
 
     /**
@@ -69,6 +132,15 @@ public:
         return ditto;
     };
 
+    /**
+     * Returns the time unit used for the decode in adaptive mode, otherwise 0.
+     * For a non-ditto, this is measured from the data bits.
+     * @return time unit in microseconds
+     */
+    microseconds_t getUnit() const {
+        return unit;
+    }
+
     /**
      * Convenience function; constructs an Nec1Decoder and calls its printDecode.
      * @param irReader IrReader to use
@@ -82,3 +154,170 @@ public:
     };
 
 };
+
+template<class Reader>
+int Nec1Decoder::decodeParameter(const Reader& irReader, unsigned int index) {
+    unsigned int sum = 0;
+    for (int i = 7; i >= 0; i--) {
+        int result = decodeFlashGap(irReader.getDuration(2 * i + index), irReader.getDuration(2 * i + 1 + index));
+        if (result == invalid)
+            return invalid;
+        sum = (sum << 1) + result;
+    }
+    return sum;
+}
+
+template<class Reader>
+void Nec1Decoder::decodeDurations(const Reader& irReader) {
+    unsigned int index = 0;
+    bool success;
+    F = invalid;
+    D = invalid;
+    S = invalid;
+    ditto = false;
+    unit = 0U;
+    if (irReader.getDataLength() == 4U) {
+        success = getDuration(irReader.getDuration(index++), 16U);
+        if (!success)
+            return;
+        success = getDuration(irReader.getDuration(index++), 4U);
+        if (!success)
+            return;
+        success = getDuration(irReader.getDuration(index++), 1U);
+        if (!success)
+            return;
+        success = isEnding(irReader.getDuration(index));
+        if (!success)
+            return;
+        ditto = true;
+        setValid(true);
+        //strcpy_PF(decode, (uint_farptr_t) dittoLiteral); // FIXME
+        strcpy(decode, dittoLiteral); // FIXME
+    } else if (irReader.getDataLength() == 34U * 2U) {
+        success = getDuration(irReader.getDuration(index++), 16U);
+        if (!success)
+            return;
+        success = getDuration(irReader.getDuration(index++), 8U);
+        if (!success)
+            return;
+        D = decodeParameter(irReader, index);
+        if (D == invalid)
+            return;
+        index += 16;
+        S = decodeParameter(irReader, index);
+        if (S == invalid)
+            return;
+        index += 16;
+        F = decodeParameter(irReader, index);
+        if (F == invalid)
+            return;
+        index += 16;
+        int invF = decodeParameter(irReader, index);
+        if (invF < 0)
+            return;
+        if ((F ^ invF) != 0xFF)
+            return;
+        index += 16;
+
+        success = getDuration(irReader.getDuration(index++), 1U);
+        if (!success)
+            return;
+        success = isEnding(irReader.getDuration(index));
+        if (!success)
+            return;
+        ditto = false;
+        setValid(true);
+        formatDecode();
+    }
+}
+
+template<class Reader>
+int Nec1Decoder::decodeParameterAdaptive(const Reader& irReader, unsigned int index, microseconds_t timeUnit, uint32_t& total) {
+    unsigned int sum = 0;
+    for (int i = 7; i >= 0; i--) {
+        microseconds_t flash = irReader.getDuration(2 * i + index);
+        uint32_t period = (uint32_t) flash + irReader.getDuration(2 * i + 1 + index);
+        // A bit is 2 (zero) or 4 (one) units long; the threshold is 3 units.
+        if (!isAround(flash, 1U, timeUnit) || 2UL * period < 3UL * timeUnit || period > 5UL * timeUnit)
+            return invalid;
+        sum = (sum << 1) + (period > 3UL * timeUnit ? 1U : 0U);
+        total += period;
+    }
+    return sum;
+}
+
+template<class Reader>
+bool Nec1Decoder::decodeDataAdaptive(const Reader& irReader, microseconds_t estimate) {
+    unsigned int index = 2;
+    uint32_t total = 0UL;
+    D = decodeParameterAdaptive(irReader, index, estimate, total);
+    if (D == invalid)
+        return false;
+    index += 16;
+    S = decodeParameterAdaptive(irReader, index, estimate, total);
+    if (S == invalid)
+        return false;
+    index += 16;
+    F = decodeParameterAdaptive(irReader, index, estimate, total);
+    if (F == invalid)
+        return false;
+    index += 16;
+    int invF = decodeParameterAdaptive(irReader, index, estimate, total);
+    if (invF < 0 || (F ^ invF) != 0xFF)
+        return false;
+    index += 16;
+    if (!isAround(irReader.getDuration(index), 1U, estimate) || !isEnding(irReader.getDuration(index + 1)))
+        return false;
+
+    // The 32 bits are 64 units, plus 2 for every one.
+    unsigned int ones = 8U;
+    for (unsigned int x = ((unsigned int) D << 8U) | (unsigned int) S; x != 0U; x >>= 1U)
+        ones += x & 1U;
+    unit = (microseconds_t) ((total + ones + 32U) / (64U + 2U * ones));
+    return true;
+}
+
+template<class Reader>
+void Nec1Decoder::decodeDurationsAdaptive(const Reader& irReader, Nec1Calibration& calibration) {
+    F = invalid;
+    D = invalid;
+    S = invalid;
+    ditto = false;
+    unit = 0U;
+
+    if (irReader.getDataLength() == 4U) {
+        // Ditto: 16 + 4 units leader
+        microseconds_t mark = irReader.getDuration(0);
+        uint32_t leader = (uint32_t) mark + irReader.getDuration(1);
+        uint32_t estimate = (leader + 10U) / 20U;
+        if (!isAdaptiveUnit(estimate) || 10UL * mark < 7UL * leader || 10UL * mark > 9UL * leader)
+            return;
+        if (!isAround(irReader.getDuration(2), 1U, (microseconds_t) estimate) || !isEnding(irReader.getDuration(3)))
+            return;
+        unit = (microseconds_t) estimate;
+        ditto = true;
+        setValid(true);
+        strcpy(decode, dittoLiteral);
+    } else if (irReader.getDataLength() == 34U * 2U) {
+        // Leader: 16 + 8 units
+        uint32_t leader = (uint32_t) irReader.getDuration(0) + irReader.getDuration(1);
+        uint32_t estimate = (leader + 12U) / 24U;
+        bool success = isAdaptiveUnit(estimate) && decodeDataAdaptive(irReader, (microseconds_t) estimate);
+        for (uint8_t i = 0U; !success && i < calibration.size(); i++) {
+            microseconds_t calibrated = calibration.getUnitAt(i);
+            // The leader is often distorted by the AGC of the receiver, so only check it coarsely.
+            if (leader >= 18UL * calibrated && leader <= 30UL * calibrated)
+                success = decodeDataAdaptive(irReader, calibrated);
+        }
+        if (!success) {
+            // A failed attempt may have left some parameters decoded.
+            D = invalid;
+            S = invalid;
+            F = invalid;
+            return;
+        }
+        calibration.update(D, unit);
+        setValid(true);
+        formatDecode();
+    }
+}
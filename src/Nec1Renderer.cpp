@@ -1,4 +1,5 @@
 #include "Nec1Renderer.h"
+#include "HeapStatistics.h"
 
 // NOTE: writing intro[i++] = ... produces wrong result, compiler bug?
 // (Adding a print statement immediately after, and it works :-~)
@@ -7,10 +8,9 @@
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 
 const microseconds_t Nec1Renderer::repeatData[repeatLength] = { 9024, 2256, 564, MIN(96156, MICROSECONDS_T_MAX) };
-const IrSequence Nec1Renderer::repeat(repeatData, repeatLength, false);
-static const IrSequence emptyIrSequence;
 
 const IrSignal *Nec1Renderer::newIrSignal(unsigned int D, unsigned int S, unsigned int F) {
+    HeapStatistics::Scope scope(HeapStatistics::renderers);
     microseconds_t *introData = new microseconds_t[introLength];
     unsigned int i = 0U;
     uint32_t sum = 9024U + 4512U + 564U;
@@ -22,8 +22,11 @@ const IrSignal *Nec1Renderer::newIrSignal(unsigned int D, unsigned int S, unsign
     lsbByte(introData, i, sum, 255U-F);
     introData[i] = 564U; i++;
     introData[i] = (microseconds_t) (108000U - sum); i++;
-    IrSequence *introPtr = new IrSequence(introData, introLength, true);
-    return new IrSignal(*introPtr, repeat, emptyIrSequence, frequency);
+    // The IrSignal owns all of its durations, so it gets a copy of the repeat, and no IrSequence on the heap.
+    microseconds_t *repeatCopy = new microseconds_t[repeatLength];
+    for (unsigned int j = 0U; j < repeatLength; j++)
+        repeatCopy[j] = repeatData[j];
+    return new IrSignal(introData, introLength, repeatCopy, repeatLength, NULL, 0U, frequency, IrSignal::noDutyCycle, true);
 }
 
 void Nec1Renderer::lsbByte(microseconds_t *intro, unsigned int& i, uint32_t& sum, unsigned int X) {
@@ -0,0 +1,70 @@
+#include "NecDecoder.h"
+#include <string.h>
+
+NecDecoder::NecDecoder(const IrReader& irReader) : IrDecoder() {
+    decodeDurations(irReader);
+}
+
+bool NecDecoder::tryDecode(const IrReader& irReader, Stream& stream) {
+    NecDecoder decoder(irReader);
+    return decoder.printDecode(stream);
+}
+
+const char *NecDecoder::getName(Variant variant) {
+    switch (variant) {
+        case nec1:
+        case nec1Ditto:
+            return "NEC1";
+        case nec2:
+            return "NEC2";
+        case necx1:
+        case necx1Ditto:
+            return "NECx1";
+        case necx2:
+            return "NECx2";
+        case nec1f16:
+            return "NEC1-f16";
+        case necxf16:
+            return "NECx-f16";
+        default:
+            return "";
+    }
+}
+
+int NecDecoder::decodeFlashGap(microseconds_t flash, microseconds_t gap) {
+    if (!getDuration(flash, 1U))
+        return invalid;
+
+    return getDuration(gap, 3U) ? 1
+            : getDuration(gap, 1U) ? 0
+            : invalid;
+}
+
+NecDecoder::Variant NecDecoder::withRepeat(const NecDecoder& next) const {
+    if (!isValid() || !next.isValid())
+        return none;
+    switch (variant) {
+        case nec1:
+            return next.variant == nec1Ditto ? nec1 : sameFrame(next) ? nec2 : none;
+        case necx1:
+            return next.variant == necx1Ditto && next.D == (D & 1) ? necx1 : sameFrame(next) ? necx2 : none;
+        case nec1f16:
+            return next.variant == nec1Ditto ? nec1f16 : none;
+        case necxf16:
+            return sameFrame(next) ? necxf16 : none;
+        default:
+            return none;
+    }
+}
+
+void NecDecoder::formatDecode() {
+    if (isDitto()) {
+        sprintf(decode, "%s ditto", getName(variant));
+        return;
+    }
+    int defaultS = (variant == nec1 || variant == nec1f16) ? 255 - D : D;
+    if (S == defaultS)
+        sprintf(decode, "%s %d %ld", getName(variant), D, F);
+    else
+        sprintf(decode, "%s %d %d %ld", getName(variant), D, S, F);
+}
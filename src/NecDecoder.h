@@ -0,0 +1,241 @@
+/*
+Copyright (C) 2020 Bengt Martensson.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see http://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include "IrDecoder.h"
+#include "IrReader.h"
+#include <stdio.h>
+
+/**
+ * A decoder class for the NEC family of protocols, given in IRP notation as
+ * <ul>
+ * <li>NEC1: {38.4k,564}<1,-1|1,-3>(16,-8,D:8,S:8,F:8,~F:8,1,^108m,(16,-4,1,^108m)*) [S=255-D]
+ * <li>NEC2: {38.4k,564}<1,-1|1,-3>(16,-8,D:8,S:8,F:8,~F:8,1,^108m)* [S=255-D]
+ * <li>NECx1: {38.4k,564}<1,-1|1,-3>(8,-8,D:8,S:8,F:8,~F:8,1,^108m,(8,-8,D:1,1,^108m)*) [S=D]
+ * <li>NECx2: {38.4k,564}<1,-1|1,-3>(8,-8,D:8,S:8,F:8,~F:8,1,^108m)* [S=D] (Samsung32 has the same form, with {38k,550})
+ * <li>NEC1-f16: {38.4k,564}<1,-1|1,-3>(16,-8,D:8,S:8,F:16,1,^108m,(16,-4,1,^108m)*) [S=255-D]
+ * <li>NECx-f16: {38.4k,564}<1,-1|1,-3>(8,-8,D:8,S:8,F:16,1,^108m)* [S=D]
+ * </ul>
+ * The 34 flash/gap pairs of a frame are decoded in one pass,
+ * and the variant follows from the leader, and from whether F and the last byte are complements.
+ * S is arbitrary (16 bit address), but is left out of the decode if it has its default value.
+ *
+ * A frame of NEC1 cannot be told from a frame of NEC2, nor NECx1 from NECx2;
+ * these are reported as nec1 and necx1 respectively.
+ * withRepeat() tells them apart using the next capture, i.e. the repeat.
+ *
+ * Unlike Nec1Decoder, there is no adaptive mode.
+ */
+class NecDecoder : public IrDecoder {
+public:
+    /** The possible outcomes of the decoder. */
+    enum Variant {
+        none,       ///< not decoded
+        nec1,       ///< leader 16,-8; NEC1 or NEC2 frame
+        nec1Ditto,  ///< NEC1 repeat, 16,-4,1
+        nec2,       ///< NEC1 frame repeated; only from withRepeat()
+        necx1,      ///< leader 8,-8; NECx1 or NECx2 frame
+        necx1Ditto, ///< NECx1 repeat, 8,-8,D:1,1
+        necx2,      ///< NECx1 frame repeated; only from withRepeat()
+        nec1f16,    ///< leader 16,-8, 16 bit F
+        necxf16     ///< leader 8,-8, 16 bit F
+    };
+
+    /** Number of durations of a frame. */
+    static const size_t frameLength = 68U;
+
+    /** Number of durations of an NEC1 ditto. */
+    static const size_t dittoLength = 4U;
+
+    /** Number of durations of an NECx1 ditto. */
+    static const size_t necxDittoLength = 6U;
+
+    /**
+     * Constructs a NecDecoder from an IrReader, containing data.
+     * @param irReader IrReader with data, i.e. with isReady() true.
+     */
+    NecDecoder(const IrReader& irReader);
+
+    /**
+     * Constructs a NecDecoder from a reader of known type, containing data.
+     * Since the type of the reader is known to the compiler, the calls
+     * to getDuration() are not virtual, and can be inlined.
+     * @param irReader IrReader subclass with data, i.e. with isReady() true.
+     */
+    template<class Reader>
+    NecDecoder(const Reader& irReader) : IrDecoder() {
+        decodeDurations(irReader);
+    }
+
+    virtual ~NecDecoder() {
+    }
+
+    Variant getVariant() const {
+        return variant;
+    }
+
+    /**
+     * Returns the name of a variant, like "NECx1".
+     * @param variant Variant
+     * @return name, empty for none
+     */
+    static const char *getName(Variant variant);
+
+    /**
+     * Returns true if the variant is a repeat, i.e. nec1Ditto or necx1Ditto.
+     * @param variant Variant
+     * @return true if ditto
+     */
+    static bool isDitto(Variant variant) {
+        return variant == nec1Ditto || variant == necx1Ditto;
+    }
+
+    /**
+     * Returns true if the decode is a repeat sequence.
+     * @return true if ditto
+     */
+    bool isDitto() const {
+        return isDitto(variant);
+    }
+
+    /**
+     * Returns the D parameter, or -1 if invalid.
+     * For an NECx1 ditto, this is the only bit of D sent.
+     * @return int
+     */
+    int getD() const {
+        return D;
+    }
+
+    /**
+     * Returns the S parameter, or -1 if invalid or a ditto.
+     * @return int
+     */
+    int getS() const {
+        return S;
+    }
+
+    /**
+     * Returns the F parameter, 16 bits for nec1f16 and necxf16, or -1 if invalid or a ditto.
+     * @return long, since F may not fit in an int
+     */
+    long getF() const {
+        return F;
+    }
+
+    /**
+     * Determines the protocol from this frame and the decode of the following capture:
+     * NEC1 or NECx1 if it is a matching ditto, NEC2 or NECx2 if it is the same frame.
+     * @param next decode of the following capture
+     * @return nec1, nec2, necx1, necx2, nec1f16, necxf16, or none if not a repetition of this
+     */
+    Variant withRepeat(const NecDecoder& next) const;
+
+    /**
+     * Convenience function; constructs a NecDecoder and calls its printDecode.
+     * @param irReader IrReader to use
+     * @param stream Stream
+     * @return success of operation
+     */
+    static bool tryDecode(const IrReader& irReader, Stream& stream);
+
+    const char *getDecode() const {
+        return decode;
+    }
+
+private:
+    static const microseconds_t timebaseUpper = 650U;
+    static const microseconds_t timebaseLower = 450U;
+
+    Variant variant;
+    int D;
+    int S;
+    long F;
+    char decode[24];
+
+    static bool getDuration(microseconds_t duration, unsigned int time) {
+        return duration <= time * timebaseUpper
+                && duration >= time * timebaseLower;
+    }
+
+    static int decodeFlashGap(microseconds_t flash, microseconds_t gap);
+
+    template<class Reader>
+    void decodeDurations(const Reader& irReader);
+
+    bool sameFrame(const NecDecoder& other) const {
+        return other.variant == variant && other.D == D && other.S == S && other.F == F;
+    }
+
+    void formatDecode();
+};
+
+template<class Reader>
+void NecDecoder::decodeDurations(const Reader& irReader) {
+    variant = none;
+    D = invalid;
+    S = invalid;
+    F = invalid;
+    decode[0] = '\0';
+    size_t length = irReader.getDataLength();
+    if (length != frameLength && length != dittoLength && length != necxDittoLength)
+        return;
+    bool x = getDuration(irReader.getDuration(0U), 8U);
+    if (!x && !getDuration(irReader.getDuration(0U), 16U))
+        return;
+    if (!getDuration(irReader.getDuration(length - 2U), 1U) || !isEnding(irReader.getDuration(length - 1U)))
+        return;
+
+    if (length == dittoLength) {
+        if (x || !getDuration(irReader.getDuration(1U), 4U))
+            return;
+        variant = nec1Ditto;
+    } else {
+        if (!getDuration(irReader.getDuration(1U), 8U))
+            return;
+        if (length == necxDittoLength) {
+            if (!x)
+                return;
+            int d = decodeFlashGap(irReader.getDuration(2U), irReader.getDuration(3U));
+            if (d == invalid)
+                return;
+            D = d;
+            variant = necx1Ditto;
+        } else {
+            uint32_t data = 0UL;
+            for (unsigned int i = 0U; i < 32U; i++) {
+                int bit = decodeFlashGap(irReader.getDuration(2U * i + 2U), irReader.getDuration(2U * i + 3U));
+                if (bit == invalid)
+                    return;
+                data |= (uint32_t) bit << i;
+            }
+            D = (int) (data & 0xFFUL);
+            S = (int) ((data >> 8U) & 0xFFUL);
+            F = (long) ((data >> 16U) & 0xFFUL);
+            long E = (long) (data >> 24U);
+            if ((F ^ E) == 0xFFL)
+                variant = x ? necx1 : nec1;
+            else {
+                variant = x ? necxf16 : nec1f16;
+                F |= E << 8U;
+            }
+        }
+    }
+    setValid(true);
+    formatDecode();
+}
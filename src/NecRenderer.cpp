@@ -0,0 +1,80 @@
+#include "NecRenderer.h"
+#include "HeapStatistics.h"
+
+size_t NecRenderer::renderFrame(microseconds_t *durations, NecDecoder::Variant variant, unsigned int D, unsigned int S, unsigned int F) {
+    bool f16 = variant == NecDecoder::nec1f16 || variant == NecDecoder::necxf16;
+    if (!f16 && variant != NecDecoder::nec1 && variant != NecDecoder::nec2
+            && variant != NecDecoder::necx1 && variant != NecDecoder::necx2)
+        return 0U;
+    unsigned int i = 0U;
+    uint32_t sum = 0UL;
+    durations[i] = (microseconds_t) ((hasLongLeader(variant) ? 16U : 8U) * timebase); i++;
+    durations[i] = 8U * timebase; i++;
+    sum += durations[0] + durations[1];
+    lsb(durations, i, sum, D, 8U);
+    lsb(durations, i, sum, S, 8U);
+    if (f16)
+        lsb(durations, i, sum, F, 16U);
+    else {
+        lsb(durations, i, sum, F, 8U);
+        lsb(durations, i, sum, ~F, 8U);
+    }
+    durations[i] = timebase; i++;
+    sum += timebase;
+    durations[i] = toMicroseconds(extent - sum); i++;
+    return i;
+}
+
+size_t NecRenderer::renderDitto(microseconds_t *durations, NecDecoder::Variant variant, unsigned int D) {
+    unsigned int i = 0U;
+    uint32_t sum = 0UL;
+    switch (variant) {
+        case NecDecoder::nec1:
+        case NecDecoder::nec1f16:
+            durations[i] = 16U * timebase; i++;
+            durations[i] = 4U * timebase; i++;
+            sum = 20U * timebase;
+            break;
+        case NecDecoder::necx1:
+            durations[i] = 8U * timebase; i++;
+            durations[i] = 8U * timebase; i++;
+            sum = 16U * timebase;
+            lsb(durations, i, sum, D, 1U);
+            break;
+        default:
+            return 0U;
+    }
+    durations[i] = timebase; i++;
+    sum += timebase;
+    durations[i] = toMicroseconds(extent - sum); i++;
+    return i;
+}
+
+const IrSignal *NecRenderer::newIrSignal(NecDecoder::Variant variant, unsigned int D, unsigned int S, unsigned int F) {
+    HeapStatistics::Scope scope(HeapStatistics::renderers);
+    microseconds_t *frame = new microseconds_t[frameLength];
+    size_t length = renderFrame(frame, variant, D, S, F);
+    if (length == 0U) {
+        delete [] frame;
+        return NULL;
+    }
+    microseconds_t ditto[maxDittoLength];
+    size_t dittoLength = renderDitto(ditto, variant, D);
+    if (dittoLength == 0U)
+        return new IrSignal(NULL, 0U, frame, length, NULL, 0U, frequency, IrSignal::noDutyCycle, true);
+
+    microseconds_t *repeat = new microseconds_t[dittoLength];
+    for (unsigned int i = 0U; i < dittoLength; i++)
+        repeat[i] = ditto[i];
+    return new IrSignal(frame, length, repeat, dittoLength, NULL, 0U, frequency, IrSignal::noDutyCycle, true);
+}
+
+void NecRenderer::lsb(microseconds_t *durations, unsigned int& i, uint32_t& sum, uint32_t x, unsigned int width) {
+    for (unsigned int index = 0U; index < width; index++) {
+        microseconds_t gap = (x & 1U) ? 3U * timebase : timebase;
+        durations[i] = timebase; i++;
+        durations[i] = gap; i++;
+        sum += timebase + gap;
+        x >>= 1U;
+    }
+}
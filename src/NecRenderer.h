@@ -0,0 +1,92 @@
+/*
+Copyright (C) 2020 Bengt Martensson.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see http://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include "IrSignal.h"
+#include "NecDecoder.h"
+
+/**
+ * A static class generating the NEC family of protocols, see NecDecoder for their IRP notation.
+ * With a ditto, the frame is the intro and the ditto the repeat;
+ * otherwise (NEC2, NECx2, NECx-f16) the frame is the repeat, and the intro is empty.
+ *
+ * renderFrame() and renderDitto() fill a buffer supplied by the caller, and do not allocate.
+ */
+class NecRenderer {
+public:
+    static const frequency_t frequency = 38400U;
+
+    /** Number of durations of a frame. */
+    static const size_t frameLength = NecDecoder::frameLength;
+
+    /** Largest number of durations of a ditto. */
+    static const size_t maxDittoLength = NecDecoder::necxDittoLength;
+
+    /**
+     * Renders a frame into the buffer.
+     * @param durations buffer of at least frameLength durations
+     * @param variant nec1, nec2, necx1, necx2, nec1f16, or necxf16
+     * @param D parameter "device"
+     * @param S parameter "sub-device"
+     * @param F parameter "function", 16 bits for nec1f16 and necxf16
+     * @return number of durations, 0 if variant is not supported
+     */
+    static size_t renderFrame(microseconds_t *durations, NecDecoder::Variant variant, unsigned int D, unsigned int S, unsigned int F);
+
+    /**
+     * Renders the ditto of a variant into the buffer.
+     * @param durations buffer of at least maxDittoLength durations
+     * @param variant nec1, necx1, or nec1f16
+     * @param D parameter "device"; only the lowest bit is used, and only for necx1
+     * @return number of durations, 0 if the variant has no ditto
+     */
+    static size_t renderDitto(microseconds_t *durations, NecDecoder::Variant variant, unsigned int D);
+
+    /**
+     * Generates an IrSignal from the parameters.
+     * Must be deleted explicitly by the user to avoid memory leaks.
+     * @param variant nec1, nec2, necx1, necx2, nec1f16, or necxf16
+     * @param D parameter "device"
+     * @param S parameter "sub-device"
+     * @param F parameter "function", 16 bits for nec1f16 and necxf16
+     * @return IrSignal, or NULL if variant is not supported
+     */
+    static const IrSignal *newIrSignal(NecDecoder::Variant variant, unsigned int D, unsigned int S, unsigned int F);
+
+    /**
+     * Generates an IrSignal from the parameters, with S defaulted: 255-D for NEC1, NEC2, and NEC1-f16, otherwise D.
+     * Must be deleted explicitly by the user to avoid memory leaks.
+     * @param variant nec1, nec2, necx1, necx2, nec1f16, or necxf16
+     * @param D parameter "device"
+     * @param F parameter "function", 16 bits for nec1f16 and necxf16
+     * @return IrSignal, or NULL if variant is not supported
+     */
+    static const IrSignal *newIrSignal(NecDecoder::Variant variant, unsigned int D, unsigned int F) {
+        return newIrSignal(variant, D, hasLongLeader(variant) ? 255U - D : D, F);
+    }
+
+private:
+    NecRenderer();
+    static const microseconds_t timebase = 564U;
+    static const uint32_t extent = 108000UL;
+
+    static bool hasLongLeader(NecDecoder::Variant variant) {
+        return variant == NecDecoder::nec1 || variant == NecDecoder::nec2 || variant == NecDecoder::nec1f16;
+    }
+    static void lsb(microseconds_t *durations, unsigned int& i, uint32_t& sum, uint32_t x, unsigned int width);
+};
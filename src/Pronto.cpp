@@ -1,9 +1,11 @@
 #include "Pronto.h"
+#include "HeapStatistics.h"
 #include "IrSignal.h"
 #include "Board.h" // for HAS_FLASH_READ
 #include <string.h>
 
 IrSignal *Pronto::parse(const uint16_t *data, size_t size) {
+    HeapStatistics::Scope scope(HeapStatistics::pronto);
     microseconds_t timebase = (microsecondsInSeconds * data[1] + referenceFrequency/2) / referenceFrequency;
     frequency_t frequency;
     switch (data[0]) {
@@ -72,8 +74,7 @@ IrSignal *Pronto::parse(const __FlashStringHelper *str) {
 IrSequence *Pronto::mkSequence(const uint16_t* data, size_t noPairs, microseconds_t timebase) {
     microseconds_t *durations = new microseconds_t[2*noPairs];
     for (unsigned int i = 0; i < 2*noPairs; i++) {
-        uint32_t duration = static_cast<uint32_t>(data[i]) * timebase;
-        durations[i] = (duration <= MICROSECONDS_T_MAX) ? duration : MICROSECONDS_T_MAX;
+        durations[i] = toMicroseconds(static_cast<uint32_t>(data[i]) * timebase);
     }
     return new IrSequence(durations, 2*noPairs, false);
 }
@@ -135,6 +136,7 @@ unsigned int Pronto::appendSequence(char *result, unsigned int index, const IrSe
 }
 
 char* Pronto::prelude(frequency_t frequency, size_t introLength, size_t repeatLength) {
+    HeapStatistics::Scope scope(HeapStatistics::pronto);
     char *result = new char[lengthHexString(introLength, repeatLength)];
     unsigned int index = 0;
     index = appendNumber(result, index, frequency > 0 ? learnedToken : learnedNonModulatedToken);
@@ -49,7 +49,7 @@ private:
 
     static unsigned int appendChar(char *result, unsigned int index, char ch);
 
-    static unsigned int appendDuration(char *result, unsigned int index, uint16_t duration, microseconds_t timebase);
+    static unsigned int appendDuration(char *result, unsigned int index, microseconds_t duration, microseconds_t timebase);
 
     static unsigned int appendDigit(char *result, unsigned int index, unsigned int number);
 
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "Biphase.h"
 #include "IrDecoder.h"
 #include "IrReader.h"
+#include <stdio.h>
 
 /**
  * A decoder class for RC5 signals.
@@ -16,6 +18,17 @@ public:
      */
     Rc5Decoder(const IrReader& irReader);
 
+    /**
+     * Constructs a Rc5Decoder from a reader of known type, containing data.
+     * Since the type of the reader is known to the compiler, the calls
+     * to getDuration() are not virtual, and can be inlined.
+     * @param irReader IrReader subclass with data, i.e. with isReady() true.
+     */
+    template<class Reader>
+    Rc5Decoder(const Reader& irReader) {
+        decodeDurations(irReader);
+    }
+
     virtual ~Rc5Decoder() {
     }
 
@@ -56,22 +69,37 @@ public:
 private:
     char decode[13];
     const static microseconds_t timebase = 889U;
-    const static microseconds_t timebaseLower = 800U;
-    const static microseconds_t timebaseUpper = 1000U;
-    static bool getDuration(microseconds_t duration, unsigned int time) {
-        return duration <= time * timebaseUpper
-                && duration >= time * timebaseLower;
-    }
+    /** Largest deviation of a duration from a multiple of timebase. */
+    const static microseconds_t tolerance = timebase / 4U;
     int F;
     int D;
     int T;
 
-    enum Length {
-        invalid = 0,
-        half = 1,
-        full = 2
-    };
-
-    static Length decodeDuration(microseconds_t t);
-    static unsigned int decodeFlashGap(microseconds_t flash, microseconds_t gap);
+    template<class Reader>
+    void decodeDurations(const Reader& irReader);
 };
+
+template<class Reader>
+void Rc5Decoder::decodeDurations(const Reader& irReader) {
+    F = invalid;
+    D = invalid;
+    T = invalid;
+    decode[0] = '\0';
+    if (irReader.getDataLength() == 0U)
+        return;
+
+    // The first half of the start bit is a space, invisible before the signal.
+    BiphaseReader<Reader> biphase(irReader, timebase, tolerance);
+    biphase.assumeSpace(1U);
+    int sum = biphase.msb(false, 14U);
+    if (sum < 0 || (sum & 0x2000) == 0 || !biphase.atEnd()
+            || !isEnding(irReader.getDuration(irReader.getDataLength() - 1U)))
+        return;
+
+    F = (sum & 0x3F) | ((~sum & 0x1000) >> 6);
+    D = (sum & 0x7C0) >> 6;
+    T = (sum & 0x800) >> 11;
+
+    setValid(true);
+    sprintf(decode, format, D, F, T);
+}
@@ -1,10 +1,6 @@
 #include "Rc5Renderer.h"
-
-// NOTE: writing intro[i++] = ... produces wrong result, compiler bug?
-// (Adding a print statement immediately after, and it works :-~)
-// So let's write intro[i] = ...; i++ at least for now.
-
-#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#include "Biphase.h"
+#include "HeapStatistics.h"
 
 uint8_t Rc5Renderer::T = 1U;
 
@@ -13,50 +9,21 @@ const IrSignal *Rc5Renderer::newIrSignal(unsigned int D, unsigned int F) {
     return newIrSignal(D, F, T);
 }
 
-static const IrSequence emptyIrSequence;
-
-const IrSignal *Rc5Renderer::newIrSignal(unsigned int D, unsigned int F, unsigned int T) {
-    unsigned int index = 0U;
-    int pending = 0;
-    microseconds_t *repeat = new microseconds_t[28];
-    emit(1U, index, pending, repeat);
-    emit(((~F) & 0x40U) >> 6U, index, pending, repeat);
-    emit(T & 1U, index, pending, repeat);
-    emitMsb(D, 5U, index, pending, repeat);
-    emitMsb(F, 6U, index, pending, repeat);
-    emitEnd(index, pending, repeat);
-    IrSequence *repeatSequence = new IrSequence(repeat, index, true);
-    return new IrSignal(emptyIrSequence, *repeatSequence, emptyIrSequence, frequency);
+size_t Rc5Renderer::render(microseconds_t *durations, unsigned int D, unsigned int F, unsigned int T) {
+    BiphaseWriter biphase(durations, timebase);
+    biphase.bit(1U, false);
+    biphase.bit(~F >> 6U, false);
+    biphase.bit(T, false);
+    biphase.msb(D, 5U, false);
+    biphase.msb(F, 6U, false);
+    // The frame, including the ending gap, lasts 114ms (the extent ^114m of the IRP),
+    // counted from the start of the first bit, whose leading half is silent, and not sent.
+    return biphase.end(toMicroseconds(extent - timebase - biphase.getTotal()));
 }
 
-void Rc5Renderer::emitMsb(unsigned int x, unsigned int length,
-        unsigned int& index, int& pending, microseconds_t *repeat) {
-    unsigned int mask = 1U << (length - 1U);
-    while (mask != 0U) {
-        emit((x & mask) != 0, index, pending, repeat);
-        mask >>= 1U;
-    }
-}
-
-void Rc5Renderer::emit(unsigned int x, unsigned int& index, int& pending,
-                       microseconds_t *repeat) {
-    if (pending == 0) {
-        // First, do nothing, just stuff in pending.
-    } else if ((pending > 0) == ((x & 1U) != 0U)) {
-        repeat[index] = timebase;
-        index++;
-        repeat[index] = timebase;
-        index++;
-    } else {
-        repeat[index] = 2U * timebase;
-        index++;
-    }
-    pending = (x & 1U) ? 1 : -1;
-}
-
-void Rc5Renderer::emitEnd(unsigned int& index, int& pending, microseconds_t *repeat) {
-    if (pending > 0) {
-        repeat[index] = timebase; index++;
-    }
-    repeat[index] = MIN(90000U, MICROSECONDS_T_MAX); index++;
+const IrSignal *Rc5Renderer::newIrSignal(unsigned int D, unsigned int F, unsigned int T) {
+    HeapStatistics::Scope scope(HeapStatistics::renderers);
+    microseconds_t *repeat = new microseconds_t[maxLength];
+    size_t length = render(repeat, D, F, T);
+    return new IrSignal(NULL, 0U, repeat, length, NULL, 0U, frequency, IrSignal::noDutyCycle, true);
 }
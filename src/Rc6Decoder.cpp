@@ -0,0 +1,12 @@
+#include "Rc6Decoder.h"
+
+const char *Rc6Decoder::format = "RC6 %d %d %d";
+
+Rc6Decoder::Rc6Decoder(const IrReader& irReader) {
+    decodeDurations(irReader);
+}
+
+bool Rc6Decoder::tryDecode(const IrReader& irReader, Stream& stream) {
+    Rc6Decoder decoder(irReader);
+    return decoder.printDecode(stream);
+}
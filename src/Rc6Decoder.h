@@ -0,0 +1,136 @@
+/*
+Copyright (C) 2020 Bengt Martensson.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see http://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include "Biphase.h"
+#include "IrDecoder.h"
+#include "IrReader.h"
+#include <stdio.h>
+
+/**
+ * A decoder class for RC6 mode 0 signals, given in IRP notation as
+ * {36k,msb,444}<-1,1|1,-1>((6,-2,1:1,0:3,<-2,2|2,-2>(T:1),D:8,F:8,^107m)+,T=1-T)[D:0..255,F:0..255,T@:0..1=0].
+ * Decodes in one pass over the durations, see BiphaseReader.
+ */
+class Rc6Decoder : public IrDecoder {
+public:
+    static const char *format;
+
+    /**
+     * Constructs a Rc6Decoder from an IrReader, containing data.
+     * @param irReader IrReader with data, i.e. with isReady() true.
+     */
+    Rc6Decoder(const IrReader& irReader);
+
+    /**
+     * Constructs a Rc6Decoder from a reader of known type, containing data.
+     * Since the type of the reader is known to the compiler, the calls
+     * to getDuration() are not virtual, and can be inlined.
+     * @param irReader IrReader subclass with data, i.e. with isReady() true.
+     */
+    template<class Reader>
+    Rc6Decoder(const Reader& irReader) {
+        decodeDurations(irReader);
+    }
+
+    virtual ~Rc6Decoder() {
+    }
+
+    /**
+     * Returns the F parameter, or -1 if invalid.
+     * @return int
+     */
+    int getF() const {
+        return F;
+    }
+
+    /**
+     * Returns the D parameter, or -1 if invalid.
+     * @return int
+     */
+    int getD() const {
+        return D;
+    }
+
+    /**
+     * Returns the T parameter, or -1 if invalid.
+     * @return int
+     */
+    int getT() const {
+        return T;
+    }
+
+    /**
+     * Convenience function; constructs an Rc6Decoder and calls its printDecode.
+     * @param irReader IrReader to use
+     * @param stream Stream
+     * @return success of operation
+     */
+    static bool tryDecode(const IrReader& irReader, Stream& stream);
+
+    const char *getDecode() const {
+        return decode;
+    }
+
+private:
+    char decode[14];
+    const static microseconds_t timebase = 444U;
+    /**
+     * Largest deviation of a duration from a multiple of timebase.
+     * Relatively larger than for RC5, since receivers typically shorten marks by 100us or so.
+     */
+    const static microseconds_t tolerance = 160U;
+    int F;
+    int D;
+    int T;
+
+    template<class Reader>
+    void decodeDurations(const Reader& irReader);
+};
+
+template<class Reader>
+void Rc6Decoder::decodeDurations(const Reader& irReader) {
+    F = invalid;
+    D = invalid;
+    T = invalid;
+    decode[0] = '\0';
+    if (irReader.getDataLength() == 0U)
+        return;
+
+    BiphaseReader<Reader> biphase(irReader, timebase, tolerance);
+    if (!biphase.expect(true, 6U) || !biphase.expect(false, 2U))
+        return;
+    if (biphase.bit(true) != 1 || biphase.msb(true, 3U) != 0) // start bit, mode 0
+        return;
+    int t = biphase.bit(true, 2U);
+    if (t < 0)
+        return;
+    int d = biphase.msb(true, 8U);
+    if (d < 0)
+        return;
+    int f = biphase.msb(true, 8U);
+    if (f < 0 || !biphase.atEnd()
+            || !isEnding(irReader.getDuration(irReader.getDataLength() - 1U)))
+        return;
+
+    F = f;
+    D = d;
+    T = t;
+    setValid(true);
+    sprintf(decode, format, D, F, T);
+}
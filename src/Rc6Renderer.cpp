@@ -0,0 +1,29 @@
+#include "Rc6Renderer.h"
+#include "Biphase.h"
+#include "HeapStatistics.h"
+
+uint8_t Rc6Renderer::T = 1U;
+
+size_t Rc6Renderer::render(microseconds_t *durations, unsigned int D, unsigned int F, unsigned int T) {
+    BiphaseWriter biphase(durations, timebase);
+    biphase.emit(true, 6U);
+    biphase.emit(false, 2U);
+    biphase.bit(1U, true);
+    biphase.msb(0U, 3U, true);
+    biphase.bit(T, true, 2U);
+    biphase.msb(D, 8U, true);
+    biphase.msb(F, 8U, true);
+    return biphase.end(toMicroseconds(extent - biphase.getTotal()));
+}
+
+const IrSignal *Rc6Renderer::newIrSignal(unsigned int D, unsigned int F) {
+    T = ! T;
+    return newIrSignal(D, F, T);
+}
+
+const IrSignal *Rc6Renderer::newIrSignal(unsigned int D, unsigned int F, unsigned int T) {
+    HeapStatistics::Scope scope(HeapStatistics::renderers);
+    microseconds_t *repeat = new microseconds_t[maxLength];
+    size_t length = render(repeat, D, F, T);
+    return new IrSignal(NULL, 0U, repeat, length, NULL, 0U, frequency, IrSignal::noDutyCycle, true);
+}
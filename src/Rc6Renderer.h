@@ -0,0 +1,71 @@
+/*
+Copyright (C) 2020 Bengt Martensson.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see http://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include "IrSignal.h"
+
+/**
+ * A static class generating IrSignal-s from the parameters of RC6 mode 0, given in IRP notation as
+ * {36k,msb,444}<-1,1|1,-1>((6,-2,1:1,0:3,<-2,2|2,-2>(T:1),D:8,F:8,^107m)+,T=1-T)[D:0..255,F:0..255,T@:0..1=0].
+ * The frame is the repeat sequence; the intro is empty.
+ *
+ * render() fills a buffer supplied by the caller, and does not allocate.
+ */
+class Rc6Renderer {
+public:
+    static const frequency_t frequency = 36000U;
+
+    /** Largest number of durations of a frame. */
+    static const size_t maxLength = 44U;
+
+    /**
+     * Renders a frame into the buffer.
+     * @param durations buffer of at least maxLength durations
+     * @param D RC6 parameter, "device"
+     * @param F RC6 parameter, "function"
+     * @param T RC6 parameter, "toggle"
+     * @return number of durations
+     */
+    static size_t render(microseconds_t *durations, unsigned int D, unsigned int F, unsigned int T);
+
+    /**
+     * Generates an RC6 signal from the RC6 parameters.
+     * Must be deleted explicitly by the user to avoid memory leaks.
+     * @param D RC6 parameter, "device"
+     * @param F RC6 parameter, "function"
+     * @param T RC6 parameter, "toggle"
+     * @return IrSignal
+     */
+    static const IrSignal *newIrSignal(unsigned int D, unsigned int F, unsigned int T);
+
+    /**
+     * Generates an RC6 signal from the RC6 parameters.
+     * This version uses an internal toggle of the class to compute T.
+     * @param D RC6 parameter, "device"
+     * @param F RC6 parameter, "function"
+     * @return IrSignal
+     */
+    static const IrSignal *newIrSignal(unsigned int D, unsigned int F);
+
+private:
+    Rc6Renderer();
+    static const microseconds_t timebase = 444U;
+    static const uint32_t extent = 107000UL;
+
+    static uint8_t T;
+};
@@ -0,0 +1,114 @@
+#include "RepeatFinder.h"
+#include "HeapStatistics.h"
+#include <string.h>
+
+RepeatFinder::RepeatFinder(const IrReader& irReader, microseconds_t minRepeatGap_)
+: durations(NULL), length(irReader.getDataLength()),
+        frequency(irReader.getFrequency()), minRepeatGap(minRepeatGap_),
+        introLength(length), repeatLength(0U), numberRepeats(0U) {
+    HeapStatistics::Scope scope(HeapStatistics::sequences);
+    durations = new microseconds_t[length];
+    for (size_t i = 0U; i < length; i++)
+        durations[i] = irReader.getDuration(i);
+    analyze();
+}
+
+RepeatFinder::RepeatFinder(const IrSequence& irSequence, frequency_t frequency_, microseconds_t minRepeatGap_)
+: durations(NULL), length(irSequence.getLength()),
+        frequency(frequency_), minRepeatGap(minRepeatGap_),
+        introLength(length), repeatLength(0U), numberRepeats(0U) {
+    HeapStatistics::Scope scope(HeapStatistics::sequences);
+    durations = new microseconds_t[length];
+    memcpy(durations, irSequence.getDurations(), length * sizeof(microseconds_t));
+    analyze();
+}
+
+RepeatFinder::~RepeatFinder() {
+    delete [] durations;
+}
+
+bool RepeatFinder::isClose(microseconds_t a, microseconds_t b) {
+    microseconds_t diff = a > b ? (microseconds_t) (a - b) : (microseconds_t) (b - a);
+    microseconds_t larger = a > b ? a : b;
+    return diff <= absoluteTolerance || diff <= larger / 4U;
+}
+
+void RepeatFinder::quantize(uint8_t *codes) const {
+    microseconds_t clusters[maxClusters];
+    uint8_t noClusters = 0U;
+    for (size_t i = 0U; i < length; i++) {
+        uint8_t code = noCode;
+        for (uint8_t c = 0U; c < noClusters; c++) {
+            if (isClose(durations[i], clusters[c])) {
+                code = c;
+                break;
+            }
+        }
+        if (code == noCode && noClusters < maxClusters) {
+            clusters[noClusters] = durations[i];
+            code = noClusters++;
+        }
+        codes[i] = code;
+    }
+}
+
+bool RepeatFinder::matches(const uint8_t *codes, size_t i, size_t j) const {
+    if (j == length - 1U) // ending timeout
+        return (i & 1U) && durations[i] >= minRepeatGap && durations[j] >= minRepeatGap;
+    return codes[i] != noCode && codes[i] == codes[j];
+}
+
+void RepeatFinder::analyze() {
+    if (length < 4U)
+        return;
+
+    HeapStatistics::Scope scope(HeapStatistics::sequences);
+    uint8_t *codes = new uint8_t[length];
+    quantize(codes);
+
+    size_t bestCovered = 0U;
+    for (size_t lag = 2U; lag <= length / 2U; lag += 2U) {
+        size_t runStart = 0U;
+        for (size_t i = 0U; i + lag <= length; i++) {
+            if (i + lag < length && matches(codes, i, i + lag))
+                continue;
+
+            // positions runStart..i-1 match at distance lag
+            size_t start = (runStart + 1U) & ~(size_t) 1U;
+            if (i >= start + lag) {
+                unsigned int repeats = (unsigned int) ((i - start) / lag + 1U);
+                size_t covered = repeats * lag;
+                if (covered > bestCovered && durations[start + lag - 1U] >= minRepeatGap) {
+                    bestCovered = covered;
+                    introLength = start;
+                    repeatLength = lag;
+                    numberRepeats = repeats;
+                }
+            }
+            runStart = i + 1U;
+        }
+    }
+
+    delete [] codes;
+}
+
+microseconds_t *RepeatFinder::copy(size_t start, size_t count) const {
+    HeapStatistics::Scope scope(HeapStatistics::sequences);
+    microseconds_t *data = new microseconds_t[count];
+    memcpy(data, durations + start, count * sizeof(microseconds_t));
+    return data;
+}
+
+IrSignal *RepeatFinder::toIrSignal() const {
+    HeapStatistics::Scope scope(HeapStatistics::sequences);
+    size_t endingStart = introLength + numberRepeats * repeatLength;
+    return new IrSignal(copy(0U, introLength), introLength,
+            copy(introLength, repeatLength), repeatLength,
+            copy(endingStart, length - endingStart), length - endingStart,
+            frequency, IrSignal::noDutyCycle, true);
+}
+
+IrSignal *RepeatFinder::newIrSignal(const IrReader& irReader) {
+    RepeatFinder repeatFinder(irReader);
+    return repeatFinder.toIrSignal();
+}
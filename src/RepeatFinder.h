@@ -0,0 +1,115 @@
+/*
+Copyright (C) 2020 Bengt Martensson.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see http://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include "IrReader.h"
+#include "IrSignal.h"
+
+/**
+ * Finds the repetitive structure in a captured sequence, so that it can be
+ * represented as an IrSignal with intro, repeat, and ending, instead of a flat sequence
+ * containing N copies of the repeat.
+ *
+ * The durations are first quantized, i.e. durations within the tolerance of each other
+ * are given the same code. Then, for every even lag, the longest run of positions
+ * with equal codes at distance lag is determined (autocorrelation). The lag and start
+ * giving the largest number of durations covered by at least two repetitions wins,
+ * provided that the candidate repeat ends with a gap of at least minRepeatGap.
+ * The last gap of the capture, which is typically the ending timeout,
+ * matches any gap that is at least minRepeatGap.
+ *
+ * If no repeat is found, the whole sequence becomes the intro.
+ */
+class RepeatFinder {
+public:
+    static const microseconds_t defaultMinRepeatGap = 5000U;
+
+    /**
+     * Constructs a RepeatFinder from an IrReader and analyzes its content.
+     * @param irReader IrReader with data
+     * @param minRepeatGap minimal length of the gap ending a repeat
+     */
+    RepeatFinder(const IrReader& irReader, microseconds_t minRepeatGap = defaultMinRepeatGap);
+
+    /**
+     * Constructs a RepeatFinder from an IrSequence and analyzes it.
+     * @param irSequence IrSequence
+     * @param frequency modulation frequency
+     * @param minRepeatGap minimal length of the gap ending a repeat
+     */
+    RepeatFinder(const IrSequence& irSequence, frequency_t frequency = IrSignal::defaultFrequency,
+            microseconds_t minRepeatGap = defaultMinRepeatGap);
+
+    virtual ~RepeatFinder();
+
+    /**
+     * Creates the IrSignal with the found intro, repeat, and ending.
+     * The durations are copied; the IrSignal should be deleted by the user.
+     * @return IrSignal, never NULL
+     */
+    IrSignal *toIrSignal() const;
+
+    /**
+     * Convenience function: Analyzes the IrReader and returns the IrSignal found.
+     * @param irReader IrReader with data
+     * @return IrSignal, to be deleted by the user.
+     */
+    static IrSignal *newIrSignal(const IrReader& irReader);
+
+    size_t getIntroLength() const {
+        return introLength;
+    }
+
+    size_t getRepeatLength() const {
+        return repeatLength;
+    }
+
+    /**
+     * Returns the number of times the repeat was found in the sequence, 0 if none.
+     * @return number of repetitions
+     */
+    unsigned int getNumberRepeats() const {
+        return numberRepeats;
+    }
+
+    size_t getEndingLength() const {
+        return length - introLength - numberRepeats * repeatLength;
+    }
+
+private:
+    static const uint8_t maxClusters = 64U;
+    static const uint8_t noCode = 0xFFU;
+    static const microseconds_t absoluteTolerance = 100U;
+
+    microseconds_t *durations;
+    size_t length;
+    frequency_t frequency;
+    microseconds_t minRepeatGap;
+    size_t introLength;
+    size_t repeatLength;
+    unsigned int numberRepeats;
+
+    RepeatFinder(const RepeatFinder&);
+    RepeatFinder& operator=(const RepeatFinder&);
+
+    static bool isClose(microseconds_t a, microseconds_t b);
+    void quantize(uint8_t *codes) const;
+    bool matches(const uint8_t *codes, size_t i, size_t j) const;
+    void analyze();
+    microseconds_t *copy(size_t start, size_t count) const;
+};
@@ -1,7 +1,271 @@
 #ifndef ARDUINO
 #include "Arduino.h"
+#include "SIL.h"
+#include <algorithm>
 
-uint8_t currentWritePin = 255;
-struct timeval simulatedTime = getTimeOfDay();
+bool SIL::levels[noPins];
+uint32_t SIL::lastEdges[noPins];
+PinTimeline *SIL::timelines[noPins];
+PinTimeline *SIL::inputs[noPins];
+void (*SIL::pinChangeFunctions[noPins])();
+uint32_t SIL::randomState = 1U;
+uint32_t SIL::generations[noPins];
 
-#endif
\ No newline at end of file
+void pinMode(uint8_t pin, PinMode mode) {
+    std::cout << "pinMode(" << (int) pin << ", "
+            << (mode == INPUT ? "INPUT" : mode == OUTPUT ? "OUTPUT" : mode == INPUT_PULLUP ? "INPUT_PULLUP" : "INPUT_PULLDOWN")
+            << ")" << std::endl;
+    SIL::setPinMode(pin, mode);
+}
+
+void digitalWrite(uint8_t pin, PinStatus value) {
+#ifdef REPORT_TIMES
+    if (SIL::getLevel(pin) != (value != LOW)) {
+        char sign = value ? '-' : '+';
+        std::cout << sign << (uint32_t) micros() - SIL::lastEdge(pin) << " ";
+    }
+#endif
+    SIL::write(pin, value != LOW);
+}
+
+uint8_t digitalRead(uint8_t pin) {
+    return SIL::read(pin) ? HIGH : LOW;
+}
+
+// Only CHANGE is supported.
+void attachInterrupt(uint8_t interrupt, void (*function)(), int mode __attribute__((unused))) {
+    SIL::attachPinChange(interrupt, function);
+}
+
+void detachInterrupt(uint8_t interrupt) {
+    SIL::attachPinChange(interrupt, NULL);
+}
+
+void SIL::setPinMode(uint8_t pin, PinMode mode) {
+    if (mode == OUTPUT) {
+        levels[pin] = false;
+        lastEdges[pin] = (uint32_t) micros();
+    } else if (mode == INPUT_PULLUP)
+        levels[pin] = true;
+}
+
+void SIL::write(uint8_t pin, bool level) {
+    if (levels[pin] == level)
+        return;
+    uint32_t now = (uint32_t) micros();
+    levels[pin] = level;
+    lastEdges[pin] = now;
+    if (timelines[pin] != NULL)
+        timelines[pin]->add(now, level);
+}
+
+bool SIL::getLevel(uint8_t pin) {
+    return levels[pin];
+}
+
+uint32_t SIL::lastEdge(uint8_t pin) {
+    return lastEdges[pin];
+}
+
+PinTimeline& SIL::probe(uint8_t pin) {
+    if (timelines[pin] == NULL)
+        timelines[pin] = new PinTimeline();
+    timelines[pin]->clear(levels[pin]);
+    return *timelines[pin];
+}
+
+void SIL::release(uint8_t pin) {
+    delete timelines[pin];
+    timelines[pin] = NULL;
+}
+
+const PinTimeline *SIL::getTimeline(uint8_t pin) {
+    return timelines[pin];
+}
+
+uint32_t SIL::inject(uint8_t pin, const IrSequence& irSequence, frequency_t frequency,
+        microseconds_t jitter, unsigned int noise, bool activeLow) {
+    std::vector<double> edges;
+    double time = 0.0;
+    for (size_t i = 0U; i < irSequence.getLength(); i++) {
+        microseconds_t duration = irSequence.getDurations()[i];
+        if (i % 2U == 0U) {
+            if (frequency == 0U) {
+                edges.push_back(time);
+                edges.push_back(time + duration);
+            } else {
+                double period = 1000000.0 / frequency;
+                unsigned long periods = (unsigned long) (duration / period + 0.5);
+                for (unsigned long k = 0UL; k < (periods > 0UL ? periods : 1UL); k++) {
+                    edges.push_back(time + k * period);
+                    edges.push_back(time + k * period + period / 2.0);
+                }
+            }
+        }
+        time += duration;
+    }
+    if (jitter > 0U)
+        for (size_t i = 0U; i < edges.size(); i++)
+            edges[i] += (double) nextRandom(2U * jitter + 1U) - jitter;
+    uint32_t total = (uint32_t) time;
+    for (unsigned int i = 0U; i < noise && total > 0U; i++) {
+        double start = nextRandom(total);
+        edges.push_back(start);
+        edges.push_back(start + 1U + nextRandom(maxGlitch));
+    }
+    std::sort(edges.begin(), edges.end());
+
+    if (inputs[pin] == NULL)
+        inputs[pin] = new PinTimeline();
+    PinTimeline& input = *inputs[pin];
+    uint32_t now = (uint32_t) micros();
+    input.clear(activeLow);
+    // Pending pin change events of a previous playback are ignored.
+    generations[pin]++;
+    void *argument = reinterpret_cast<void*>((uintptr_t) generations[pin] << 8U | pin);
+    for (size_t i = 0U; i < edges.size(); i++) {
+        uint32_t offset = (uint32_t) (edges[i] > 0.0 ? edges[i] + 0.5 : 0.0);
+        input.toggle(now + offset);
+        if (pinChangeFunctions[pin] != NULL)
+            SimulatedClock::schedule(SimulatedClock::now() + offset, pinChanged, argument);
+    }
+    return now + total;
+}
+
+void SIL::attachPinChange(uint8_t pin, void (*function)()) {
+    pinChangeFunctions[pin] = function;
+}
+
+void SIL::pinChanged(void *argument) {
+    uintptr_t value = reinterpret_cast<uintptr_t>(argument);
+    uint8_t pin = (uint8_t) (value & 0xFFU);
+    if (pinChangeFunctions[pin] != NULL && inputs[pin] != NULL && (uint32_t) (value >> 8U) == generations[pin])
+        pinChangeFunctions[pin]();
+}
+
+void SIL::eject(uint8_t pin) {
+    generations[pin]++;
+    delete inputs[pin];
+    inputs[pin] = NULL;
+}
+
+bool SIL::read(uint8_t pin) {
+    return inputs[pin] != NULL ? inputs[pin]->levelAt((uint32_t) micros()) : levels[pin];
+}
+
+void SIL::seed(uint32_t value) {
+    randomState = value;
+}
+
+// Linear congruential generator, as in Numerical Recipes; good enough for test signals.
+uint32_t SIL::nextRandom(uint32_t limit) {
+    randomState = 1664525U * randomState + 1013904223U;
+    return (uint32_t) (((uint64_t) randomState * limit) >> 32);
+}
+
+PinTimeline::PinTimeline() : initialLevel(false) {
+}
+
+void PinTimeline::clear(bool level) {
+    initialLevel = level;
+    times.clear();
+}
+
+void PinTimeline::add(uint32_t time, bool level) {
+    if (level == (times.empty() ? initialLevel : getLevel(times.size() - 1U)))
+        return;
+    toggle(time);
+}
+
+bool PinTimeline::levelAt(uint32_t time) const {
+    size_t edges = (size_t) (std::upper_bound(times.begin(), times.end(), time) - times.begin());
+    return (edges % 2U == 1U) != initialLevel;
+}
+
+void PinTimeline::analyze(microseconds_t maxCarrierGap, std::vector<microseconds_t> *durations,
+        uint32_t& carrierTime, uint32_t& carrierOnTime, unsigned long& periods) const {
+    carrierTime = 0U;
+    carrierOnTime = 0U;
+    periods = 0UL;
+    size_t first = initialLevel ? 1U : 0U; // first rising edge
+    // Carrier: pulses followed by another pulse of the same mark.
+    for (size_t i = first; i + 2U < times.size(); i += 2U) {
+        if (times[i + 2U] - times[i + 1U] > maxCarrierGap)
+            continue;
+        carrierTime += times[i + 2U] - times[i];
+        carrierOnTime += times[i + 1U] - times[i];
+        periods++;
+    }
+    if (durations == NULL)
+        return;
+
+    uint32_t period = periods > 0UL ? (uint32_t) ((carrierTime + periods / 2UL) / periods) : 0U;
+    uint32_t previousEnd = 0U;
+    for (size_t i = first; i + 1U < times.size(); i += 2U) {
+        uint32_t start = times[i];
+        size_t last = i;
+        while (last + 2U < times.size() && times[last + 2U] - times[last + 1U] <= maxCarrierGap)
+            last += 2U;
+        uint32_t end = last > i && period > 0U ? times[last] + period : times[last + 1U];
+        if (i > first)
+            durations->push_back((microseconds_t) (start - previousEnd));
+        durations->push_back((microseconds_t) (end - start));
+        previousEnd = end;
+        i = last;
+    }
+}
+
+std::vector<microseconds_t> PinTimeline::envelope(microseconds_t maxCarrierGap) const {
+    std::vector<microseconds_t> durations;
+    uint32_t carrierTime;
+    uint32_t carrierOnTime;
+    unsigned long periods;
+    analyze(maxCarrierGap, &durations, carrierTime, carrierOnTime, periods);
+    return durations;
+}
+
+unsigned long PinTimeline::analyzeCarrier(frequency_t& frequency, dutycycle_t& dutyCycle, microseconds_t maxCarrierGap) const {
+    uint32_t carrierTime;
+    uint32_t carrierOnTime;
+    unsigned long periods;
+    analyze(maxCarrierGap, NULL, carrierTime, carrierOnTime, periods);
+    frequency = carrierTime > 0U ? (frequency_t) ((1000000ULL * periods + carrierTime / 2U) / carrierTime) : 0U;
+    dutyCycle = carrierTime > 0U ? (dutycycle_t) ((100U * carrierOnTime + carrierTime / 2U) / carrierTime) : IrSignal::noDutyCycle;
+    return periods;
+}
+
+static bool withinTolerance(uint32_t actual, uint32_t expected, uint32_t absoluteTolerance, unsigned int relativeTolerance) {
+    uint32_t difference = actual > expected ? actual - expected : expected - actual;
+    return difference <= absoluteTolerance || 100ULL * difference <= (uint64_t) relativeTolerance * expected;
+}
+
+bool PinTimeline::matches(const IrSequence& expected, frequency_t frequency,
+        microseconds_t absoluteTolerance, unsigned int relativeTolerance, bool verbose) const {
+    bool ok = true;
+    frequency_t actualFrequency;
+    dutycycle_t dutyCycle;
+    analyzeCarrier(actualFrequency, dutyCycle);
+    if (frequency == 0U ? actualFrequency != 0U : !withinTolerance(actualFrequency, frequency, 0U, relativeTolerance)) {
+        if (verbose)
+            std::cout << "frequency: " << actualFrequency << ", expected " << frequency << std::endl;
+        ok = false;
+    }
+
+    std::vector<microseconds_t> durations = envelope();
+    size_t length = expected.getLength() > 0U ? expected.getLength() - 1U : 0U;
+    if (durations.size() != length) {
+        if (verbose)
+            std::cout << "length: " << durations.size() << ", expected " << length << std::endl;
+        return false;
+    }
+    for (size_t i = 0U; i < length; i++) {
+        if (!withinTolerance(durations[i], expected.getDurations()[i], absoluteTolerance, relativeTolerance)) {
+            if (verbose)
+                std::cout << "duration " << i << ": " << durations[i] << ", expected " << expected.getDurations()[i] << std::endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+#endif
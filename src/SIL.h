@@ -0,0 +1,197 @@
+/*
+Copyright (C) 2020 Bengt Martensson.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see http://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#ifndef ARDUINO
+
+#include <vector>
+#include "IrSignal.h"
+
+/**
+ * Edges of one simulated output pin, as written by digitalWrite, with their (simulated) times.
+ * Only changes of the level are recorded; the level toggles at every edge,
+ * starting from the level at the time the pin was probed.
+ *
+ * The analysis functions work like a (very simple) oscilloscope:
+ * the carrier pulses of a modulated signal are merged into marks,
+ * and the carrier is measured from the pulses within the marks.
+ */
+class PinTimeline {
+public:
+    /** Default longest off-time within a modulated mark; corresponds to carriers above 10kHz. */
+    static const microseconds_t defaultMaxCarrierGap = 100U;
+
+    PinTimeline();
+
+    void clear(bool level = false);
+
+    void add(uint32_t time, bool level);
+
+    /** @return number of edges recorded */
+    size_t size() const {
+        return times.size();
+    }
+
+    uint32_t getTime(size_t index) const {
+        return times[index];
+    }
+
+    /** @return level after the edge */
+    bool getLevel(size_t index) const {
+        return ((index & 1U) == 0U) != initialLevel;
+    }
+
+    /** @return level at the time, i.e. after all edges up to and including time */
+    bool levelAt(uint32_t time) const;
+
+    /** Adds an edge at time, not earlier than the previous one, inverting the level. */
+    void toggle(uint32_t time) {
+        times.push_back(time);
+    }
+
+    /**
+     * Computes the envelope of the recorded signal, i.e. the durations of the marks
+     * and the spaces between them, like a demodulating IR receiver would see them.
+     * The end of a modulated mark is taken as its last rising edge plus one carrier period.
+     * The space after the last mark is not included, since it has no end.
+     * @param maxCarrierGap longest off-time within a mark
+     * @return durations, starting with a mark
+     */
+    std::vector<microseconds_t> envelope(microseconds_t maxCarrierGap = defaultMaxCarrierGap) const;
+
+    /**
+     * Measures the carrier, from the pulses within the marks.
+     * @param frequency measured frequency, 0 if the signal is not modulated
+     * @param dutyCycle measured duty cycle in percent
+     * @param maxCarrierGap longest off-time within a mark
+     * @return number of carrier periods measured
+     */
+    unsigned long analyzeCarrier(frequency_t& frequency, dutycycle_t& dutyCycle,
+            microseconds_t maxCarrierGap = defaultMaxCarrierGap) const;
+
+    /**
+     * Compares the envelope with the expected IrSequence, except for its final space.
+     * A duration matches if it differs by at most absoluteTolerance,
+     * or by at most relativeTolerance percent.
+     * @param expected expected durations
+     * @param frequency expected carrier frequency, 0 for unmodulated
+     * @param absoluteTolerance in microseconds
+     * @param relativeTolerance in percent, also used for the frequency
+     * @param verbose if true, report the differences on std::cout
+     * @return true if all durations, and the carrier, match
+     */
+    bool matches(const IrSequence& expected, frequency_t frequency,
+            microseconds_t absoluteTolerance = 10U, unsigned int relativeTolerance = 2U,
+            bool verbose = false) const;
+
+private:
+    bool initialLevel;
+    std::vector<uint32_t> times;
+
+    void analyze(microseconds_t maxCarrierGap, std::vector<microseconds_t> *durations,
+            uint32_t& carrierTime, uint32_t& carrierOnTime, unsigned long& periods) const;
+};
+
+/**
+ * The simulated pins of the host SIL (software in the loop).
+ * Arduino.h's pinMode, digitalWrite, and digitalRead keep their state here, per pin.
+ * The edges of a pin are recorded only while it is probed.
+ * An input pin can be fed with an IrSequence, played back against the simulated clock.
+ */
+class SIL {
+public:
+    static const unsigned int noPins = 256U;
+
+    /**
+     * Starts recording the pin, discarding previous recordings.
+     * @param pin pin number
+     * @return the timeline, valid until release(pin)
+     */
+    static PinTimeline& probe(uint8_t pin);
+
+    /** Stops recording the pin, and frees its timeline. */
+    static void release(uint8_t pin);
+
+    /** @return timeline of the pin, NULL if not probed */
+    static const PinTimeline *getTimeline(uint8_t pin);
+
+    static bool getLevel(uint8_t pin);
+
+    /** @return time of the last edge of the pin, in micros() */
+    static uint32_t lastEdge(uint8_t pin);
+
+    /**
+     * Plays back the IrSequence on the input pin, starting now, the way a
+     * (demodulating, unless frequency is given) IR receiver would output it.
+     * After the last duration, the pin stays idle.
+     * The edges are also events of SimulatedClock, if a pin change function is attached.
+     * The random numbers are deterministic, see seed().
+     * @param pin pin number
+     * @param irSequence durations to play back
+     * @param frequency if not 0, the marks are sent as carrier pulses of this frequency, 50% duty cycle
+     * @param jitter every edge is moved by a random amount, between -jitter and +jitter microseconds
+     * @param noise number of short (at most maxGlitch microseconds) spurious pulses, at random times
+     * @param activeLow if true, a mark is output as LOW, as by a normal IR receiver
+     * @return time (micros()) of the end of the sequence
+     */
+    static uint32_t inject(uint8_t pin, const IrSequence& irSequence, frequency_t frequency = 0U,
+            microseconds_t jitter = 0U, unsigned int noise = 0U, bool activeLow = true);
+
+    /**
+     * Sets the function to be called at the edges of the input played back on the pin,
+     * from an event of SimulatedClock, like a pin change interrupt.
+     * It has to be set before the call to inject.
+     * @param pin pin number
+     * @param function function, or NULL
+     */
+    static void attachPinChange(uint8_t pin, void (*function)());
+
+    /** Stops playing back on the pin. */
+    static void eject(uint8_t pin);
+
+    /** Called by digitalRead. */
+    static bool read(uint8_t pin);
+
+    /** Restarts the random number generator used by inject. */
+    static void seed(uint32_t value);
+
+    static const microseconds_t maxGlitch = 20U;
+
+    /** Called by pinMode. */
+    static void setPinMode(uint8_t pin, PinMode mode);
+
+    /** Called by digitalWrite. */
+    static void write(uint8_t pin, bool level);
+
+private:
+    SIL();
+
+    static bool levels[noPins];
+    static uint32_t lastEdges[noPins];
+    static PinTimeline *timelines[noPins];
+    static PinTimeline *inputs[noPins];
+    static uint32_t randomState;
+    static void (*pinChangeFunctions[noPins])();
+    static uint32_t generations[noPins];
+
+    static void pinChanged(void *argument);
+
+    static uint32_t nextRandom(uint32_t limit);
+};
+
+#endif // ! ARDUINO
@@ -0,0 +1,250 @@
+#ifndef ARDUINO
+
+#include "SignalLibrary.h"
+#include "Pronto.h"
+#include <algorithm>
+#include <ctype.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+const char SignalLibrary::magic[8] = { 'I', 'r', 'S', 'i', 'g', 'L', 'i', 'b' };
+
+SignalLibrary::SignalLibrary() : base(NULL), mappedSize(0U) {
+}
+
+SignalLibrary::~SignalLibrary() {
+    close();
+}
+
+bool SignalLibrary::open(const char *filename) {
+    close();
+    int fd = ::open(filename, O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat status;
+    if (fstat(fd, &status) != 0 || (size_t) status.st_size < sizeof(Header)) {
+        ::close(fd);
+        return false;
+    }
+    void *mapping = mmap(NULL, (size_t) status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED)
+        return false;
+    base = static_cast<const uint8_t*>(mapping);
+    mappedSize = (size_t) status.st_size;
+    if (!isValid()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void SignalLibrary::close() {
+    if (base != NULL)
+        munmap(const_cast<uint8_t*>(base), mappedSize);
+    base = NULL;
+    mappedSize = 0U;
+}
+
+// Checks the header, and every entry, so that getName() and getIrSignal() stay within the mapping,
+// and that the names are strictly increasing, as find() requires.
+bool SignalLibrary::isValid() const {
+    const Header *h = header();
+    if (memcmp(h->magic, magic, sizeof(magic)) != 0
+            || h->version != version
+            || h->durationSize != sizeof(microseconds_t)
+            || h->entriesOffset % alignof(Entry) != 0U
+            || h->durationsOffset % alignof(microseconds_t) != 0U
+            || h->entriesOffset + (uint64_t) h->count * sizeof(Entry) > mappedSize
+            || h->stringsOffset + (uint64_t) h->stringsSize > mappedSize
+            || h->durationsOffset + (uint64_t) h->durationsCount * sizeof(microseconds_t) > mappedSize)
+        return false;
+
+    // A terminated string table makes every name within it terminated.
+    if (h->count > 0U && (h->stringsSize == 0U || base[h->stringsOffset + h->stringsSize - 1U] != '\0'))
+        return false;
+    for (uint32_t i = 0U; i < h->count; i++) {
+        const Entry *e = entry(i);
+        if (e->nameOffset >= h->stringsSize)
+            return false;
+        if (i > 0U && strcmp(getName(i - 1U), getName(i)) >= 0)
+            return false;
+        for (unsigned int j = 0U; j < 3U; j++)
+            if ((uint64_t) e->start[j] + e->length[j] > h->durationsCount)
+                return false;
+    }
+    return true;
+}
+
+uint32_t SignalLibrary::size() const {
+    return isOpen() ? header()->count : 0U;
+}
+
+const char *SignalLibrary::getName(uint32_t index) const {
+    return reinterpret_cast<const char*>(base + header()->stringsOffset + entry(index)->nameOffset);
+}
+
+IrSignal SignalLibrary::getIrSignal(uint32_t index) const {
+    const Entry *e = entry(index);
+    const microseconds_t *durations = reinterpret_cast<const microseconds_t*>(base + header()->durationsOffset);
+    return IrSignal(durations + e->start[0], e->length[0],
+            durations + e->start[1], e->length[1],
+            durations + e->start[2], e->length[2],
+            e->frequency, (dutycycle_t) e->dutyCycle, false);
+}
+
+long SignalLibrary::find(const char *name) const {
+    long low = 0L;
+    long high = (long) size() - 1L;
+    while (low <= high) {
+        long middle = (low + high) / 2L;
+        int cmp = strcmp(getName((uint32_t) middle), name);
+        if (cmp == 0)
+            return middle;
+        if (cmp < 0)
+            low = middle + 1L;
+        else
+            high = middle - 1L;
+    }
+    return notFound;
+}
+
+SignalLibrary::Builder::Builder() {
+}
+
+uint32_t SignalLibrary::Builder::intern(const IrSequence& irSequence) {
+    std::vector<microseconds_t> block(irSequence.getDurations(), irSequence.getDurations() + irSequence.getLength());
+    std::map<std::vector<microseconds_t>, uint32_t>::const_iterator it = blockIndex.find(block);
+    if (it != blockIndex.end())
+        return it->second;
+    uint32_t index = (uint32_t) blocks.size();
+    blocks.push_back(block);
+    blockIndex[block] = index;
+    return index;
+}
+
+void SignalLibrary::Builder::add(const char *name, const IrSignal& irSignal) {
+    Entry entry;
+    entry.name = name;
+    entry.frequency = irSignal.getFrequency();
+    entry.dutyCycle = irSignal.getDutyCycle();
+    entry.blocks[0] = intern(irSignal.getIntro());
+    entry.blocks[1] = intern(irSignal.getRepeat());
+    entry.blocks[2] = intern(irSignal.getEnding());
+    entries.push_back(entry);
+}
+
+bool SignalLibrary::Builder::addPronto(const char *name, const char *prontoHex) {
+    IrSignal *irSignal = Pronto::parse(prontoHex);
+    if (irSignal == NULL)
+        return false;
+    add(name, *irSignal);
+    delete irSignal;
+    return true;
+}
+
+bool SignalLibrary::Builder::addRaw(const char *name, const char *raw, frequency_t frequency) {
+    std::vector<microseconds_t> sequences[3];
+    dutycycle_t dutyCycle = IrSignal::noDutyCycle;
+    unsigned int sequence = 0U;
+    const char *p = raw;
+    while (*p != '\0') {
+        if (*p == '\n') {
+            sequence++;
+            p++;
+        } else if (isspace(*p) || *p == '+' || *p == '-')
+            p++;
+        else if (p[0] == 'f' && p[1] == '=') {
+            char *end;
+            frequency = (frequency_t) strtoul(p + 2, &end, 10);
+            p = end;
+        } else if (isdigit(*p)) {
+            char *end;
+            unsigned long value = strtoul(p, &end, 10);
+            if (*end == '%') {
+                dutyCycle = (dutycycle_t) value;
+                end++;
+            } else {
+                if (sequence > 2U || value > MICROSECONDS_T_MAX)
+                    return false;
+                sequences[sequence].push_back((microseconds_t) value);
+            }
+            p = end;
+        } else
+            return false;
+    }
+    for (unsigned int i = 0U; i < 3U; i++)
+        if (sequences[i].size() % 2U != 0U)
+            return false;
+    if (sequences[0].empty() && sequences[1].empty())
+        return false;
+
+    IrSequence intro(sequences[0].data(), sequences[0].size(), false);
+    IrSequence repeat(sequences[1].data(), sequences[1].size(), false);
+    IrSequence ending(sequences[2].data(), sequences[2].size(), false);
+    add(name, IrSignal(intro, repeat, ending, frequency, dutyCycle));
+    return true;
+}
+
+static bool writeAll(FILE *file, const void *data, size_t size) {
+    return size == 0U || fwrite(data, 1, size, file) == size;
+}
+
+bool SignalLibrary::Builder::write(const char *filename) const {
+    std::vector<size_t> order(entries.size());
+    for (size_t i = 0U; i < order.size(); i++)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b) { return entries[a].name < entries[b].name; });
+
+    std::vector<uint32_t> blockStart(blocks.size());
+    uint32_t durationsCount = 0U;
+    for (size_t i = 0U; i < blocks.size(); i++) {
+        blockStart[i] = durationsCount;
+        durationsCount += (uint32_t) blocks[i].size();
+    }
+
+    std::string strings;
+    std::vector<SignalLibrary::Entry> table;
+    for (size_t i = 0U; i < order.size(); i++) {
+        const Entry& e = entries[order[i]];
+        SignalLibrary::Entry out;
+        out.nameOffset = (uint32_t) strings.size();
+        strings += e.name;
+        strings += '\0';
+        out.frequency = e.frequency;
+        out.dutyCycle = e.dutyCycle;
+        for (unsigned int j = 0U; j < 3U; j++) {
+            out.start[j] = blockStart[e.blocks[j]];
+            out.length[j] = (uint32_t) blocks[e.blocks[j]].size();
+        }
+        table.push_back(out);
+    }
+    while (strings.size() % sizeof(uint32_t) != 0U)
+        strings += '\0';
+
+    Header header;
+    memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.durationSize = sizeof(microseconds_t);
+    header.count = (uint32_t) table.size();
+    header.entriesOffset = sizeof(Header);
+    header.stringsOffset = header.entriesOffset + header.count * (uint32_t) sizeof(SignalLibrary::Entry);
+    header.stringsSize = (uint32_t) strings.size();
+    header.durationsOffset = header.stringsOffset + header.stringsSize;
+    header.durationsCount = durationsCount;
+
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL)
+        return false;
+    bool ok = writeAll(file, &header, sizeof(header))
+            && writeAll(file, table.data(), table.size() * sizeof(SignalLibrary::Entry))
+            && writeAll(file, strings.data(), strings.size());
+    for (size_t i = 0U; ok && i < blocks.size(); i++)
+        ok = writeAll(file, blocks[i].data(), blocks[i].size() * sizeof(microseconds_t));
+    return fclose(file) == 0 && ok;
+}
+
+#endif // ! ARDUINO
@@ -0,0 +1,190 @@
+/*
+Copyright (C) 2020 Bengt Martensson.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see http://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#ifndef ARDUINO
+
+#include <map>
+#include <string>
+#include <vector>
+#include "IrSignal.h"
+
+/**
+ * Binary container for collections of named IrSignals, for host programs only.
+ * The file is memory mapped; the IrSignals handed out refer directly to the mapping,
+ * so no durations are copied. Opening a library checks every entry (not the durations),
+ * so it takes time linear in the number of signals.
+ *
+ * Layout (native byte order, all offsets from the start of the file):
+ * - header: magic, version, size of microseconds_t, number of signals,
+ *   and offset and size of the entry table, the string table, and the duration pool;
+ * - entry table: one entry per signal, sorted by name, with the offset of the name in the
+ *   string table, frequency, duty cycle, and start and length of intro, repeat, and ending in the pool;
+ * - string table: the names, '\0'-terminated;
+ * - duration pool: the duration blocks. Identical blocks (e.g. the NEC ditto) are stored only once.
+ *
+ * Libraries are created with SignalLibrary::Builder.
+ */
+class SignalLibrary {
+public:
+    static const uint32_t version = 1U;
+    static const long notFound = -1L;
+
+    SignalLibrary();
+    virtual ~SignalLibrary();
+
+    /**
+     * Maps the file, and checks the header and all entries, including that the names are sorted.
+     * @param filename library file
+     * @return false if the file could not be mapped, or is not a valid library.
+     */
+    bool open(const char *filename);
+
+    void close();
+
+    bool isOpen() const {
+        return base != NULL;
+    }
+
+    /**
+     * Returns the number of signals.
+     * @return number of signals, 0 if not open.
+     */
+    uint32_t size() const;
+
+    /**
+     * Returns the name of the signal.
+     * @param index index, 0 <= index < size()
+     * @return name, pointing into the mapping
+     */
+    const char *getName(uint32_t index) const;
+
+    /**
+     * Returns the IrSignal, as a view into the mapping. It is valid as long as the library is open.
+     * @param index index, 0 <= index < size()
+     * @return IrSignal
+     */
+    IrSignal getIrSignal(uint32_t index) const;
+
+    /**
+     * Finds a signal by name, using binary search.
+     * @param name name of signal
+     * @return index, or notFound
+     */
+    long find(const char *name) const;
+
+    /**
+     * Collects signals, and writes them as library.
+     */
+    class Builder {
+    public:
+        Builder();
+
+        /**
+         * Adds the IrSignal; the durations are copied.
+         * @param name name, should be unique
+         * @param irSignal IrSignal
+         */
+        void add(const char *name, const IrSignal& irSignal);
+
+        /**
+         * Adds a signal in Pronto Hex format.
+         * @param name name
+         * @param prontoHex Pronto Hex string
+         * @return false if not parseable
+         */
+        bool addPronto(const char *name, const char *prontoHex);
+
+        /**
+         * Adds a signal in the raw format written by IrSignal::dump (and IrReader::dump):
+         * an optional frequency ("f=38400") and duty cycle ("40%"), followed by the durations
+         * (with or without signs) of intro, repeat, and ending, separated by line feeds.
+         * @param name name
+         * @param raw raw signal
+         * @param frequency frequency to use if none is given in raw
+         * @return false if not parseable
+         */
+        bool addRaw(const char *name, const char *raw, frequency_t frequency = IrSignal::defaultFrequency);
+
+        /**
+         * Writes the collected signals to a file.
+         * @param filename file to write
+         * @return success
+         */
+        bool write(const char *filename) const;
+
+        size_t size() const {
+            return entries.size();
+        }
+
+    private:
+        struct Entry {
+            std::string name;
+            frequency_t frequency;
+            dutycycle_t dutyCycle;
+            uint32_t blocks[3];
+        };
+
+        std::vector<Entry> entries;
+        std::vector<std::vector<microseconds_t> > blocks;
+        std::map<std::vector<microseconds_t>, uint32_t> blockIndex;
+
+        uint32_t intern(const IrSequence& irSequence);
+    };
+
+private:
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t durationSize;
+        uint32_t count;
+        uint32_t entriesOffset;
+        uint32_t stringsOffset;
+        uint32_t stringsSize;
+        uint32_t durationsOffset;
+        uint32_t durationsCount;
+    };
+
+    struct Entry {
+        uint32_t nameOffset;
+        uint32_t frequency;
+        int32_t dutyCycle;
+        uint32_t start[3];
+        uint32_t length[3];
+    };
+
+    static const char magic[8];
+
+    const uint8_t *base;
+    size_t mappedSize;
+
+    SignalLibrary(const SignalLibrary&);
+    SignalLibrary& operator=(const SignalLibrary&);
+
+    const Header *header() const {
+        return reinterpret_cast<const Header*>(base);
+    }
+
+    const Entry *entry(uint32_t index) const {
+        return reinterpret_cast<const Entry*>(base + header()->entriesOffset) + index;
+    }
+
+    bool isValid() const;
+};
+
+#endif // ! ARDUINO
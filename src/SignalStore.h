@@ -0,0 +1,440 @@
+/*
+Copyright (C) 2020 Bengt Martensson.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see http://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include "HeapStatistics.h"
+#include "IrSignal.h"
+
+/**
+ * Persistent store of named IrSignals, in a fixed number of equally sized slots.
+ *
+ * The Storage template parameter is the backend, EepromStorage on the boards having HAS_EEPROM,
+ * FileStorage on the host. It has to provide read(address), update(address, value), and size();
+ * update is supposed to write only if the value changes.
+ *
+ * Layout: a header (magic, version, number of slots, slot size), followed by the slots.
+ * A slot consists of a used marker, a hash of the name, the name (nameLength characters,
+ * not necessarily terminated), the length of the encoded signal, and the encoded signal.
+ * Thus a slot is found in constant time by its number. Lookup by name is a linear scan
+ * over the slots, but it compares only the hash byte of each slot, and the name only when the hash matches.
+ *
+ * Encoding: frequency, duty cycle, intro-, repeat-, and ending length, and the size of the dictionary,
+ * followed by the dictionary of distinct durations (as varints),
+ * and the durations as indices into the dictionary, packed with 1, 2, or 4 bits per index.
+ * Signals with more than maxDictionary distinct durations are stored as plain varints.
+ */
+template<class Storage>
+class SignalStore {
+public:
+    static const uint8_t nameLength = 8U;
+    static const uint8_t maxDictionary = 16U;
+    static const int notFound = -1;
+
+    /**
+     * Constructor. Reads the geometry from the storage, if formatted.
+     * A geometry not fitting in the storage is taken as unformatted.
+     * @param storage backend
+     */
+    SignalStore(Storage& storage_) : storage(storage_), noSlots(0U), slotSize(0U) {
+        if (storage.size() >= headerSize && storage.read(0) == magic0 && storage.read(1) == magic1
+                && storage.read(2) == version) {
+            uint8_t number = storage.read(3);
+            uint16_t size = (uint16_t) (storage.read(4) | (storage.read(5) << 8U));
+            if (number > 0U && size >= slotHeaderSize && headerSize + (size_t) number * size <= storage.size()) {
+                noSlots = number;
+                slotSize = size;
+            }
+        }
+    }
+
+    bool isFormatted() const {
+        return noSlots > 0U;
+    }
+
+    /**
+     * Formats the storage, with all slots empty.
+     * @param number number of slots, > 0
+     * @return success
+     */
+    bool format(uint8_t number) {
+        if (number == 0U || storage.size() < headerSize + (size_t) number * (slotHeaderSize + 1U))
+            return false;
+        size_t size = (storage.size() - headerSize) / number;
+        noSlots = number;
+        slotSize = (uint16_t) (size > 0xFFFFU ? 0xFFFFU : size);
+        storage.update(0, magic0);
+        storage.update(1, magic1);
+        storage.update(2, version);
+        storage.update(3, noSlots);
+        storage.update(4, (uint8_t) (slotSize & 0xFFU));
+        storage.update(5, (uint8_t) (slotSize >> 8U));
+        for (uint8_t slot = 0U; slot < noSlots; slot++)
+            erase(slot);
+        return true;
+    }
+
+    uint8_t getNoSlots() const {
+        return noSlots;
+    }
+
+    /**
+     * Returns the number of bytes available for the encoded signal in each slot.
+     * @return capacity in bytes
+     */
+    size_t getSlotCapacity() const {
+        return slotSize - slotHeaderSize;
+    }
+
+    bool isUsed(uint8_t slot) const {
+        return slot < noSlots && storage.read(slotAddress(slot)) == usedMarker;
+    }
+
+    /**
+     * Copies the name of the slot into the buffer.
+     * @param slot slot number
+     * @param buffer buffer of at least nameLength + 1 characters
+     * @return false if slot not used
+     */
+    bool getName(uint8_t slot, char *buffer) const {
+        if (!isUsed(slot))
+            return false;
+        for (uint8_t i = 0U; i < nameLength; i++)
+            buffer[i] = (char) storage.read(slotAddress(slot) + nameOffset + i);
+        buffer[nameLength] = '\0';
+        return true;
+    }
+
+    /**
+     * Returns the number of the slot with the name given.
+     * @param name name, only the first nameLength characters are significant
+     * @return slot number, or notFound
+     */
+    int find(const char *name) const {
+        uint8_t hash = nameHash(name);
+        for (uint8_t slot = 0U; slot < noSlots; slot++) {
+            size_t address = slotAddress(slot);
+            if (storage.read(address) == usedMarker && storage.read(address + 1U) == hash && nameEquals(address, name))
+                return slot;
+        }
+        return notFound;
+    }
+
+    /**
+     * Stores the IrSignal in the slot. Only the bytes that differ from the old content are written.
+     * @param slot slot number
+     * @param name name, only the first nameLength characters are significant
+     * @param irSignal IrSignal to store
+     * @return false if the slot does not exist, or the signal does not fit
+     */
+    bool store(uint8_t slot, const char *name, const IrSignal& irSignal) {
+        if (slot >= noSlots)
+            return false;
+        Dictionary dictionary(irSignal);
+        size_t address = slotAddress(slot);
+        Writer counter(storage, address + dataOffset, getSlotCapacity(), true);
+        encode(counter, irSignal, dictionary);
+        if (counter.getCount() > getSlotCapacity())
+            return false;
+        if (!counter.isChanged() && isUsed(slot) && storage.read(address + 1U) == nameHash(name) && nameEquals(address, name))
+            return true; // already there, do not touch the used marker
+
+        storage.update(address, (uint8_t) ~usedMarker); // invalid while writing
+        Writer writer(storage, address + dataOffset, getSlotCapacity(), false);
+        encode(writer, irSignal, dictionary);
+        storage.update(address + lengthOffset, (uint8_t) (counter.getCount() & 0xFFU));
+        storage.update(address + lengthOffset + 1U, (uint8_t) (counter.getCount() >> 8U));
+        bool ended = false;
+        for (uint8_t i = 0U; i < nameLength; i++) {
+            ended = ended || name[i] == '\0';
+            storage.update(address + nameOffset + i, ended ? 0U : (uint8_t) name[i]);
+        }
+        storage.update(address + 1U, nameHash(name));
+        storage.update(address, usedMarker);
+        return true;
+    }
+
+    /**
+     * Marks the slot as empty.
+     * @param slot slot number
+     * @return false if the slot does not exist
+     */
+    bool erase(uint8_t slot) {
+        if (slot >= noSlots)
+            return false;
+        storage.update(slotAddress(slot), 0xFFU);
+        return true;
+    }
+
+    /**
+     * Reads the IrSignal in the slot.
+     * @param slot slot number
+     * @return IrSignal, to be deleted by the user, or NULL if the slot is not used.
+     */
+    IrSignal *load(uint8_t slot) const {
+        if (!isUsed(slot))
+            return NULL;
+        HeapStatistics::Scope scope(HeapStatistics::storage);
+        Reader reader(storage, slotAddress(slot) + dataOffset);
+        frequency_t frequency = reader.getVarint();
+        dutycycle_t dutyCycle = (dutycycle_t) reader.getByte();
+        size_t introLength = reader.getVarint();
+        size_t repeatLength = reader.getVarint();
+        size_t endingLength = reader.getVarint();
+        if (introLength + repeatLength + endingLength > getSlotCapacity() * 8U)
+            return NULL; // corrupt
+        Dictionary dictionary;
+        dictionary.size = reader.getByte();
+        if (dictionary.size > maxDictionary)
+            return NULL;
+        for (uint8_t i = 0U; i < dictionary.size; i++)
+            dictionary.values[i] = (microseconds_t) reader.getVarint();
+        dictionary.bits = bitsPerIndex(dictionary.size);
+
+        microseconds_t *intro = readDurations(reader, dictionary, introLength);
+        microseconds_t *repeat = readDurations(reader, dictionary, repeatLength);
+        microseconds_t *ending = readDurations(reader, dictionary, endingLength);
+        return new IrSignal(intro, introLength, repeat, repeatLength, ending, endingLength,
+                frequency, dutyCycle, true);
+    }
+
+    /**
+     * Reads the IrSignal with the name given.
+     * @param name name
+     * @return IrSignal, to be deleted by the user, or NULL if not found.
+     */
+    IrSignal *load(const char *name) const {
+        int slot = find(name);
+        return slot == notFound ? NULL : load((uint8_t) slot);
+    }
+
+private:
+    static const uint8_t magic0 = 'I';
+    static const uint8_t magic1 = 'S';
+    static const uint8_t version = 1U;
+    static const uint8_t headerSize = 6U;
+    static const uint8_t usedMarker = 0x5AU;
+    static const uint8_t nameOffset = 2U;
+    static const uint8_t lengthOffset = nameOffset + nameLength;
+    static const uint8_t dataOffset = lengthOffset + 2U;
+    static const uint8_t slotHeaderSize = dataOffset;
+
+    Storage& storage;
+    uint8_t noSlots;
+    uint16_t slotSize;
+
+    class Dictionary {
+    public:
+        microseconds_t values[maxDictionary];
+        uint8_t size;
+        uint8_t bits;
+
+        Dictionary() : size(0U), bits(0U) {}
+
+        Dictionary(const IrSignal& irSignal) : size(0U) {
+            bool ok = add(irSignal.getIntro()) && add(irSignal.getRepeat()) && add(irSignal.getEnding());
+            if (!ok)
+                size = 0U;
+            bits = bitsPerIndex(size);
+        }
+
+        uint8_t indexOf(microseconds_t duration) const {
+            uint8_t i = 0U;
+            while (values[i] != duration)
+                i++;
+            return i;
+        }
+
+    private:
+        bool add(const IrSequence& irSequence) {
+            for (size_t i = 0U; i < irSequence.getLength(); i++) {
+                microseconds_t duration = irSequence.getDurations()[i];
+                uint8_t j = 0U;
+                while (j < size && values[j] != duration)
+                    j++;
+                if (j == size) {
+                    if (size == maxDictionary)
+                        return false;
+                    values[size++] = duration;
+                }
+            }
+            return true;
+        }
+    };
+
+    // Writes into the storage, or, if dryRun, only counts the bytes and compares them with the stored ones.
+    class Writer {
+    public:
+        Writer(Storage& storage_, size_t address_, size_t capacity_, bool dryRun_)
+        : storage(storage_), address(address_), capacity(capacity_), count(0U), dryRun(dryRun_), changed(false), bitBuffer(0U), bitCount(0U) {}
+
+        void putByte(uint8_t value) {
+            if (count < capacity) {
+                if (dryRun)
+                    changed = changed || storage.read(address + count) != value;
+                else
+                    storage.update(address + count, value);
+            }
+            count++;
+        }
+
+        void putVarint(uint32_t value) {
+            while (value >= 0x80UL) {
+                putByte((uint8_t) (value | 0x80U));
+                value >>= 7U;
+            }
+            putByte((uint8_t) value);
+        }
+
+        void putBits(uint8_t value, uint8_t bits) {
+            bitBuffer |= (uint8_t) (value << bitCount);
+            bitCount = (uint8_t) (bitCount + bits);
+            if (bitCount == 8U)
+                flushBits();
+        }
+
+        void flushBits() {
+            if (bitCount > 0U)
+                putByte(bitBuffer);
+            bitBuffer = 0U;
+            bitCount = 0U;
+        }
+
+        size_t getCount() const {
+            return count;
+        }
+
+        bool isChanged() const {
+            return changed;
+        }
+
+    private:
+        Storage& storage;
+        size_t address;
+        size_t capacity;
+        size_t count;
+        bool dryRun;
+        bool changed;
+        uint8_t bitBuffer;
+        uint8_t bitCount;
+    };
+
+    class Reader {
+    public:
+        Reader(const Storage& storage_, size_t address_) : storage(storage_), address(address_), bitBuffer(0U), bitCount(0U) {}
+
+        uint8_t getByte() {
+            return storage.read(address++);
+        }
+
+        uint32_t getVarint() {
+            uint32_t value = 0UL;
+            uint8_t byte;
+            uint8_t shift = 0U;
+            do {
+                byte = getByte();
+                value |= (uint32_t) (byte & 0x7FU) << shift;
+                shift = (uint8_t) (shift + 7U);
+            } while ((byte & 0x80U) && shift < 35U);
+            return value;
+        }
+
+        uint8_t getBits(uint8_t bits) {
+            if (bitCount == 0U) {
+                bitBuffer = getByte();
+                bitCount = 8U;
+            }
+            uint8_t value = (uint8_t) (bitBuffer & ((1U << bits) - 1U));
+            bitBuffer = (uint8_t) (bitBuffer >> bits);
+            bitCount = (uint8_t) (bitCount - bits);
+            return value;
+        }
+
+        void alignBits() {
+            bitCount = 0U;
+        }
+
+    private:
+        const Storage& storage;
+        size_t address;
+        uint8_t bitBuffer;
+        uint8_t bitCount;
+    };
+
+    size_t slotAddress(uint8_t slot) const {
+        return headerSize + (size_t) slot * slotSize;
+    }
+
+    static uint8_t bitsPerIndex(uint8_t size) {
+        return size == 0U ? 0U : size <= 2U ? 1U : size <= 4U ? 2U : 4U;
+    }
+
+    static uint8_t nameHash(const char *name) {
+        uint8_t hash = 0x81U;
+        for (uint8_t i = 0U; i < nameLength && name[i] != '\0'; i++)
+            hash = (uint8_t) ((hash ^ (uint8_t) name[i]) * 31U);
+        return hash;
+    }
+
+    bool nameEquals(size_t address, const char *name) const {
+        for (uint8_t i = 0U; i < nameLength; i++) {
+            char c = (char) storage.read(address + nameOffset + i);
+            if (c != name[i])
+                return false;
+            if (c == '\0')
+                return true;
+        }
+        return true;
+    }
+
+    static void encodeSequence(Writer& writer, const IrSequence& irSequence, const Dictionary& dictionary) {
+        for (size_t i = 0U; i < irSequence.getLength(); i++) {
+            if (dictionary.bits > 0U)
+                writer.putBits(dictionary.indexOf(irSequence.getDurations()[i]), dictionary.bits);
+            else
+                writer.putVarint(irSequence.getDurations()[i]);
+        }
+        writer.flushBits();
+    }
+
+    static void encode(Writer& writer, const IrSignal& irSignal, const Dictionary& dictionary) {
+        writer.putVarint(irSignal.getFrequency());
+        writer.putByte((uint8_t) irSignal.getDutyCycle());
+        writer.putVarint(irSignal.getIntro().getLength());
+        writer.putVarint(irSignal.getRepeat().getLength());
+        writer.putVarint(irSignal.getEnding().getLength());
+        writer.putByte(dictionary.size);
+        for (uint8_t i = 0U; i < dictionary.size; i++)
+            writer.putVarint(dictionary.values[i]);
+        encodeSequence(writer, irSignal.getIntro(), dictionary);
+        encodeSequence(writer, irSignal.getRepeat(), dictionary);
+        encodeSequence(writer, irSignal.getEnding(), dictionary);
+    }
+
+    static microseconds_t *readDurations(Reader& reader, const Dictionary& dictionary, size_t length) {
+        microseconds_t *durations = new microseconds_t[length];
+        for (size_t i = 0U; i < length; i++) {
+            if (dictionary.bits > 0U) {
+                uint8_t index = reader.getBits(dictionary.bits);
+                durations[i] = index < dictionary.size ? dictionary.values[index] : 0U;
+            } else
+                durations[i] = (microseconds_t) reader.getVarint();
+        }
+        reader.alignBits();
+        return durations;
+    }
+};
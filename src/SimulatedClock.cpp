@@ -0,0 +1,69 @@
+#ifndef ARDUINO
+
+#include "SimulatedClock.h"
+#include <algorithm>
+
+uint64_t SimulatedClock::currentTime = 0U;
+uint64_t SimulatedClock::eventCount = 0U;
+SimulatedClock::event_t SimulatedClock::lastId = noEvent;
+bool SimulatedClock::interruptsEnabled = true;
+bool SimulatedClock::inCallback = false;
+uint64_t SimulatedClock::lastSequence = 0U;
+std::vector<SimulatedClock::Event> SimulatedClock::events;
+
+void SimulatedClock::push(const Event& event) {
+    events.push_back(event);
+    events.back().sequence = ++lastSequence;
+    std::push_heap(events.begin(), events.end());
+}
+
+SimulatedClock::event_t SimulatedClock::schedule(uint64_t time, callback_t callback, void *argument, uint32_t period) {
+    Event event;
+    event.time = time;
+    event.id = ++lastId;
+    event.period = period;
+    event.callback = callback;
+    event.argument = argument;
+    push(event);
+    return event.id;
+}
+
+bool SimulatedClock::cancel(event_t id) {
+    for (std::vector<Event>::iterator it = events.begin(); it != events.end(); it++) {
+        if (it->id == id) {
+            events.erase(it);
+            std::make_heap(events.begin(), events.end());
+            return true;
+        }
+    }
+    return false;
+}
+
+void SimulatedClock::cancelAll() {
+    events.clear();
+}
+
+void SimulatedClock::advanceTo(uint64_t time) {
+    while (interruptsEnabled && !inCallback && !events.empty() && events.front().time <= time) {
+        std::pop_heap(events.begin(), events.end());
+        Event event = events.back();
+        events.pop_back();
+        uint64_t eventTime = event.time;
+        if (eventTime > currentTime)
+            currentTime = eventTime;
+        if (event.period > 0U) {
+            event.time = eventTime + event.period;
+            if (event.time <= currentTime) // delayed, do not catch up
+                event.time = currentTime + event.period - (currentTime - eventTime) % event.period;
+            push(event);
+        }
+        inCallback = true;
+        event.callback(event.argument);
+        inCallback = false;
+        eventCount++;
+    }
+    if (time > currentTime)
+        currentTime = time;
+}
+
+#endif // ! ARDUINO
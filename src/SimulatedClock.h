@@ -0,0 +1,125 @@
+/*
+Copyright (C) 2020 Bengt Martensson.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see http://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#ifndef ARDUINO
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+/**
+ * Discrete-event simulated clock of the host SIL, in microseconds, starting at 0.
+ * micros(), millis(), delay(), delayMicroseconds(), and yield() of the host Arduino.h use it,
+ * unless REAL_TIME is defined; time only passes when advanced by these.
+ *
+ * Events are callbacks scheduled at a time, possibly repeated with a period,
+ * for example a timer interrupt (see NoBoard) or a pin change (see SIL::inject).
+ * Advancing the clock runs the due events in time order, with the clock set to their time.
+ * Like on the hardware, events are not run while "interrupts" are disabled (noInterrupts()),
+ * nor from within an event; they are run when interrupts are enabled again.
+ * A periodic event that is delayed runs once, then continues with its period.
+ */
+class SimulatedClock {
+public:
+    typedef void (*callback_t)(void *argument);
+    typedef uint32_t event_t;
+
+    static const event_t noEvent = 0U;
+
+    static uint64_t now() {
+        return currentTime;
+    }
+
+    /**
+     * Schedules a callback.
+     * @param time time of the (first) call; if in the past, it is called at the next advance
+     * @param callback function to call
+     * @param argument argument to callback
+     * @param period if not 0, the callback is repeated with this period
+     * @return id, for cancel
+     */
+    static event_t schedule(uint64_t time, callback_t callback, void *argument = NULL, uint32_t period = 0U);
+
+    /**
+     * Removes a scheduled callback.
+     * @param event id from schedule, or noEvent
+     * @return true if it was scheduled
+     */
+    static bool cancel(event_t event);
+
+    /** Removes all scheduled callbacks. */
+    static void cancelAll();
+
+    /** @return number of scheduled callbacks */
+    static size_t pending() {
+        return events.size();
+    }
+
+    /** Advances the clock, running the callbacks due. */
+    static void advance(uint64_t microseconds) {
+        advanceTo(currentTime + microseconds);
+    }
+
+    /** Advances the clock to time, if later than now, running the callbacks due. */
+    static void advanceTo(uint64_t time);
+
+    static void disableInterrupts() {
+        interruptsEnabled = false;
+    }
+
+    /** Enables interrupts, and runs the callbacks that were deferred. */
+    static void enableInterrupts() {
+        interruptsEnabled = true;
+        advanceTo(currentTime);
+    }
+
+    /** @return number of callbacks run so far */
+    static uint64_t getEventCount() {
+        return eventCount;
+    }
+
+private:
+    SimulatedClock();
+
+    struct Event {
+        uint64_t time;
+        uint64_t sequence; // events at the same time run in the order scheduled
+        event_t id;
+        uint32_t period;
+        callback_t callback;
+        void *argument;
+
+        // Ordering for the heap: the top is the earliest event.
+        bool operator<(const Event& other) const {
+            return time != other.time ? time > other.time : sequence > other.sequence;
+        }
+    };
+
+    static uint64_t currentTime;
+    static uint64_t eventCount;
+    static event_t lastId;
+    static uint64_t lastSequence;
+    static bool interruptsEnabled;
+    static bool inCallback;
+    static std::vector<Event> events; // heap
+
+    static void push(const Event& event);
+};
+
+#endif // ! ARDUINO
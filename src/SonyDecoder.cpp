@@ -0,0 +1,17 @@
+#include "SonyDecoder.h"
+
+SonyDecoder::SonyDecoder(const IrReader& irReader) : IrDecoder() {
+    decodeDurations(irReader);
+}
+
+bool SonyDecoder::tryDecode(const IrReader& irReader, Stream& stream) {
+    SonyDecoder decoder(irReader);
+    return decoder.printDecode(stream);
+}
+
+void SonyDecoder::formatDecode() {
+    if (bits == 20U)
+        sprintf(decode, "Sony20 %d %d %d", D, S, F);
+    else
+        sprintf(decode, "Sony%u %d %d", bits, D, F);
+}
@@ -0,0 +1,187 @@
+/*
+Copyright (C) 2020 Bengt Martensson.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see http://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include "IrDecoder.h"
+#include "IrReader.h"
+#include <stdio.h>
+
+/**
+ * A decoder class for the Sony protocols with 12, 15, and 20 bits, given in IRP notation as
+ * {40k,600}<1,-1|2,-1>(4,-1,F:7,D:5,^45m)*,
+ * {40k,600}<1,-1|2,-1>(4,-1,F:7,D:8,^45m)*, and
+ * {40k,600}<1,-1|2,-1>(4,-1,F:7,D:5,S:8,^45m)* respectively.
+ *
+ * The variant is determined by the number of durations alone,
+ * so isSonyLength() can be used as a cheap test before trying the decoder.
+ */
+class SonyDecoder : public IrDecoder {
+public:
+    /**
+     * Returns true if a sequence of this many durations can be a Sony signal.
+     * @param length number of durations
+     * @return true if 26, 32, or 42
+     */
+    static bool isSonyLength(size_t length) {
+        return length == lengthOf(12U) || length == lengthOf(15U) || length == lengthOf(20U);
+    }
+
+    /**
+     * Constructs a SonyDecoder from an IrReader, containing data.
+     * @param irReader IrReader with data, i.e. with isReady() true.
+     */
+    SonyDecoder(const IrReader& irReader);
+
+    /**
+     * Constructs a SonyDecoder from a reader of known type, containing data.
+     * Since the type of the reader is known to the compiler, the calls
+     * to getDuration() are not virtual, and can be inlined.
+     * @param irReader IrReader subclass with data, i.e. with isReady() true.
+     */
+    template<class Reader>
+    SonyDecoder(const Reader& irReader) : IrDecoder() {
+        decodeDurations(irReader);
+    }
+
+    virtual ~SonyDecoder() {
+    }
+
+    /**
+     * Returns the number of bits, 12, 15, or 20, or 0 if invalid.
+     * @return bits
+     */
+    unsigned int getBits() const {
+        return bits;
+    }
+
+    /**
+     * Returns the F parameter, or -1 if invalid.
+     * @return int
+     */
+    int getF() const {
+        return F;
+    }
+
+    /**
+     * Returns the D parameter, or -1 if invalid.
+     * @return int
+     */
+    int getD() const {
+        return D;
+    }
+
+    /**
+     * Returns the S parameter, or -1 if invalid or not Sony20.
+     * @return int
+     */
+    int getS() const {
+        return S;
+    }
+
+    /**
+     * Convenience function; constructs a SonyDecoder and calls its printDecode.
+     * @param irReader IrReader to use
+     * @param stream Stream
+     * @return success of operation
+     */
+    static bool tryDecode(const IrReader& irReader, Stream& stream);
+
+    const char *getDecode() const {
+        return decode;
+    }
+
+private:
+    static const microseconds_t timebaseLower = 450U;
+    static const microseconds_t timebaseUpper = 750U;
+    /** Shortest final gap; the frame is 45ms, so the gap of Sony20 with all ones is 6.6ms. */
+    static const microseconds_t endingMin = 6000U;
+
+    int F;
+    int D;
+    int S;
+    unsigned int bits;
+    char decode[20];
+
+    static constexpr size_t lengthOf(unsigned int bits) {
+        return 2U * (bits + 1U);
+    }
+
+    static bool getDuration(microseconds_t duration, unsigned int time) {
+        return duration <= time * timebaseUpper
+                && duration >= time * timebaseLower;
+    }
+
+    template<class Reader>
+    static int decodeParameter(const Reader& irReader, unsigned int& index, unsigned int width, size_t length);
+
+    template<class Reader>
+    void decodeDurations(const Reader& irReader);
+
+    void formatDecode();
+};
+
+// The gap of a bit is the first duration of the next bit, or the ending.
+template<class Reader>
+int SonyDecoder::decodeParameter(const Reader& irReader, unsigned int& index, unsigned int width, size_t length) {
+    unsigned int sum = 0U;
+    for (unsigned int i = 0U; i < width; i++) {
+        microseconds_t flash = irReader.getDuration(index++);
+        if (index < length - 1U && !getDuration(irReader.getDuration(index), 1U))
+            return invalid;
+        index++;
+        if (getDuration(flash, 2U))
+            sum |= 1U << i;
+        else if (!getDuration(flash, 1U))
+            return invalid;
+    }
+    return (int) sum;
+}
+
+template<class Reader>
+void SonyDecoder::decodeDurations(const Reader& irReader) {
+    F = invalid;
+    D = invalid;
+    S = invalid;
+    bits = 0U;
+    decode[0] = '\0';
+    size_t length = irReader.getDataLength();
+    if (!isSonyLength(length))
+        return;
+    if (!getDuration(irReader.getDuration(0U), 4U) || !getDuration(irReader.getDuration(1U), 1U))
+        return;
+    if (irReader.getDuration(length - 1U) < endingMin)
+        return;
+
+    unsigned int index = 2U;
+    int f = decodeParameter(irReader, index, 7U, length);
+    if (f == invalid)
+        return;
+    int d = decodeParameter(irReader, index, length == lengthOf(15U) ? 8U : 5U, length);
+    if (d == invalid)
+        return;
+    if (length == lengthOf(20U)) {
+        S = decodeParameter(irReader, index, 8U, length);
+        if (S == invalid)
+            return;
+    }
+    F = f;
+    D = d;
+    bits = length / 2U - 1U;
+    setValid(true);
+    formatDecode();
+}
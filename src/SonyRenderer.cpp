@@ -0,0 +1,39 @@
+#include "SonyRenderer.h"
+#include "HeapStatistics.h"
+
+size_t SonyRenderer::render(microseconds_t *durations, unsigned int bits, unsigned int D, unsigned int S, unsigned int F) {
+    if (bits != 12U && bits != 15U && bits != 20U)
+        return 0U;
+    unsigned int i = 0U;
+    uint32_t sum = 5U * timebase;
+    durations[i] = 4U * timebase; i++;
+    durations[i] = timebase; i++;
+    lsb(durations, i, sum, F, 7U);
+    lsb(durations, i, sum, D, bits == 15U ? 8U : 5U);
+    if (bits == 20U)
+        lsb(durations, i, sum, S, 8U);
+    // The gap of the last bit is the ending.
+    durations[i - 1U] = (microseconds_t) (extent - (sum - timebase));
+    return i;
+}
+
+const IrSignal *SonyRenderer::newIrSignal(unsigned int bits, unsigned int D, unsigned int S, unsigned int F) {
+    HeapStatistics::Scope scope(HeapStatistics::renderers);
+    microseconds_t *repeat = new microseconds_t[maxLength];
+    size_t length = render(repeat, bits, D, S, F);
+    if (length == 0U) {
+        delete [] repeat;
+        return NULL;
+    }
+    return new IrSignal(NULL, 0U, repeat, length, NULL, 0U, frequency, IrSignal::noDutyCycle, true);
+}
+
+void SonyRenderer::lsb(microseconds_t *durations, unsigned int& i, uint32_t& sum, unsigned int x, unsigned int width) {
+    for (unsigned int index = 0U; index < width; index++) {
+        microseconds_t flash = (x & 1U) ? 2U * timebase : timebase;
+        durations[i] = flash; i++;
+        durations[i] = timebase; i++;
+        sum += flash + timebase;
+        x >>= 1U;
+    }
+}
@@ -0,0 +1,76 @@
+/*
+Copyright (C) 2020 Bengt Martensson.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see http://www.gnu.org/licenses/.
+*/
+
+#pragma once
+
+#include <IrSignal.h>
+
+/**
+ * A static class generating the Sony protocols with 12, 15, and 20 bits, given in IRP notation as
+ * {40k,600}<1,-1|2,-1>(4,-1,F:7,D:5,^45m)*,
+ * {40k,600}<1,-1|2,-1>(4,-1,F:7,D:8,^45m)*, and
+ * {40k,600}<1,-1|2,-1>(4,-1,F:7,D:5,S:8,^45m)* respectively.
+ * The frame is the repeat sequence; the intro is empty.
+ *
+ * render() fills a buffer supplied by the caller, and does not allocate.
+ */
+class SonyRenderer {
+public:
+    static const frequency_t frequency = 40000U;
+
+    /** Number of durations of a Sony20 frame, the longest. */
+    static const size_t maxLength = 42U;
+
+    /**
+     * Renders a frame into the buffer.
+     * @param durations buffer of at least 2*(bits+1) (at most maxLength) durations
+     * @param bits 12, 15, or 20
+     * @param D Sony parameter, "device"
+     * @param S Sony parameter, "subdevice"; ignored unless bits is 20
+     * @param F Sony parameter, "function"
+     * @return number of durations, 0 if bits is not supported
+     */
+    static size_t render(microseconds_t *durations, unsigned int bits, unsigned int D, unsigned int S, unsigned int F);
+
+    /**
+     * Generates an IrSignal from the Sony parameters.
+     * Must be deleted explicitly by the user to avoid memory leaks.
+     * @param bits 12, 15, or 20
+     * @param D Sony parameter, "device"
+     * @param S Sony parameter, "subdevice"; ignored unless bits is 20
+     * @param F Sony parameter, "function"
+     * @return IrSignal, or NULL if bits is not supported
+     */
+    static const IrSignal *newIrSignal(unsigned int bits, unsigned int D, unsigned int S, unsigned int F);
+
+    /**
+     * Generates a Sony12 or Sony15 IrSignal. Equivalent to newIrSignal(bits, D, 0, F).
+     * @param bits 12 or 15
+     * @param D Sony parameter, "device"
+     * @param F Sony parameter, "function"
+     * @return IrSignal, or NULL if bits is not supported
+     */
+    static const IrSignal *newIrSignal(unsigned int bits, unsigned int D, unsigned int F) {
+        return newIrSignal(bits, D, 0U, F);
+    }
+
+private:
+    SonyRenderer();
+    static const microseconds_t timebase = 600U;
+    static const uint32_t extent = 45000UL;
+    static void lsb(microseconds_t *durations, unsigned int& i, uint32_t& sum, unsigned int x, unsigned int width);
+};
@@ -27,12 +27,38 @@ this program. If not, see http://www.gnu.org/licenses/.
 
 #define CURRENT_CLASS ATmega2560
 
-class ATmega2560 : public Board {
+#define HAS_FAST_PIN        1
+
+class ATmega2560 final : public Board {
+    friend class Board;
+
 public:
 
     ATmega2560() {
     };
 
+    // The sampler ISR takes some 10 to 15 microseconds at 16 MHz; shorter periods starve the sketch.
+    static const unsigned long minMicrosPerTick = 25UL;
+
+    // Pin to port mapping through the tables of the Arduino core.
+    // Considerably faster than digitalRead/digitalWrite, but not resolved at compile time.
+
+    static inline uint8_t pinBitMask(pin_t pin) {
+        return digitalPinToBitMask(pin);
+    }
+
+    static inline volatile uint8_t& pinOutputRegister(pin_t pin) {
+        return *portOutputRegister(digitalPinToPort(pin));
+    }
+
+    static inline volatile uint8_t& pinInputRegister(pin_t pin) {
+        return *portInputRegister(digitalPinToPort(pin));
+    }
+
+    static inline volatile uint8_t& pinModeRegister(pin_t pin) {
+        return *portModeRegister(digitalPinToPort(pin));
+    }
+
 private:
 ///////////////////////////////////////////////////////////////////////////////
 #if defined(IR_USE_TIMER1)
@@ -55,6 +81,10 @@ private:
         TIMSK1 = 0;
     };
 
+    uint16_t timerCount() {
+        return TCNT1;
+    };
+
 
 
     void timerConfigHz(frequency_t frequency, dutycycle_t dutyCycle) {
@@ -68,10 +98,24 @@ private:
     void timerConfigNormal() {
         TCCR1A = 0;
         TCCR1B = _BV(WGM12) | _BV(CS10);
-        OCR1A = F_CPU * microsPerTick / 1000000;
+        OCR1A = F_CPU * microsPerTick / 1000000UL - 1U; // the period is OCR1A + 1 clocks
         TCNT1 = 0;
     };
 
+    uint16_t timerConfigPeriodic(frequency_t hz) {
+        if (F_CPU / hz == 0U || F_CPU / hz > 65536UL)
+            return 0U;
+        TCCR1A = 0U;
+        TCCR1B = _BV(WGM12) | _BV(CS10);
+        OCR1A = (uint16_t) (F_CPU / hz - 1U);
+        TCNT1 = 0U;
+        return (uint16_t) (F_CPU / hz);
+    };
+
+    void timerSetTop(uint16_t top) {
+        OCR1A = top;
+    };
+
 #define PWM_PIN 11
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -96,6 +140,10 @@ private:
         TIMSK2 = 0;
     }
 
+    uint16_t timerCount() {
+        return TCNT2;
+    }
+
     void timerConfigHz(frequency_t frequency, dutycycle_t dutyCycle) {
         const uint8_t pwmval = F_CPU / 2 / frequency;
         TCCR2A = _BV(WGM20);
@@ -115,11 +163,31 @@ private:
         //#else
         TCCR2A = _BV(WGM21);
         TCCR2B = _BV(CS21);
-        OCR2A = TIMER_COUNT_TOP / 8;
+        OCR2A = TIMER_COUNT_TOP / 8U - 1U;
         TCNT2 = 0;
         //#endif
     };
 
+    uint16_t timerConfigPeriodic(frequency_t hz) {
+        if (F_CPU / hz == 0U || F_CPU / 8U / hz > 256U)
+            return 0U;
+        TCCR2A = _BV(WGM21);
+        if (F_CPU / hz <= 256U) {
+            TCCR2B = _BV(CS20);
+            OCR2A = (uint8_t) (F_CPU / hz - 1U);
+            TCNT2 = 0U;
+            return (uint16_t) (F_CPU / hz);
+        }
+        TCCR2B = _BV(CS21);
+        OCR2A = (uint8_t) (F_CPU / 8U / hz - 1U);
+        TCNT2 = 0U;
+        return (uint16_t) (F_CPU / 8U / hz);
+    }
+
+    void timerSetTop(uint16_t top) {
+        OCR2A = (uint8_t) top;
+    }
+
 #define PWM_PIN  9
 
 //////////////////////////////////////////////////////////////////////////////
@@ -143,6 +211,10 @@ private:
         TIMSK3 = 0;
     };
 
+    uint16_t timerCount() {
+        return TCNT3;
+    };
+
     void timerConfigHz(frequency_t frequency, dutycycle_t dutyCycle) {
         const uint16_t pwmval = F_CPU / 2 / frequency;
         TCCR3A = _BV(WGM31);
@@ -154,10 +226,24 @@ private:
     void timerConfigNormal() {
         TCCR3A = 0;
         TCCR3B = _BV(WGM32) | _BV(CS30);
-        OCR3A = F_CPU * microsPerTick / 1000000;
+        OCR3A = F_CPU * microsPerTick / 1000000UL - 1U; // the period is OCR3A + 1 clocks
         TCNT3 = 0;
     };
 
+    uint16_t timerConfigPeriodic(frequency_t hz) {
+        if (F_CPU / hz == 0U || F_CPU / hz > 65536UL)
+            return 0U;
+        TCCR3A = 0U;
+        TCCR3B = _BV(WGM32) | _BV(CS30);
+        OCR3A = (uint16_t) (F_CPU / hz - 1U);
+        TCNT3 = 0U;
+        return (uint16_t) (F_CPU / hz);
+    };
+
+    void timerSetTop(uint16_t top) {
+        OCR3A = top;
+    };
+
 #define PWM_PIN 5
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -181,6 +267,10 @@ private:
         TIMSK4 = 0;
     };
 
+    uint16_t timerCount() {
+        return TCNT4;
+    };
+
     void timerConfigHz(frequency_t frequency, dutycycle_t dutyCycle) {
         const uint16_t pwmval = F_CPU / 2 / frequency;
         TCCR4A = _BV(WGM41);
@@ -192,10 +282,24 @@ private:
     void timerConfigNormal() {
         TCCR4A = 0;
         TCCR4B = _BV(WGM42) | _BV(CS40);
-        OCR4A = F_CPU * microsPerTick / 1000000;
+        OCR4A = F_CPU * microsPerTick / 1000000UL - 1U; // the period is OCR4A + 1 clocks
         TCNT4 = 0;
     };
 
+    uint16_t timerConfigPeriodic(frequency_t hz) {
+        if (F_CPU / hz == 0U || F_CPU / hz > 65536UL)
+            return 0U;
+        TCCR4A = 0U;
+        TCCR4B = _BV(WGM42) | _BV(CS40);
+        OCR4A = (uint16_t) (F_CPU / hz - 1U);
+        TCNT4 = 0U;
+        return (uint16_t) (F_CPU / hz);
+    };
+
+    void timerSetTop(uint16_t top) {
+        OCR4A = top;
+    };
+
 #define PWM_PIN 6
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -219,6 +323,10 @@ private:
         TIMSK5 = 0;
     };
 
+    uint16_t timerCount() {
+        return TCNT5;
+    };
+
     void timerConfigHz(frequency_t frequency, dutycycle_t dutyCycle) {
         const uint16_t pwmval = F_CPU / 2 / frequency;
         TCCR5A = _BV(WGM51);
@@ -230,10 +338,24 @@ private:
     void timerConfigNormal() {
         TCCR5A = 0;
         TCCR5B = _BV(WGM52) | _BV(CS50);
-        OCR5A = F_CPU * microsPerTick / 1000000;
+        OCR5A = F_CPU * microsPerTick / 1000000UL - 1U; // the period is OCR5A + 1 clocks
         TCNT5 = 0;
     };
 
+    uint16_t timerConfigPeriodic(frequency_t hz) {
+        if (F_CPU / hz == 0U || F_CPU / hz > 65536UL)
+            return 0U;
+        TCCR5A = 0U;
+        TCCR5B = _BV(WGM52) | _BV(CS50);
+        OCR5A = (uint16_t) (F_CPU / hz - 1U);
+        TCNT5 = 0U;
+        return (uint16_t) (F_CPU / hz);
+    };
+
+    void timerSetTop(uint16_t top) {
+        OCR5A = top;
+    };
+
 #define PWM_PIN 46
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -28,9 +28,41 @@ this program. If not, see http://www.gnu.org/licenses/.
 
 #define CURRENT_CLASS ATmega328P
 
-class ATmega328P : public Board {
+#define HAS_FAST_PIN        1
+
+class ATmega328P final : public Board {
+    friend class Board;
+
 public:
 
+    // The sampler ISR takes some 10 to 15 microseconds at 16 MHz; shorter periods starve the sketch.
+    static const unsigned long minMicrosPerTick = 25UL;
+
+    // Pin to port mapping of the Uno/Nano; D0-D7 = PD0-PD7, D8-D13 = PB0-PB5,
+    // A0-A5 = D14-D19 = PC0-PC5. Written so that the compiler can resolve
+    // it at compile time for a constant pin, see FastPin.h.
+    // Other pins, like the analog only A6 and A7 of the Nano, get an empty mask,
+    // so that they read as low and ignore writes.
+
+    static const pin_t noFastPins = 20U;
+
+    static constexpr uint8_t pinBitMask(pin_t pin) {
+        return pin >= noFastPins ? 0U
+                : (uint8_t) (1U << (pin < 8U ? pin : pin < 14U ? pin - 8U : pin - 14U));
+    }
+
+    static inline volatile uint8_t& pinOutputRegister(pin_t pin) {
+        return pin < 8U ? PORTD : pin < 14U ? PORTB : PORTC;
+    }
+
+    static inline volatile uint8_t& pinInputRegister(pin_t pin) {
+        return pin < 8U ? PIND : pin < 14U ? PINB : PINC;
+    }
+
+    static inline volatile uint8_t& pinModeRegister(pin_t pin) {
+        return pin < 8U ? DDRD : pin < 14U ? DDRB : DDRC;
+    }
+
 /////////////////////////////////////////////////////////////
 #ifdef IR_USE_TIMER1
 
@@ -50,6 +82,10 @@ public:
         TIMSK1 = 0U;
     };
 
+    uint16_t timerCount() {
+        return TCNT1;
+    };
+
 #define TIMER_INTR_NAME       TIMER1_COMPA_vect
 
     void timerConfigHz(frequency_t val, dutycycle_t dutyCycle) {
@@ -63,10 +99,24 @@ public:
     void timerConfigNormal() {
         TCCR1A = 0U;
         TCCR1B = _BV(WGM12) | _BV(CS10);
-        OCR1A = F_CPU * microsPerTick / 1000000UL;
+        OCR1A = F_CPU * microsPerTick / 1000000UL - 1U; // the period is OCR1A + 1 clocks
         TCNT1 = 0U;
     };
 
+    uint16_t timerConfigPeriodic(frequency_t hz) {
+        if (F_CPU / hz == 0U || F_CPU / hz > 65536UL)
+            return 0U;
+        TCCR1A = 0U;
+        TCCR1B = _BV(WGM12) | _BV(CS10);
+        OCR1A = (uint16_t) (F_CPU / hz - 1U);
+        TCNT1 = 0U;
+        return (uint16_t) (F_CPU / hz);
+    };
+
+    void timerSetTop(uint16_t top) {
+        OCR1A = top;
+    };
+
 #define PWM_PIN  9
     //////////////////////////////////////////////////////////////////////////
 #elif defined(IR_USE_TIMER2) || defined(DOXYGEN) // ! defined(IR_USE_TIMER1)
@@ -87,6 +137,10 @@ public:
         TIMSK2 = 0U;
     };
 
+    uint16_t timerCount() {
+        return TCNT2;
+    };
+
 #define TIMER_INTR_NAME     TIMER2_COMPA_vect
 
     void timerConfigHz(frequency_t val, dutycycle_t dutyCycle) {
@@ -100,9 +154,29 @@ public:
     void timerConfigNormal() {
         TCCR2A = _BV(WGM21);
         TCCR2B = _BV(CS21);
-        OCR2A = F_CPU * microsPerTick / 1000000UL / 8U;
+        OCR2A = F_CPU / 8U * microsPerTick / 1000000UL - 1U; // the period is OCR2A + 1 clocks
         TCNT2 = 0U;
     }
+
+    uint16_t timerConfigPeriodic(frequency_t hz) {
+        if (F_CPU / hz == 0U || F_CPU / 8U / hz > 256U)
+            return 0U;
+        TCCR2A = _BV(WGM21);
+        if (F_CPU / hz <= 256U) {
+            TCCR2B = _BV(CS20);
+            OCR2A = (uint8_t) (F_CPU / hz - 1U);
+            TCNT2 = 0U;
+            return (uint16_t) (F_CPU / hz);
+        }
+        TCCR2B = _BV(CS21);
+        OCR2A = (uint8_t) (F_CPU / 8U / hz - 1U);
+        TCNT2 = 0U;
+        return (uint16_t) (F_CPU / 8U / hz);
+    }
+
+    void timerSetTop(uint16_t top) {
+        OCR2A = (uint8_t) top;
+    }
 /////////////////////////////////////////////////////////////////////////
 
 #define PWM_PIN  3
@@ -32,10 +32,36 @@ this program. If not, see http://www.gnu.org/licenses/.
 
 #define CURRENT_CLASS ATmega32U4
 
-class ATmega32U4 : public Board {
+#define HAS_FAST_PIN        1
+
+class ATmega32U4 final : public Board {
+    friend class Board;
+
 public:
     ATmega32U4() {};
 
+    // The sampler ISR takes some 10 to 15 microseconds at 16 MHz; shorter periods starve the sketch.
+    static const unsigned long minMicrosPerTick = 25UL;
+
+    // Pin to port mapping through the tables of the Arduino core.
+    // Considerably faster than digitalRead/digitalWrite, but not resolved at compile time.
+
+    static inline uint8_t pinBitMask(pin_t pin) {
+        return digitalPinToBitMask(pin);
+    }
+
+    static inline volatile uint8_t& pinOutputRegister(pin_t pin) {
+        return *portOutputRegister(digitalPinToPort(pin));
+    }
+
+    static inline volatile uint8_t& pinInputRegister(pin_t pin) {
+        return *portInputRegister(digitalPinToPort(pin));
+    }
+
+    static inline volatile uint8_t& pinModeRegister(pin_t pin) {
+        return *portModeRegister(digitalPinToPort(pin));
+    }
+
 private:
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -59,6 +85,10 @@ private:
         TIMSK1 = 0U;
     };
 
+    uint16_t timerCount() {
+        return TCNT1;
+    };
+
     void timerConfigHz(frequency_t frequency, dutycycle_t dutyCycle) {
         const uint16_t pwmval = F_CPU / 2UL / frequency;
         TCCR1A = _BV(WGM11);
@@ -70,8 +100,22 @@ private:
     void timerConfigNormal() {
         TCCR1A = 0;
         TCCR1B = _BV(WGM12) | _BV(CS10);
-        OCR1A = F_CPU * microsPerTick / 1000000UL;
+        OCR1A = F_CPU * microsPerTick / 1000000UL - 1U; // the period is OCR1A + 1 clocks
+        TCNT1 = 0U;
+    };
+
+    uint16_t timerConfigPeriodic(frequency_t hz) {
+        if (F_CPU / hz == 0U || F_CPU / hz > 65536UL)
+            return 0U;
+        TCCR1A = 0U;
+        TCCR1B = _BV(WGM12) | _BV(CS10);
+        OCR1A = (uint16_t) (F_CPU / hz - 1U);
         TCNT1 = 0U;
+        return (uint16_t) (F_CPU / hz);
+    };
+
+    void timerSetTop(uint16_t top) {
+        OCR1A = top;
     };
 
 #define PWM_PIN  9
@@ -100,7 +144,7 @@ void timerConfigHz(frequency_t frequency, dutycycle_t dutyCycle) {
 void timerConfigNormal() {
     TCCR2A = _BV(WGM21);
     TCCR2B = _BV(CS21);
-    OCR2A  = TIMER_COUNT_TOP / 8U;
+    OCR2A  = TIMER_COUNT_TOP / 8U - 1U;
     TCNT2  = 0U;
 };
 
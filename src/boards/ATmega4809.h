@@ -35,21 +35,29 @@ this program. If not, see http://www.gnu.org/licenses/.
 #define HAS_HARDWARE_PWM    1
 #define HAS_SAMPLING        1
 #define HAS_INPUT_CAPTURE   0
+#define HAS_FAST_PIN        0
+#define HAS_EEPROM          1
+#define HAS_CARRIER_TIMER   1
 
 #define STRCPY_PF_CAST(x) (x)
 
-class ATmega4809 : public Board {
+class ATmega4809 final : public Board {
+    friend class Board;
+
 public:
     ATmega4809() {
     };
 
+    // The sampler ISR takes some 10 to 15 microseconds at 16 MHz; shorter periods starve the sketch.
+    static const unsigned long minMicrosPerTick = 25UL;
+
 private:
 
 #ifdef IR_USE_TIMER1
 ///////////////////////////////////////////////////////////////////////////////
 #define TIMER_INTR_NAME      TCB0_INT_vect
 
-    void timerReset() {
+    void timerAcknowledgeIntr() {
         TCB0.INTFLAGS = TCB_CAPT_bm;
     };
     //#define TIMER_ENABLE_PWM     (TCB0.CTRLB = TCB_CNTMODE_PWM8_gc)
@@ -81,11 +89,25 @@ private:
 
     void timerConfigNormal() {
         TCB0.CTRLB = TCB_CNTMODE_INT_gc;
-        TCB0.CCMP = F_CPU * microsPerTick / 1000000UL;
+        TCB0.CCMP = F_CPU * microsPerTick / 1000000UL - 1U; // the period is CCMP + 1 clocks
         TCB0.INTCTRL = TCB_CAPT_bm;
         TCB0.CTRLA = TCB_CLKSEL_CLKDIV1_gc | TCB_ENABLE_bm;
     };
 
+    uint16_t timerConfigPeriodic(frequency_t hz) {
+        if (F_CPU / hz == 0U || F_CPU / hz > 65536UL)
+            return 0U;
+        TCB0.CTRLB = TCB_CNTMODE_INT_gc;
+        TCB0.CCMP = (uint16_t) (F_CPU / hz - 1U);
+        TCB0.CNT = 0U;
+        TCB0.CTRLA = TCB_CLKSEL_CLKDIV1_gc | TCB_ENABLE_bm;
+        return (uint16_t) (F_CPU / hz);
+    };
+
+    void timerSetTop(uint16_t top) {
+        TCB0.CCMP = top;
+    };
+
 #define PWM_PIN  6
 
 ///////////////////////////////////////////////////////////////////////////////
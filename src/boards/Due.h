@@ -28,10 +28,15 @@ this program. If not, see http://www.gnu.org/licenses/.
 #define HAS_HARDWARE_PWM    1
 #define HAS_SAMPLING        1
 #define HAS_INPUT_CAPTURE   0
+#define HAS_FAST_PIN        0
+#define HAS_EEPROM          0
+#define HAS_CARRIER_TIMER   0
 
 #define STRCPY_PF_CAST(x) static_cast<const char*>(x)
 
-class Due : public Board {
+class Due final : public Board {
+    friend class Board;
+
 public:
     Due() {
     };
@@ -106,7 +111,7 @@ private:
 #endif
 
     //Clears the interrupt.
-    void timerReset() {
+    void timerAcknowledgeIntr() {
         IR_USE_TC->TC_CHANNEL[IR_USE_CH].TC_SR;
     }
 
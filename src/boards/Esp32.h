@@ -32,6 +32,9 @@ this program. If not, see http://www.gnu.org/licenses/.
 #define HAS_HARDWARE_PWM    1
 #define HAS_SAMPLING        1
 #define HAS_INPUT_CAPTURE   0
+#define HAS_FAST_PIN        0
+#define HAS_EEPROM          0
+#define HAS_CARRIER_TIMER   0
 
 #define STRCPY_PF_CAST(x) (x)
 
@@ -51,7 +54,9 @@ void IRTimer(); // defined in IrReceiverSampler.cpp, masqueraded as ISR(TIMER_IN
 
 #define PWM_PIN 5
 
-class Esp32 : public Board {
+class Esp32 final : public Board {
+    friend class Board;
+
 public:
 
     Esp32() {
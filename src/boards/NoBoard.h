@@ -23,20 +23,63 @@ this program. If not, see http://www.gnu.org/licenses/.
 
 #define HAS_FLASH_READ      0
 #define HAS_HARDWARE_PWM    0
+#ifdef ARDUINO
 #define HAS_SAMPLING        0
+#define HAS_CARRIER_TIMER   0
+#else
+// On the host, the timer interrupt is an event of SimulatedClock.
+#define HAS_SAMPLING        1
+#define HAS_CARRIER_TIMER   1
+#define TIMER_INTR_NAME     timerInterrupt
+void TIMER_INTR_NAME(); // defined with ISR(TIMER_INTR_NAME)
+#endif
 #define HAS_INPUT_CAPTURE   0
+#define HAS_FAST_PIN        0
+#define HAS_EEPROM          0
+
+class NoBoard final : public Board {
+    friend class Board;
 
-class NoBoard : public Board {
 #define PWM_PIN Board::NO_PIN
 public:
+#ifdef ARDUINO
     NoBoard() {};
+#else
+    NoBoard() : timerPeriod(Board::defaultMicrosPerTick), timerStart(0U), timerEvent(SimulatedClock::noEvent) {};
+#endif
 
 private:
+#ifdef ARDUINO
+    void timerEnableIntr() {
+    };
+
+    void timerDisableIntr() {
+    };
+#else
+    uint32_t timerPeriod;
+    uint64_t timerStart;
+    SimulatedClock::event_t timerEvent;
+
+    static void timerCallback(void *argument __attribute__ ((unused))) {
+        TIMER_INTR_NAME();
+    }
+
     void timerEnableIntr() {
+        SimulatedClock::cancel(timerEvent);
+        timerStart = SimulatedClock::now();
+        timerEvent = SimulatedClock::schedule(timerStart + timerPeriod, timerCallback, NULL, timerPeriod);
     };
 
     void timerDisableIntr() {
+        SimulatedClock::cancel(timerEvent);
+        timerEvent = SimulatedClock::noEvent;
+    };
+
+    // Microseconds since the last period started, like a timer in CTC mode clocked at 1MHz.
+    uint16_t timerCount() {
+        return (uint16_t) ((SimulatedClock::now() - timerStart) % timerPeriod);
     };
+#endif
 
     void timerEnablePwm() {
     };
@@ -47,6 +90,32 @@ private:
     void timerConfigHz(frequency_t hz __attribute__ ((unused)), dutycycle_t dutyCycle __attribute__ ((unused))) {
     };
 
+#ifdef ARDUINO
     void timerConfigNormal() {
     };
+
+    uint16_t timerConfigPeriodic(frequency_t hz __attribute__ ((unused))) {
+        return 0U;
+    };
+
+    void timerSetTop(uint16_t top __attribute__ ((unused))) {
+    };
+#else
+    void timerConfigNormal() {
+        timerPeriod = Board::microsPerTick;
+    };
+
+    // The simulated clock has a resolution of 1us, so the timer clocks are microseconds.
+    uint16_t timerConfigPeriodic(frequency_t hz) {
+        timerPeriod = (1000000UL + hz / 2U) / hz;
+        if (timerPeriod == 0U)
+            timerPeriod = 1U;
+        return (uint16_t) timerPeriod;
+    };
+
+    // Only recorded; the simulated interrupt keeps its period, the tests call tick() directly.
+    void timerSetTop(uint16_t top) {
+        timerPeriod = top + 1U;
+    };
+#endif
 };
@@ -25,6 +25,9 @@ this program. If not, see http://www.gnu.org/licenses/.
 #define HAS_HARDWARE_PWM    1
 #define HAS_SAMPLING        1
 #define HAS_INPUT_CAPTURE   0
+#define HAS_FAST_PIN        0
+#define HAS_EEPROM          0
+#define HAS_CARRIER_TIMER   0
 
 #define STRCPY_PF_CAST(x) static_cast<const char *>(x)
 
@@ -36,7 +39,9 @@ this program. If not, see http://www.gnu.org/licenses/.
 #endif
 #define ISR(f)  void interruptServiceRoutine()
 
-class Sam : public Board {
+class Sam final : public Board {
+    friend class Board;
+
 public:
 
     Sam() {
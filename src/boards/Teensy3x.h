@@ -36,6 +36,9 @@ this program. If not, see http://www.gnu.org/licenses/.
 #define HAS_HARDWARE_PWM    1
 #define HAS_SAMPLING        1
 #define HAS_INPUT_CAPTURE   0
+#define HAS_FAST_PIN        0
+#define HAS_EEPROM          1
+#define HAS_CARRIER_TIMER   0
 
 #define TIMER_INTR_NAME     cmt_isr
 #ifndef LED_BUILTIN
@@ -51,7 +54,9 @@ this program. If not, see http://www.gnu.org/licenses/.
 #error IRremote requires at least 8 MHz on Teensy 3.x
 #endif
 
-class Teensy3x : public Board {
+class Teensy3x final : public Board {
+    friend class Board;
+
 public:
 
     Teensy3x() {
@@ -65,7 +70,7 @@ public:
 
 private:
 
-    void timerReset() {
+    void timerAcknowledgeIntr() {
         uint8_t tmp __attribute__((unused)) = CMT_MSC;
         CMT_CMD2 = 30U;
     };
@@ -88,6 +93,12 @@ private:
 
     static const uint32_t CMT_PPS_DIV = (F_BUS + 7999999U) / 8000000U; // = 5
 
+public:
+    // The period of the CMT is at least CMT_CMD2 + 1 (= 31) microseconds.
+    static const unsigned long minMicrosPerTick = 32UL;
+
+private:
+
     void timerConfigHz(frequency_t frequency, dutycycle_t dutyCycle) {
         SIM_SCGC4 |= SIM_SCGC4_CMT;
         SIM_SOPT2 |= SIM_SOPT2_PTD7PAD;
@@ -111,7 +122,7 @@ private:
         CMT_CMD1 = 0U;
         CMT_CMD2 = 30U;
         CMT_CMD3 = 0U;
-        CMT_CMD4 = (F_BUS / 160000U + CMT_PPS_DIV / 2U) / CMT_PPS_DIV - 31U;
+        CMT_CMD4 = (F_BUS / 80000U * microsPerTick / 100U + CMT_PPS_DIV / 2U) / CMT_PPS_DIV - 31U;
         CMT_OC = 0U;
         CMT_MSC = 0x03U;
     };
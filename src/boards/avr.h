@@ -27,3 +27,5 @@ this program. If not, see http://www.gnu.org/licenses/.
 #define HAS_HARDWARE_PWM    1
 #define HAS_SAMPLING        1
 #define HAS_INPUT_CAPTURE   1
+#define HAS_EEPROM          1
+#define HAS_CARRIER_TIMER   1
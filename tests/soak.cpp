@@ -0,0 +1,259 @@
+// Soak test for the repeater use case: randomized NEC1, NECx1, RC5, RC6, Sony, and raw frames are played back
+// on a simulated input pin, received by IrReceiverSampler, decoded by MultiDecoder,
+// rendered again, and sent through IrSenderSimulator.
+//
+// Usage: soak [frames [seed [noise [jitter [filter]]]]]
+// noise is the number of glitches per frame, jitter the largest displacement of an edge (default 10us).
+// filter is 0 for none (default), 1 for the median filter of IrReceiverSampler, 2 for GlitchFilter.
+// With noise 0, every frame must be relayed.
+// Exit status is 0 if no frame was dropped (or noise > 0), otherwise 1.
+
+#include "Arduino.h"
+#include "GlitchFilter.h"
+#include "HeapStatistics.h"
+#include "IrReceiverSampler.h"
+#include "IrSenderSimulator.h"
+#include "MultiDecoder.h"
+#include "Nec1Decoder.h"
+#include "Nec1Renderer.h"
+#include "NecDecoder.h"
+#include "NecRenderer.h"
+#include "Rc5Decoder.h"
+#include "Rc5Renderer.h"
+#include "Rc6Decoder.h"
+#include "Rc6Renderer.h"
+#include "SonyDecoder.h"
+#include "SonyRenderer.h"
+#include "SIL.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <vector>
+
+static const pin_t inputPin = 8;
+static const microseconds_t rawTolerance = 150U;
+
+enum FrameType {
+    nec1Frame,
+    necxFrame,
+    rc5Frame,
+    rc6Frame,
+    sonyFrame,
+    rawFrame,
+    noFrameTypes
+};
+
+static const char * const frameNames[noFrameTypes] = { "NEC1", "NECx1", "RC5", "RC6", "Sony", "raw" };
+
+struct Statistics {
+    unsigned long sent[noFrameTypes];
+    unsigned long relayed[noFrameTypes];
+
+    Statistics() {
+        for (unsigned int i = 0U; i < noFrameTypes; i++) {
+            sent[i] = 0UL;
+            relayed[i] = 0UL;
+        }
+    }
+};
+
+static unsigned long percentile(std::vector<unsigned long>& values, unsigned int percent) {
+    if (values.empty())
+        return 0UL;
+    size_t index = std::min(values.size() - 1U, values.size() * percent / 100U);
+    std::nth_element(values.begin(), values.begin() + (long) index, values.end());
+    return values[index];
+}
+
+static bool sameDurations(const IrReader& irReader, const IrSequence& irSequence) {
+    // The final space is the ending timeout, not the sent one.
+    if (irReader.getDataLength() != irSequence.getLength())
+        return false;
+    for (unsigned int i = 0U; i < irSequence.getLength() - 1U; i++) {
+        int difference = (int) irReader.getDuration(i) - (int) irSequence.getDurations()[i];
+        if (abs(difference) > (int) rawTolerance)
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    unsigned long frames = argc > 1 ? strtoul(argv[1], NULL, 10) : 2000UL;
+    unsigned long seed = argc > 2 ? strtoul(argv[2], NULL, 10) : 1UL;
+    unsigned int noise = argc > 3 ? (unsigned int) strtoul(argv[3], NULL, 10) : 0U;
+    microseconds_t jitter = argc > 4 ? (microseconds_t) strtoul(argv[4], NULL, 10) : 10U;
+    unsigned int filter = argc > 5 ? (unsigned int) strtoul(argv[5], NULL, 10) : 0U;
+
+#ifdef HEAP_STATISTICS
+    HeapStatistics::paintStack();
+#endif
+    std::mt19937 random((std::mt19937::result_type) seed);
+    SIL::seed((uint32_t) seed);
+    std::ostringstream output;
+    Stream stream(output);
+    IrSenderSimulator sender(stream);
+    IrReceiverSampler *receiver = IrReceiverSampler::newIrReceiverSampler(200U, inputPin);
+    receiver->setMedianFilter(filter == 1U);
+    GlitchFilter glitchFilter(*receiver);
+    unsigned long merged = 0UL;
+
+    Statistics statistics;
+    std::vector<unsigned long> latencies; // wall clock, decode to sent, ns
+    std::vector<unsigned long> receiveLatencies; // simulated, end of frame to ready, us
+    latencies.reserve(frames);
+    receiveLatencies.reserve(frames);
+    uint64_t simulatedStart = SimulatedClock::now();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (unsigned long frame = 0UL; frame < frames; frame++) {
+        FrameType type = (FrameType) (random() % noFrameTypes);
+        unsigned int D = random() % 256U;
+        unsigned int S = random() % 256U;
+        unsigned int F = random() % (type == rc5Frame ? 64U : 256U);
+        unsigned int T = random() % 2U;
+        static const unsigned int sonyBits[] = { 12U, 15U, 20U };
+        unsigned int bits = sonyBits[random() % 3U];
+        if (type == sonyFrame && bits != 20U)
+            S = 0U;
+        const IrSignal *irSignal = NULL;
+        microseconds_t *rawDurations = NULL;
+        IrSequence *rawSequence = NULL;
+        switch (type) {
+            case nec1Frame:
+                irSignal = Nec1Renderer::newIrSignal(D, F);
+                break;
+            case necxFrame:
+                irSignal = NecRenderer::newIrSignal(NecDecoder::necx1, D, S, F);
+                break;
+            case rc5Frame:
+                D %= 32U;
+                irSignal = Rc5Renderer::newIrSignal(D, F, T);
+                break;
+            case rc6Frame:
+                irSignal = Rc6Renderer::newIrSignal(D, F, T);
+                break;
+            case sonyFrame:
+                D %= bits == 15U ? 256U : 32U;
+                F %= 128U;
+                irSignal = SonyRenderer::newIrSignal(bits, D, S, F);
+                break;
+            default: {
+                size_t length = 2U * (4U + random() % 30U);
+                rawDurations = new microseconds_t[length];
+                for (size_t i = 0U; i < length; i++)
+                    rawDurations[i] = (microseconds_t) (400U + random() % 3000U);
+                rawDurations[length - 1U] = 50000U;
+                rawSequence = new IrSequence(rawDurations, length);
+            }
+            break;
+        }
+        const IrSequence& irSequence = rawSequence != NULL ? *rawSequence
+                : irSignal->getIntro().isEmpty() ? irSignal->getRepeat() : irSignal->getIntro();
+        statistics.sent[type]++;
+
+        receiver->enable();
+        uint32_t end = SIL::inject(inputPin, irSequence, 0U, jitter, noise)
+                - irSequence.getDurations()[irSequence.getLength() - 1U]; // last edge
+        while (!receiver->isReady())
+            delay(1UL);
+        receiver->disable();
+        receiveLatencies.push_back((unsigned long) (micros() - end));
+        IrReader* reader = receiver;
+        if (filter == 2U) {
+            merged += glitchFilter.filter();
+            reader = &glitchFilter;
+        }
+
+        std::chrono::steady_clock::time_point received = std::chrono::steady_clock::now();
+        MultiDecoder decoder(*reader);
+        bool relayed = false;
+        const IrSignal *rendered = NULL;
+        if (type == nec1Frame && decoder.getType() == MultiDecoder::nec) {
+            Nec1Decoder nec1(*reader);
+            if ((unsigned int) nec1.getD() == D && (unsigned int) nec1.getF() == F)
+                rendered = Nec1Renderer::newIrSignal(nec1.getD(), nec1.getS(), nec1.getF());
+        } else if (type == necxFrame && decoder.getType() == MultiDecoder::nec) {
+            NecDecoder necx(*reader);
+            if (necx.getVariant() == NecDecoder::necx1 && (unsigned int) necx.getD() == D
+                    && (unsigned int) necx.getS() == S && necx.getF() == (long) F)
+                rendered = NecRenderer::newIrSignal(necx.getVariant(), necx.getD(), necx.getS(), necx.getF());
+        } else if (type == rc5Frame && decoder.getType() == MultiDecoder::rc5) {
+            Rc5Decoder rc5(*reader);
+            if ((unsigned int) rc5.getD() == D && (unsigned int) rc5.getF() == F && (unsigned int) rc5.getT() == T)
+                rendered = Rc5Renderer::newIrSignal(rc5.getD(), rc5.getF(), rc5.getT());
+        } else if (type == rc6Frame && decoder.getType() == MultiDecoder::rc6) {
+            Rc6Decoder rc6(*reader);
+            if ((unsigned int) rc6.getD() == D && (unsigned int) rc6.getF() == F && (unsigned int) rc6.getT() == T)
+                rendered = Rc6Renderer::newIrSignal(rc6.getD(), rc6.getF(), rc6.getT());
+        } else if (type == sonyFrame && decoder.getType() == MultiDecoder::sony) {
+            SonyDecoder sony(*reader);
+            if (sony.getBits() == bits && (unsigned int) sony.getD() == D && (unsigned int) sony.getF() == F
+                    && (bits != 20U || (unsigned int) sony.getS() == S))
+                rendered = SonyRenderer::newIrSignal(sony.getBits(), sony.getD(), sony.getS(), sony.getF());
+        } else if (type == rawFrame && sameDurations(*reader, irSequence)) {
+            IrSequence *captured = reader->toIrSequence();
+            sender.send(*captured);
+            delete captured;
+            relayed = true;
+        }
+        if (rendered != NULL) {
+            sender.sendIrSignal(*rendered);
+            delete rendered;
+            relayed = true;
+        }
+        latencies.push_back((unsigned long) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - received).count());
+        output.str("");
+        if (relayed)
+            statistics.relayed[type]++;
+
+        delete irSignal;
+        delete rawSequence;
+        delete [] rawDurations;
+        SIL::eject(inputPin);
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double simulatedSeconds = (double) (SimulatedClock::now() - simulatedStart) / 1e6;
+    unsigned long suppressed = receiver->getSuppressedGlitches();
+    IrReceiverSampler::deleteInstance();
+
+    unsigned long dropped = 0UL;
+    std::cout << "frames: " << frames << ", seed: " << seed << ", noise: " << noise << ", jitter: " << jitter
+            << ", filter: " << (filter == 1U ? "median" : filter == 2U ? "GlitchFilter" : "none") << std::endl;
+    for (unsigned int i = 0U; i < noFrameTypes; i++) {
+        std::cout << frameNames[i] << ": " << statistics.relayed[i] << "/" << statistics.sent[i] << " relayed" << std::endl;
+        dropped += statistics.sent[i] - statistics.relayed[i];
+    }
+    std::cout << "dropped: " << dropped << std::endl;
+    if (filter == 1U)
+        std::cout << "glitches suppressed: " << suppressed << std::endl;
+    else if (filter == 2U)
+        std::cout << "glitches merged: " << merged << std::endl;
+    std::cout << "frames/s: " << (unsigned long) (frames / seconds) << " (wall clock), "
+            << (unsigned long) (frames / simulatedSeconds) << " (simulated); "
+            << (unsigned long) (simulatedSeconds / seconds) << " times real time" << std::endl;
+    Stream console(std::cout);
+#ifdef HEAP_STATISTICS
+    HeapStatistics::dump(console);
+#endif
+#ifdef ISR_STATISTICS
+    IrReceiverSampler::dumpIsrStatistics(console);
+#endif
+    std::cout << "decode+render+send (ns): p50 " << percentile(latencies, 50U)
+            << ", p90 " << percentile(latencies, 90U)
+            << ", p99 " << percentile(latencies, 99U)
+            << ", max " << percentile(latencies, 100U) << std::endl;
+    std::cout << "end of frame to ready (us, simulated): p50 " << percentile(receiveLatencies, 50U)
+            << ", max " << percentile(receiveLatencies, 100U) << std::endl;
+    bool leaked = false;
+#ifdef HEAP_STATISTICS
+    // Everything rendered and decoded has been deleted by now.
+    leaked = HeapStatistics::getCounters(HeapStatistics::renderers).current != 0U
+            || HeapStatistics::getCounters(HeapStatistics::sequences).current != 0U;
+    if (leaked)
+        std::cout << "leaked memory" << std::endl;
+#endif
+    return (dropped > 0UL && noise == 0U) || leaked ? 1 : 0;
+}
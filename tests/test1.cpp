@@ -4,6 +4,8 @@
 
 #include "Arduino.h"
 #include "Nec1Renderer.h"
+#include "NecDecoder.h"
+#include "NecRenderer.h"
 #include "IrSenderPwm.h"
 #include "IrSequenceReader.h"
 #include "Nec1Decoder.h"
@@ -11,15 +13,44 @@
 #include "Pronto.h"
 #include "Rc5Renderer.h"
 #include "Rc5Decoder.h"
+#include "Rc6Decoder.h"
+#include "Rc6Renderer.h"
 #include "HashDecoder.h"
 #include "IrSenderPwmSpinWait.h"
 #include "IrSenderNonMod.h"
+#include "IrSenderPwmSoftFast.h"
+#include "IrSenderPwmTimer.h"
+#include "IrReceiverPoll.h"
+#include "IrReceiverSampler.h"
+#include "IrpRenderer.h"
+#include "IrpDecoder.h"
+#include "BinaryFrame.h"
+#include "DurationFormatter.h"
+#include "GlitchFilter.h"
+#include "RepeatFinder.h"
+#include "SignalStore.h"
+#include "FileStorage.h"
+#include "SignalLibrary.h"
+#include "IrSenderPwmSoftDelay.h"
+#include "SIL.h"
+#include "SimulatedClock.h"
+#include "SonyDecoder.h"
+#include "SonyRenderer.h"
+#include "MultiDecoder.h"
+#include "HeapStatistics.h"
 #include <unistd.h>
 #include <iostream>
 #include <sstream>
 
 #pragma GCC diagnostic ignored "-Wunused-function"
 
+// Durations beyond 16 bits are clamped, unless LONG_DURATIONS is defined.
+#ifdef LONG_DURATIONS
+#define LONG_DURATION(d) #d
+#else
+#define LONG_DURATION(d) "65535"
+#endif
+
 bool checkIrSignalDump(const IrSignal& irSignal, const char *ref) {
     std::ostringstream oss;
     Stream ss(oss);
@@ -74,25 +105,187 @@ static bool testSignalSendSoftCarrier(bool verbose, const IrSignal *signal) {
     return true;
 }
 
+static unsigned int countOccurrences(const std::string& haystack, const std::string& needle) {
+    unsigned int count = 0;
+    for (size_t pos = haystack.find(needle); pos != std::string::npos; pos = haystack.find(needle, pos + 1))
+        count++;
+    return count;
+}
+
+/**
+ * Checks the carrier of the first mark in the edges reported by the SIL digitalWrite:
+ * the number of periods, and the average period, which must be within 0.5% of the nominal one.
+ */
+static bool checkCarrier(const std::string& edges, microseconds_t mark, frequency_t frequency) {
+    std::istringstream in(edges);
+    std::string token;
+    while (in >> token && token[0] != '+') // skip pinMode output and the time before the first edge
+        ;
+    in.seekg(-(std::streamoff) token.length(), std::ios_base::cur);
+    unsigned int periods = 0U;
+    unsigned long onTime = 0UL;
+    unsigned long total = 0UL;
+    while (in >> token) {
+        unsigned long value = strtoul(token.c_str() + 1, NULL, 10);
+        if (token[0] == '+') {
+            periods++;
+            onTime = value;
+        } else if (value > 1000000UL / frequency + 1UL)
+            break; // off time of the last period, merged with the space
+        else
+            total += onTime + value;
+    }
+    unsigned int expectedPeriods = (unsigned int) (((unsigned long) mark * frequency + 500000UL) / 1000000UL);
+    double period = (double) total / (periods - 1U);
+    double nominal = 1000000.0 / frequency;
+    return periods == expectedPeriods && period > 0.995 * nominal && period < 1.005 * nominal;
+}
+
+static bool testSoftFastCarrier(bool verbose) {
+    static const microseconds_t data[] = { 564U, 564U };
+    const IrSequence irSequence(data, 2U);
+    std::ostringstream oss;
+    std::streambuf *stdoutBuf = std::cout.rdbuf(oss.rdbuf());
+    IrSenderPwmSoftFast<Board::NO_PIN> irSender;
+    irSender.send(irSequence, 56000U);
+    std::cout.rdbuf(stdoutBuf);
+    if (verbose)
+        std::cout << oss.str() << std::endl;
+
+    // 56kHz, 40%: period 17.857us, on 7.14us, 564us = 32 periods;
+    // the periods are 17 or 18us, on 7us or 8us.
+    return checkCarrier(oss.str(), 564U, 56000U)
+            && countOccurrences(oss.str(), "+7 ") + countOccurrences(oss.str(), "+8 ") == 32U
+            && countOccurrences(oss.str(), "+7 ") > 0U
+            && countOccurrences(oss.str(), "+8 ") > 0U;
+}
+
+static bool testSoftCarrierSchedule(bool verbose) {
+    static const microseconds_t data[] = { 9024U, 4512U };
+    const IrSequence irSequence(data, 2U);
+    std::ostringstream oss;
+    std::streambuf *stdoutBuf = std::cout.rdbuf(oss.rdbuf());
+    IrSenderPwmSpinWait irSender(Board::NO_PIN);
+    irSender.send(irSequence, 38000U);
+    std::cout.rdbuf(stdoutBuf);
+    if (verbose)
+        std::cout << oss.str() << std::endl;
+
+    // 38kHz: period 26.316us, rounding it to 26us would be 1.2% off.
+    return checkCarrier(oss.str(), 9024U, 38000U);
+}
+
 static bool testNec1SendSoftCarrier(bool verbose) {
     const IrSignal *nec1 = Nec1Renderer::newIrSignal(122, 29); // power_on for Yahama receivers
     return testSignalSendSoftCarrier(verbose, nec1/*, "f=38400\n"
             "+9024 -4512 +564 -564 +564 -1692 +564 -564 +564 -1692 +564 -1692 +564 -1692 +564 -1692 +564 -564 +564 -1692 +564 -564 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -1692 +564 -564 +564 -1692 +564 -1692 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -1692 +564 -1692 +564 -39756\n"
-            "+9024 -2256 +564 -65535\n\n"*/);
+            "+9024 -2256 +564 -" LONG_DURATION(96156) "\n\n"*/);
 }
 
 static bool testNec1SendNonMod(bool verbose) {
     const IrSignal *nec1 = Nec1Renderer::newIrSignal(122, 29); // power_on for Yahama receivers
     return testSignalSendNonMod(verbose, nec1/*, "f=38400\n"
             "+9024 -4512 +564 -564 +564 -1692 +564 -564 +564 -1692 +564 -1692 +564 -1692 +564 -1692 +564 -564 +564 -1692 +564 -564 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -1692 +564 -564 +564 -1692 +564 -1692 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -1692 +564 -1692 +564 -39756\n"
-            "+9024 -2256 +564 -65535\n\n"*/);
+            "+9024 -2256 +564 -" LONG_DURATION(96156) "\n\n"*/);
+}
+
+static bool testIrSenderPwmTimer(bool verbose) {
+    const IrSignal *nec1 = Nec1Renderer::newIrSignal(122, 29);
+    IrSenderPwmTimer *sender = IrSenderPwmTimerFast<5>::newInstance();
+    PinTimeline& timeline = SIL::probe(5);
+    bool ok = sender != NULL && IrSenderPwmTimerFast<5>::newInstance() == NULL
+            && !sender->start(nec1->getIntro(), 38400U, 0U) && !sender->start(nec1->getIntro(), 38400U, 100U)
+            && sender->start(nec1->getIntro(), 38400U, 40U) && !sender->start(nec1->getIntro(), 38400U, 40U);
+    uint32_t total = 0;
+    for (size_t i = 0; i < nec1->getIntro().getLength(); i++)
+        total += nec1->getIntro().getDurations()[i];
+    unsigned long ticks = 0;
+    while (ok && sender->isBusy()) {
+        // simulated timer interrupt; a period of 26us is split into 10us on, 16us off
+        sender->tick();
+        delayMicroseconds(ticks % 2U == 0U ? 10U : 16U);
+        ticks++;
+    }
+    frequency_t frequency;
+    dutycycle_t dutyCycle;
+    timeline.analyzeCarrier(frequency, dutyCycle);
+    if (verbose)
+        std::cout << std::endl << "ticks: " << ticks << ", " << frequency << "Hz, " << (int) dutyCycle << "%" << std::endl;
+    // Two interrupts per period, plus the one finishing
+    long expected = 2L * (long) ((total * 38400ULL + 500000ULL) / 1000000ULL) + 1;
+    ok = ok && labs((long) ticks - expected) <= 1 && dutyCycle == 38U
+            && timeline.matches(nec1->getIntro(), 38400U, 26U, 2U, verbose);
+    SIL::release(5);
+    IrSenderPwmTimer::deleteInstance();
+    delete nec1;
+    return ok;
+}
+
+static bool checkTimeline(bool verbose, const char *name, IrSender& sender, pin_t pin, const IrSignal& irSignal, frequency_t frequency) {
+    std::ostringstream oss;
+    std::streambuf *stdoutBuf = std::cout.rdbuf(oss.rdbuf());
+    PinTimeline& timeline = SIL::probe(pin);
+    sender.send(irSignal.getIntro(), irSignal.getFrequency());
+    std::cout.rdbuf(stdoutBuf);
+    bool ok = timeline.matches(irSignal.getIntro(), frequency, 10U, 2U, verbose);
+    if (verbose) {
+        frequency_t measured;
+        dutycycle_t dutyCycle;
+        unsigned long periods = timeline.analyzeCarrier(measured, dutyCycle);
+        std::cout << name << ": " << timeline.size() << " edges, " << periods << " periods, "
+                << measured << "Hz, " << (int) dutyCycle << "%" << std::endl;
+    }
+    SIL::release(pin);
+    return ok;
+}
+
+static bool testPinTimeline(bool verbose) {
+    const IrSignal *nec1 = Nec1Renderer::newIrSignal(122, 29);
+    IrSenderPwmSpinWait spinWait(3);
+    IrSenderPwmSoftDelay softDelay(3);
+    IrSenderPwmSoftFast<3> softFast;
+    IrSenderNonMod nonMod(3);
+    bool ok = checkTimeline(verbose, "IrSenderPwmSpinWait", spinWait, 3, *nec1, nec1->getFrequency())
+            && checkTimeline(verbose, "IrSenderPwmSoftDelay", softDelay, 3, *nec1, nec1->getFrequency())
+            && checkTimeline(verbose, "IrSenderPwmSoftFast", softFast, 3, *nec1, nec1->getFrequency())
+            && checkTimeline(verbose, "IrSenderNonMod", nonMod, 3, *nec1, 0U);
+
+    // A mark sent without carrier must not match a modulated one.
+    PinTimeline timeline;
+    timeline.add(0U, true);
+    timeline.add(9000U, false);
+    timeline.add(13500U, true);
+    timeline.add(14064U, false);
+    static const microseconds_t expected[] = { 9000U, 4500U, 564U, 1000U };
+    ok = ok && timeline.matches(IrSequence(expected, 4U), 0U)
+            && !timeline.matches(IrSequence(expected, 4U), 38000U)
+            && timeline.getTime(2U) == 13500U && timeline.getLevel(2U) && !timeline.getLevel(3U);
+    delete nec1;
+    return ok;
+}
+
+// The NEC1 repeat gap is only kept with LONG_DURATIONS; it must survive sending,
+// while the capture buffer of IrReceiverSampler stays 16 bits.
+static bool testLongDurations(bool verbose) {
+    const IrSignal *nec1 = Nec1Renderer::newIrSignal(122, 29);
+    microseconds_t gap = nec1->getRepeat().getDurations()[3];
+    microseconds_t durations[] = { 9024U, 2256U, 564U, gap, 9024U, 2256U, 564U, 1000U };
+    IrSenderNonMod sender(3);
+    PinTimeline& timeline = SIL::probe(3);
+    sender.send(IrSequence(durations, 8U, false));
+    bool ok = timeline.matches(IrSequence(durations, 8U, false), 0U, 10U, 2U, verbose)
+            && gap == (sizeof(microseconds_t) > 2U ? 96156U : 65535U)
+            && sizeof(IrReceiverSampler::ticks_t) == 2U;
+    SIL::release(3);
+    delete nec1;
+    return ok;
 }
 
 static bool testNec1Renderer(bool verbose) {
     const IrSignal *nec1 = Nec1Renderer::newIrSignal(122, 29); // power_on for Yahama receivers
     bool result = testSignalRenderer(verbose, nec1, "f=38400 "
             "+9024 -4512 +564 -564 +564 -1692 +564 -564 +564 -1692 +564 -1692 +564 -1692 +564 -1692 +564 -564 +564 -1692 +564 -564 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -1692 +564 -564 +564 -1692 +564 -1692 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -1692 +564 -1692 +564 -39756\n"
-            "+9024 -2256 +564 -65535\n\n");
+            "+9024 -2256 +564 -" LONG_DURATION(96156) "\n\n");
     delete nec1;
     return result;
 }
@@ -100,11 +293,43 @@ static bool testNec1Renderer(bool verbose) {
 static bool testRc5Renderer(bool verbose) {
     const IrSignal *sig = Rc5Renderer::newIrSignal(0, 1, 0);
     bool result = testSignalRenderer(verbose, sig, "f=36000 \n"
-            "+889 -889 +1778 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -1778 +889 -65535\n\n");
+            "+889 -889 +1778 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -1778 +889 -" LONG_DURATION(89108) "\n\n");
     delete sig;
     return result;
 }
 
+#ifdef HEAP_STATISTICS
+static bool testHeapStatistics(bool verbose) {
+    HeapStatistics::reset();
+    const HeapStatistics::Counters& renderers = HeapStatistics::getCounters(HeapStatistics::renderers);
+    const HeapStatistics::Counters& storage = HeapStatistics::getCounters(HeapStatistics::storage);
+    size_t rendererBytes = renderers.current;
+    const IrSignal *sig = Rc5Renderer::newIrSignal(0, 1, 0);
+    bool ok = renderers.allocations >= 2UL && renderers.peak >= rendererBytes + 28U * sizeof(microseconds_t);
+    // Through a volatile pointer, so that the optimizer cannot elide the new/delete pair.
+    char * volatile data;
+    {
+        HeapStatistics::Scope scope(HeapStatistics::storage);
+        data = new char[100];
+    }
+    ok = ok && storage.allocations == 1UL && storage.current == 100U;
+    delete sig;
+    ok = ok && renderers.frees >= 2UL && renderers.current < rendererBytes + 28U * sizeof(microseconds_t);
+    delete [] data; // charged to storage, where it was allocated
+    ok = ok && storage.frees == 1UL && storage.current == 0U && storage.peak == 100U
+            && HeapStatistics::getTotal().peak >= 100U;
+    // Deleting a rendered signal gives back everything that was allocated for it.
+    rendererBytes = renderers.current;
+    delete Nec1Renderer::newIrSignal(122U, 29U);
+    ok = ok && renderers.current == rendererBytes;
+    if (verbose) {
+        Stream stream(std::cout);
+        HeapStatistics::dump(stream);
+    }
+    return ok;
+}
+#endif // HEAP_STATISTICS
+
 static bool testNec1Decoder(bool verbose) {
     const IrSignal *nec1 = Nec1Renderer::newIrSignal(122, 29); // power_on for Yahama receivers
     IrSequenceReader irSequenceReader(nec1->getIntro());
@@ -112,6 +337,46 @@ static bool testNec1Decoder(bool verbose) {
     return checkDecoderDump(verbose, decoder, "NEC1 122 29\n");
 }
 
+static void scaleDurations(microseconds_t *result, const IrSequence& irSequence, unsigned int numerator, unsigned int denominator) {
+    for (unsigned int i = 0; i < irSequence.getLength(); i++) {
+        result[i] = toMicroseconds((uint32_t) irSequence.getDurations()[i] * numerator / denominator);
+    }
+}
+
+static bool testNec1DecoderAdaptive(bool verbose) {
+    const IrSignal *nec1 = Nec1Renderer::newIrSignal(122, 29);
+    microseconds_t durations[68];
+    scaleDurations(durations, nec1->getIntro(), 6, 5); // 20% slow resonator
+    delete nec1;
+    IrSequence slow(durations, 68);
+    IrSequenceReader slowReader(slow);
+    Nec1Decoder fixed(slowReader);
+    if (fixed.isValid())
+        return false;
+
+    Nec1Calibration calibration;
+    Nec1Decoder adaptive(slowReader, calibration);
+    if (!checkDecoderDump(verbose, adaptive, "NEC1 122 29\n"))
+        return false;
+    if (verbose)
+        std::cout << adaptive.getUnit() << " " << calibration.getUnit(122) << std::endl;
+    if (calibration.getUnit(122) < 670U || calibration.getUnit(122) > 682U)
+        return false;
+
+    // Leader shortened by the AGC of the receiver: only decodable using the calibration.
+    durations[0] = 7000U;
+    Nec1Calibration empty;
+    Nec1Decoder uncalibrated(slowReader, empty);
+    Nec1Decoder calibrated(slowReader, calibration);
+    if (uncalibrated.isValid() || !checkDecoderDump(verbose, calibrated, "NEC1 122 29\n"))
+        return false;
+
+    // Broken in the inverted F: D and S decode, but must not be left behind.
+    durations[65] = 5000U;
+    Nec1Decoder broken(slowReader, calibration);
+    return !broken.isValid() && broken.getD() == -1 && broken.getS() == -1 && broken.getF() == -1;
+}
+
 static bool testRc5Decoder(bool verbose) {
     const IrSignal *sig = Rc5Renderer::newIrSignal(0, 1, 0);
     IrSequenceReader irSequenceReaderRc5(sig->getRepeat());
@@ -119,6 +384,330 @@ static bool testRc5Decoder(bool verbose) {
     return checkDecoderDump(verbose, rc5Decoder, "RC5 0 1 0\n");
 }
 
+static bool checkSonyRenderer(bool verbose, IrpProtocol::Index index, unsigned int bits, unsigned int D, unsigned int S, unsigned int F) {
+    const IrSignal *sony = SonyRenderer::newIrSignal(bits, D, S, F);
+    const IrSignal *irp = bits == 20U
+            ? IrpRenderer::newIrSignal(IrpProtocol::getProtocol(index), D, (int) S, F)
+            : IrpRenderer::newIrSignal(IrpProtocol::getProtocol(index), D, F);
+    std::ostringstream oss;
+    Stream ss(oss);
+    irp->dump(ss, true);
+    bool ok = sony->getFrequency() == 40000U && testSignalRenderer(verbose, sony, oss.str().c_str());
+    delete sony;
+    delete irp;
+    return ok;
+}
+
+static bool testSonyRenderer(bool verbose) {
+    microseconds_t buffer[SonyRenderer::maxLength];
+    return checkSonyRenderer(verbose, IrpProtocol::sony12, 12U, 1U, 0U, 18U)
+            && checkSonyRenderer(verbose, IrpProtocol::sony15, 15U, 164U, 0U, 47U)
+            && checkSonyRenderer(verbose, IrpProtocol::sony20, 20U, 26U, 1U, 127U)
+            && checkSonyRenderer(verbose, IrpProtocol::sony20, 20U, 31U, 255U, 127U)
+            && SonyRenderer::newIrSignal(13U, 1U, 18U) == NULL
+            && SonyRenderer::render(buffer, 12U, 1U, 0U, 18U) == 26U
+            && SonyRenderer::render(buffer, 20U, 1U, 0U, 18U) == SonyRenderer::maxLength;
+}
+
+static bool checkSonyDecoder(bool verbose, unsigned int bits, unsigned int D, unsigned int S, unsigned int F, const char *expected) {
+    microseconds_t durations[SonyRenderer::maxLength];
+    size_t length = SonyRenderer::render(durations, bits, D, S, F);
+    IrSequence irSequence(durations, length, false);
+    IrSequenceReader reader(irSequence);
+    SonyDecoder decoder(reader);
+    MultiDecoder multiDecoder(reader);
+    return checkDecoderDump(verbose, decoder, expected) && decoder.getBits() == bits
+            && multiDecoder.getType() == MultiDecoder::sony && checkDecoderDump(verbose, multiDecoder, expected);
+}
+
+static bool testSonyDecoder(bool verbose) {
+    bool ok = checkSonyDecoder(verbose, 12U, 1U, 0U, 18U, "Sony12 1 18\n")
+            && checkSonyDecoder(verbose, 15U, 164U, 0U, 47U, "Sony15 164 47\n")
+            && checkSonyDecoder(verbose, 20U, 26U, 1U, 127U, "Sony20 26 1 127\n")
+            && checkSonyDecoder(verbose, 20U, 31U, 255U, 127U, "Sony20 31 255 127\n");
+
+    // NEC1 and RC5 have other lengths, or timings
+    const IrSignal *nec1 = Nec1Renderer::newIrSignal(122, 29);
+    IrSequenceReader necReader(nec1->getIntro());
+    const IrSignal *rc5 = Rc5Renderer::newIrSignal(0, 1, 0);
+    IrSequenceReader rc5Reader(rc5->getRepeat());
+    ok = ok && !SonyDecoder(necReader).isValid() && !SonyDecoder(rc5Reader).isValid()
+            && MultiDecoder(rc5Reader).getType() == MultiDecoder::rc5;
+    delete nec1;
+    delete rc5;
+
+    // Received by the sampler
+    const IrSignal *sony = SonyRenderer::newIrSignal(20U, 26U, 1U, 127U);
+    IrReceiverSampler *receiver = IrReceiverSampler::newIrReceiverSampler(100U, 8);
+    receiver->enable();
+    SIL::inject(8, sony->getRepeat(), 0U, 20U);
+    while (!receiver->isReady())
+        delay(1UL);
+    receiver->disable();
+    ok = ok && checkDecoderDump(verbose, SonyDecoder(*receiver), "Sony20 26 1 127\n");
+    IrReceiverSampler::deleteInstance();
+    SIL::eject(8);
+    delete sony;
+    return ok;
+}
+
+static bool checkRc6Renderer(bool verbose, unsigned int D, unsigned int F, unsigned int T) {
+    const IrSignal *rc6 = Rc6Renderer::newIrSignal(D, F, T);
+    const IrSignal *irp = IrpRenderer::newIrSignal(IrpProtocol::getProtocol(IrpProtocol::rc6), D, -1, F, T);
+    std::ostringstream oss;
+    Stream ss(oss);
+    irp->dump(ss, true);
+    bool ok = rc6->getFrequency() == 36000U && testSignalRenderer(verbose, rc6, oss.str().c_str());
+    delete rc6;
+    delete irp;
+    return ok;
+}
+
+static bool testRc6Renderer(bool verbose) {
+    bool ok = checkRc6Renderer(verbose, 0U, 12U, 1U)
+            && checkRc6Renderer(verbose, 255U, 0U, 0U)
+            && checkRc6Renderer(verbose, 170U, 85U, 1U)
+            && checkRc6Renderer(verbose, 4U, 255U, 0U);
+
+    // The length never exceeds maxLength
+    microseconds_t buffer[Rc6Renderer::maxLength + 1U];
+    for (unsigned int x = 0U; ok && x < 0x20000U; x++)
+        ok = Rc6Renderer::render(buffer, x & 0xFFU, (x >> 8U) & 0xFFU, x >> 16U) <= Rc6Renderer::maxLength;
+    for (unsigned int x = 0U; ok && x < 0x2000U; x++)
+        ok = Rc5Renderer::render(buffer, x & 0x1FU, (x >> 5U) & 0x7FU, x >> 12U) <= Rc5Renderer::maxLength;
+    return ok;
+}
+
+static bool checkRc6Decoder(bool verbose, unsigned int D, unsigned int F, unsigned int T, const char *expected) {
+    microseconds_t durations[Rc6Renderer::maxLength];
+    size_t length = Rc6Renderer::render(durations, D, F, T);
+    IrSequence irSequence(durations, length, false);
+    IrSequenceReader reader(irSequence);
+    Rc6Decoder decoder(reader);
+    MultiDecoder multiDecoder(reader);
+    return checkDecoderDump(verbose, decoder, expected)
+            && multiDecoder.getType() == MultiDecoder::rc6 && checkDecoderDump(verbose, multiDecoder, expected);
+}
+
+static bool testRc6Decoder(bool verbose) {
+    bool ok = checkRc6Decoder(verbose, 0U, 12U, 1U, "RC6 0 12 1\n")
+            && checkRc6Decoder(verbose, 255U, 0U, 0U, "RC6 255 0 0\n")
+            && checkRc6Decoder(verbose, 170U, 85U, 1U, "RC6 170 85 1\n")
+            && checkRc6Decoder(verbose, 4U, 255U, 0U, "RC6 4 255 0\n");
+
+    // All RC5 signals decode by Rc5Decoder, and not by Rc6Decoder
+    microseconds_t durations[Rc5Renderer::maxLength];
+    for (unsigned int x = 0U; ok && x < 0x2000U; x++) {
+        unsigned int D = x & 0x1FU;
+        unsigned int F = (x >> 5U) & 0x7FU;
+        unsigned int T = x >> 12U;
+        size_t length = Rc5Renderer::render(durations, D, F, T);
+        IrSequence irSequence(durations, length, false);
+        IrSequenceReader reader(irSequence);
+        Rc5Decoder rc5(reader);
+        ok = rc5.getD() == (int) D && rc5.getF() == (int) F && rc5.getT() == (int) T
+                && !Rc6Decoder(reader).isValid();
+    }
+
+    // A truncated frame is rejected
+    microseconds_t truncated[Rc6Renderer::maxLength];
+    size_t length = Rc6Renderer::render(truncated, 0U, 12U, 1U);
+    truncated[length - 3U] = 30000U;
+    IrSequence truncatedSequence(truncated, length - 2U, false);
+    IrSequenceReader truncatedReader(truncatedSequence);
+    ok = ok && !Rc6Decoder(truncatedReader).isValid();
+
+    // Received by the sampler
+    const IrSignal *rc6 = Rc6Renderer::newIrSignal(170U, 85U, 1U);
+    IrReceiverSampler *receiver = IrReceiverSampler::newIrReceiverSampler(100U, 8);
+    receiver->enable();
+    SIL::inject(8, rc6->getRepeat(), 0U, 20U);
+    while (!receiver->isReady())
+        delay(1UL);
+    receiver->disable();
+    ok = ok && checkDecoderDump(verbose, Rc6Decoder(*receiver), "RC6 170 85 1\n");
+    IrReceiverSampler::deleteInstance();
+    SIL::eject(8);
+    delete rc6;
+    return ok;
+}
+
+static bool sameDump(bool verbose, const IrSignal *irSignal, const IrSignal *reference) {
+    std::ostringstream oss;
+    Stream ss(oss);
+    reference->dump(ss, true);
+    return irSignal != NULL && testSignalRenderer(verbose, irSignal, oss.str().c_str());
+}
+
+static bool testNecRenderer(bool verbose) {
+    const IrSignal *nec1 = NecRenderer::newIrSignal(NecDecoder::nec1, 122U, 29U);
+    const IrSignal *nec1Reference = Nec1Renderer::newIrSignal(122U, 29U);
+    const IrSignal *nec2 = NecRenderer::newIrSignal(NecDecoder::nec2, 122U, 29U);
+    const IrSignal *nec2Reference = IrpRenderer::newIrSignal(IrpProtocol::getProtocol(IrpProtocol::nec2), 122U, 29U);
+    const IrSignal *necx2 = NecRenderer::newIrSignal(NecDecoder::necx2, 7U, 2U);
+    const IrSignal *samsung32 = IrpRenderer::newIrSignal(IrpProtocol::getProtocol(IrpProtocol::samsung32), 7U, 2U);
+    bool ok = sameDump(verbose, nec1, nec1Reference)
+            && sameDump(verbose, nec2, nec2Reference)
+            // {38.4k,564}<1,-1|1,-3>(8,-8,D:8,S:8,F:8,~F:8,1,^108m)* [S=D]
+            && testSignalRenderer(verbose, necx2, "f=38400 \n"
+                    "+4512 -4512 +564 -1692 +564 -1692 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -1692 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -564 +564 -1692 +564 -1692 +564 -1692 +564 -1692 +564 -1692 +564 -1692 +564 -46524\n\n")
+            // {38k,550}<1,-1|1,-3>(8,-8,D:8,S:8,F:8,~F:8,1,^108m)* [S=D]
+            && testSignalRenderer(verbose, samsung32, "f=38000 \n"
+                    "+4400 -4400 +550 -1650 +550 -1650 +550 -1650 +550 -550 +550 -550 +550 -550 +550 -550 +550 -550 +550 -1650 +550 -1650 +550 -1650 +550 -550 +550 -550 +550 -550 +550 -550 +550 -550 +550 -550 +550 -1650 +550 -550 +550 -550 +550 -550 +550 -550 +550 -550 +550 -550 +550 -1650 +550 -550 +550 -1650 +550 -1650 +550 -1650 +550 -1650 +550 -1650 +550 -1650 +550 -48050\n\n")
+            && NecRenderer::newIrSignal(NecDecoder::nec1Ditto, 122U, 29U) == NULL
+            && NecRenderer::newIrSignal(NecDecoder::none, 122U, 29U) == NULL;
+    delete nec1;
+    delete nec1Reference;
+    delete nec2;
+    delete nec2Reference;
+    delete necx2;
+    delete samsung32;
+
+    microseconds_t ditto[NecRenderer::maxDittoLength];
+    ok = ok && NecRenderer::renderDitto(ditto, NecDecoder::necx1, 1U) == 6U
+            && ditto[0] == 4512U && ditto[1] == 4512U && ditto[2] == 564U && ditto[3] == 1692U && ditto[4] == 564U
+            && NecRenderer::renderDitto(ditto, NecDecoder::nec1f16, 1U) == 4U && ditto[1] == 2256U
+            && NecRenderer::renderDitto(ditto, NecDecoder::necxf16, 1U) == 0U;
+    return ok;
+}
+
+static bool checkNecDecoder(bool verbose, NecDecoder::Variant variant, unsigned int D, unsigned int S, unsigned int F,
+        NecDecoder::Variant expectedVariant, const char *expected) {
+    microseconds_t durations[NecRenderer::frameLength];
+    size_t length = NecRenderer::renderFrame(durations, variant, D, S, F);
+    IrSequence irSequence(durations, length, false);
+    IrSequenceReader reader(irSequence);
+    NecDecoder decoder(reader);
+    MultiDecoder multiDecoder(reader);
+    return checkDecoderDump(verbose, decoder, expected) && decoder.getVariant() == expectedVariant
+            && multiDecoder.getType() == MultiDecoder::nec && checkDecoderDump(verbose, multiDecoder, expected);
+}
+
+static bool testNecDecoder(bool verbose) {
+    bool ok = checkNecDecoder(verbose, NecDecoder::nec1, 122U, 133U, 29U, NecDecoder::nec1, "NEC1 122 29\n")
+            && checkNecDecoder(verbose, NecDecoder::nec2, 122U, 0U, 29U, NecDecoder::nec1, "NEC1 122 0 29\n")
+            && checkNecDecoder(verbose, NecDecoder::necx1, 7U, 7U, 2U, NecDecoder::necx1, "NECx1 7 2\n")
+            && checkNecDecoder(verbose, NecDecoder::necx2, 7U, 8U, 2U, NecDecoder::necx1, "NECx1 7 8 2\n")
+            && checkNecDecoder(verbose, NecDecoder::nec1f16, 1U, 254U, 0x1234U, NecDecoder::nec1f16, "NEC1-f16 1 4660\n")
+            && checkNecDecoder(verbose, NecDecoder::necxf16, 255U, 0U, 0xABCDU, NecDecoder::necxf16, "NECx-f16 255 0 43981\n");
+
+    // Dittos, and telling NEC1 from NEC2 by the repeat
+    microseconds_t frame[NecRenderer::frameLength];
+    microseconds_t ditto[NecRenderer::maxDittoLength];
+    size_t frameLength = NecRenderer::renderFrame(frame, NecDecoder::nec1, 122U, 133U, 29U);
+    size_t dittoLength = NecRenderer::renderDitto(ditto, NecDecoder::nec1, 122U);
+    IrSequence frameSequence(frame, frameLength, false);
+    IrSequence dittoSequence(ditto, dittoLength, false);
+    IrSequenceReader frameReader(frameSequence);
+    IrSequenceReader dittoReader(dittoSequence);
+    NecDecoder nec1(frameReader);
+    NecDecoder nec1Ditto(dittoReader);
+    ok = ok && checkDecoderDump(verbose, nec1Ditto, "NEC1 ditto\n") && nec1Ditto.isDitto()
+            && nec1.withRepeat(nec1Ditto) == NecDecoder::nec1
+            && nec1.withRepeat(nec1) == NecDecoder::nec2
+            && nec1Ditto.withRepeat(nec1) == NecDecoder::none
+            && MultiDecoder(dittoReader).getType() == MultiDecoder::nec_ditto;
+
+    frameLength = NecRenderer::renderFrame(frame, NecDecoder::necx1, 7U, 7U, 2U);
+    dittoLength = NecRenderer::renderDitto(ditto, NecDecoder::necx1, 7U);
+    IrSequence necxSequence(frame, frameLength, false);
+    IrSequence necxDittoSequence(ditto, dittoLength, false);
+    IrSequenceReader necxReader(necxSequence);
+    IrSequenceReader necxDittoReader(necxDittoSequence);
+    NecDecoder necx1(necxReader);
+    NecDecoder necx1Ditto(necxDittoReader);
+    ok = ok && checkDecoderDump(verbose, necx1Ditto, "NECx1 ditto\n") && necx1Ditto.getD() == 1
+            && necx1.withRepeat(necx1Ditto) == NecDecoder::necx1
+            && necx1.withRepeat(necx1) == NecDecoder::necx2
+            && necx1.withRepeat(nec1Ditto) == NecDecoder::none
+            && MultiDecoder(necxDittoReader).getType() == MultiDecoder::nec_ditto;
+    ditto[3] = 564U; // D bit 0, not matching
+    NecDecoder wrongDitto(necxDittoReader);
+    ok = ok && wrongDitto.isValid() && necx1.withRepeat(wrongDitto) == NecDecoder::none;
+
+    // Other protocols are rejected
+    const IrSignal *rc5 = Rc5Renderer::newIrSignal(0U, 1U, 0U);
+    IrSequenceReader rc5Reader(rc5->getRepeat());
+    const IrSignal *jvc = IrpRenderer::newIrSignal(IrpProtocol::getProtocol(IrpProtocol::jvc), 1U, 2U);
+    IrSequenceReader jvcReader(jvc->getRepeat());
+    ok = ok && !NecDecoder(rc5Reader).isValid() && !NecDecoder(jvcReader).isValid();
+    delete rc5;
+    delete jvc;
+    return ok;
+}
+
+static bool testNec1DecoderVirtual(bool verbose) {
+    const IrSignal *nec1 = Nec1Renderer::newIrSignal(122, 29);
+    IrSequenceReader irSequenceReader(nec1->getIntro());
+    const IrReader& irReader = irSequenceReader;
+    Nec1Decoder decoder(irReader);
+    return checkDecoderDump(verbose, decoder, "NEC1 122 29\n");
+}
+
+static bool testIrpRenderer(bool verbose) {
+    const IrSignal *nec1 = IrpRenderer::newIrSignal(IrpProtocol::getProtocol(IrpProtocol::nec1), 122, 29);
+    bool result = testSignalRenderer(verbose, nec1, "f=38400 "
+            "+9024 -4512 +564 -564 +564 -1692 +564 -564 +564 -1692 +564 -1692 +564 -1692 +564 -1692 +564 -564 +564 -1692 +564 -564 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -1692 +564 -564 +564 -1692 +564 -1692 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -1692 +564 -1692 +564 -39756\n"
+            "+9024 -2256 +564 -" LONG_DURATION(96156) "\n\n");
+    delete nec1;
+    if (!result)
+        return false;
+
+    const IrSignal *rc5 = IrpRenderer::newIrSignal(IrpProtocol::getProtocol(IrpProtocol::rc5), 0, -1, 1, 0);
+    result = testSignalRenderer(verbose, rc5, "f=36000 \n"
+            "+889 -889 +1778 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -1778 +889 -" LONG_DURATION(89108) "\n\n");
+    delete rc5;
+
+    // The hand-written RC5 renderer gives the same signals, including the ending gap of the extent.
+    for (unsigned int x = 0U; result && x < 0x2000U; x++) {
+        unsigned int D = x & 0x1FU;
+        unsigned int F = (x >> 5U) & 0x7FU;
+        unsigned int T = x >> 12U;
+        const IrSignal *irp = IrpRenderer::newIrSignal(IrpProtocol::getProtocol(IrpProtocol::rc5), D, -1, F, T);
+        const IrSignal *reference = Rc5Renderer::newIrSignal(D, F, T);
+        result = sameDump(false, irp, reference);
+        delete irp;
+        delete reference;
+    }
+    return result;
+}
+
+static bool testIrpRoundTrip(bool verbose, IrpProtocol::Index index, unsigned int D, int S, unsigned int F, unsigned int T, const char *expected) {
+    const IrSignal *signal = IrpRenderer::newIrSignal(IrpProtocol::getProtocol(index), D, S, F, T);
+    const IrSequence& frame = signal->getIntro().isEmpty() ? signal->getRepeat() : signal->getIntro();
+    IrSequenceReader irSequenceReader(frame);
+    IrpDecoder decoder(irSequenceReader);
+    bool result = checkDecoderDump(verbose, decoder, expected);
+    delete signal;
+    return result;
+}
+
+static bool testIrpDecoder(bool verbose) {
+    const IrSignal *nec1 = Nec1Renderer::newIrSignal(122, 29);
+    IrSequenceReader introReader(nec1->getIntro());
+    IrpDecoder decoder(introReader);
+    IrSequenceReader repeatReader(nec1->getRepeat());
+    IrpDecoder dittoDecoder(repeatReader);
+    const IrSignal *rc5 = Rc5Renderer::newIrSignal(0, 1, 0);
+    IrSequenceReader rc5Reader(rc5->getRepeat());
+    IrpDecoder rc5Decoder(rc5Reader);
+    bool result = checkDecoderDump(verbose, decoder, "NEC1 122 29\n")
+            && checkDecoderDump(verbose, dittoDecoder, "NEC1 ditto\n")
+            && checkDecoderDump(verbose, rc5Decoder, "RC5 0 1 0\n");
+    delete nec1;
+    delete rc5;
+    return result
+            && testIrpRoundTrip(verbose, IrpProtocol::nec1, 12, 34, 56, 0, "NEC1 12 34 56\n")
+            && testIrpRoundTrip(verbose, IrpProtocol::samsung32, 7, -1, 2, 0, "Samsung32 7 2\n")
+            && testIrpRoundTrip(verbose, IrpProtocol::jvc, 3, -1, 17, 0, "JVC 3 17\n")
+            && testIrpRoundTrip(verbose, IrpProtocol::sony12, 1, -1, 21, 0, "Sony12 1 21\n")
+            && testIrpRoundTrip(verbose, IrpProtocol::sony15, 164, -1, 47, 0, "Sony15 164 47\n")
+            && testIrpRoundTrip(verbose, IrpProtocol::sony20, 26, 1, 127, 0, "Sony20 26 1 127\n")
+            && testIrpRoundTrip(verbose, IrpProtocol::rc5, 31, -1, 127, 1, "RC5 31 127 1\n")
+            && testIrpRoundTrip(verbose, IrpProtocol::rc6, 0, -1, 12, 1, "RC6 0 12 1\n")
+            && testIrpRoundTrip(verbose, IrpProtocol::rc6, 255, -1, 0, 0, "RC6 255 0 0\n");
+}
+
 static bool testHashDecoder(bool verbose) {
     const IrSignal *nec1 = Nec1Renderer::newIrSignal(122, 29); // power_on for Yahama receivers
     IrSequenceReader irSequenceReader(nec1->getIntro());
@@ -139,6 +728,293 @@ static bool testHashDecoder2(bool verbose) {
     return checkDecoderDump(verbose, decoder, "69ad5559\n");
 }
 
+static IrReceiverPollStatic<99> staticReceiver(7);
+
+static bool testIrReceiverPollStatic(bool verbose) {
+    if (verbose)
+        std::cout << staticReceiver.getBufferSize() << std::endl;
+    return staticReceiver.getBufferSize() == 100U && staticReceiver.isEmpty();
+}
+
+static bool testIrReceiverSamplerStatic(bool verbose) {
+#ifdef HEAP_STATISTICS
+    HeapStatistics::reset();
+    const HeapStatistics::Counters& heap = HeapStatistics::getTotal();
+    size_t heapBytes = heap.current;
+#endif
+    IrReceiverSampler *receiver = IrReceiverSampler::newIrReceiverSamplerStatic<100U>(8);
+#ifdef HEAP_STATISTICS
+    // Neither the instance nor its buffer is on the heap.
+    bool ok = heap.allocations == 0UL && heap.current == heapBytes;
+#else
+    bool ok = true;
+#endif
+    ok = ok && receiver != NULL && IrReceiverSampler::getInstance() == receiver && receiver->getBufferSize() == 100U
+            && IrReceiverSampler::newIrReceiverSamplerStatic<100U>(8) == NULL
+            && IrReceiverSampler::newIrReceiverSampler(100U, 8) == NULL;
+    if (!ok)
+        return false;
+
+    const IrSignal *nec1 = Nec1Renderer::newIrSignal(122, 29);
+    receiver->enable();
+    SIL::inject(8, nec1->getIntro(), 0U, 20U);
+    while (!receiver->isReady())
+        delay(1UL);
+    receiver->disable();
+    SIL::eject(8);
+    delete nec1;
+    ok = checkDecoderDump(verbose, Nec1Decoder(*receiver), "NEC1 122 29\n");
+
+    // Released, not deleted: the object stays usable, and is not handed out again.
+#ifdef HEAP_STATISTICS
+    unsigned long frees = heap.frees;
+#endif
+    IrReceiverSampler::deleteInstance();
+#ifdef HEAP_STATISTICS
+    ok = ok && heap.frees == frees;
+#endif
+    ok = ok && IrReceiverSampler::getInstance() == NULL && receiver->getBufferSize() == 100U
+            && Nec1Decoder(*receiver).isValid()
+            && IrReceiverSampler::newIrReceiverSamplerStatic<100U>(8) == NULL;
+
+    // The heap allocated flavor is available again.
+    IrReceiverSampler *dynamic = IrReceiverSampler::newIrReceiverSampler(100U, 8);
+    ok = ok && dynamic != NULL && dynamic != receiver;
+    IrReceiverSampler::deleteInstance();
+    return ok;
+}
+
+static bool testInjectedSampler(bool verbose) {
+    const IrSignal *nec1 = Nec1Renderer::newIrSignal(122, 29);
+    IrReceiverSampler *receiver = IrReceiverSampler::newIrReceiverSampler(100U, 8);
+    receiver->enable();
+    SIL::seed(4711U);
+    SIL::inject(8, nec1->getIntro(), 0U, 20U);
+    // The timer interrupt is an event of the simulated clock.
+    uint64_t events = SimulatedClock::getEventCount();
+    unsigned long start = millis();
+    while (!receiver->isReady() && millis() - start < 1000UL)
+        delay(1UL);
+    Nec1Decoder decoder(*receiver);
+    if (verbose) {
+        Stream stdout(std::cout);
+        receiver->dump(stdout);
+        std::cout << SimulatedClock::getEventCount() - events << " ticks" << std::endl;
+    }
+    bool ok = receiver->isReady() && decoder.isValid() && decoder.getD() == 122 && decoder.getF() == 29;
+    receiver->disable();
+    IrReceiverSampler::deleteInstance();
+    SIL::eject(8);
+    delete nec1;
+    return ok;
+}
+
+static bool testGlitchFilter(bool verbose) {
+    const IrSignal *nec1 = Nec1Renderer::newIrSignal(122, 29);
+    const IrSequence& intro = nec1->getIntro();
+    // A leading glitch, the leader mark split by a short space, and a long space split by a short mark.
+    microseconds_t durations[100];
+    size_t length = 0U;
+    durations[length++] = 20U;
+    durations[length++] = 3000U;
+    durations[length++] = 4000U;
+    durations[length++] = 30U;
+    durations[length++] = 4994U;
+    for (size_t i = 1U; i < intro.getLength(); i++) {
+        microseconds_t duration = intro.getDurations()[i];
+        if (i == 5U) {
+            durations[length++] = 800U;
+            durations[length++] = 40U;
+            durations[length++] = (microseconds_t) (duration - 840U);
+        } else
+            durations[length++] = duration;
+    }
+    IrSequence noisySequence(durations, length, false);
+    IrSequenceReader noisy(noisySequence);
+    Nec1Decoder unfiltered(noisy);
+    GlitchFilter filter(noisy);
+    Nec1Decoder decoder(filter);
+    if (verbose) {
+        Stream stdout(std::cout);
+        filter.dump(stdout);
+    }
+    bool ok = !unfiltered.isValid() && decoder.isValid() && decoder.getD() == 122 && decoder.getF() == 29
+            && filter.getMerged() == 3U && filter.getDataLength() == intro.getLength();
+    for (size_t i = 0U; ok && i < intro.getLength(); i++)
+        ok = filter.getDuration(i) == intro.getDurations()[i];
+
+    // Static buffer, too small
+    microseconds_t buffer[10];
+    GlitchFilter small(noisy, buffer, 10U, 10U);
+    ok = ok && small.getDataLength() == 10U && small.getMerged() == 0U && small.getTotalMerged() == 0UL;
+    delete nec1;
+    return ok;
+}
+
+static bool testMedianFilter(bool verbose) {
+    const IrSignal *nec1 = Nec1Renderer::newIrSignal(122, 29);
+    IrReceiverSampler *receiver = IrReceiverSampler::newIrReceiverSampler(100U, 8);
+    bool ok = !receiver->getMedianFilter();
+    unsigned int decoded[2] = { 0U, 0U };
+    SIL::seed(17U);
+    for (unsigned int filter = 0U; filter < 2U; filter++) {
+        receiver->setMedianFilter(filter == 1U);
+        for (unsigned int i = 0U; i < 20U; i++) {
+            receiver->enable();
+            SIL::inject(8, nec1->getIntro(), 0U, 0U, 30U);
+            while (!receiver->isReady())
+                delay(1UL);
+            receiver->disable();
+            Nec1Decoder decoder(*receiver);
+            if (decoder.isValid() && decoder.getD() == 122 && decoder.getF() == 29)
+                decoded[filter]++;
+            else if (verbose && filter == 1U) {
+                Stream stdout(std::cout);
+                receiver->dump(stdout);
+            }
+        }
+    }
+    if (verbose)
+        std::cout << "decoded: " << decoded[0] << " unfiltered, " << decoded[1] << " filtered, "
+                << receiver->getSuppressedGlitches() << " glitches suppressed" << std::endl;
+    ok = ok && decoded[1] == 20U && decoded[0] < decoded[1] && receiver->getSuppressedGlitches() > 0UL;
+    IrReceiverSampler::deleteInstance();
+    SIL::eject(8);
+    delete nec1;
+    return ok;
+}
+
+static bool testSamplingPeriod(bool verbose) {
+    bool ok = !Board::setMicrosPerTick(5UL) && !Board::setMicrosPerTick(200UL)
+            && Board::getMicrosPerTick() == Board::defaultMicrosPerTick;
+    const IrSignal *nec1 = Nec1Renderer::newIrSignal(122, 29);
+    IrReceiverSampler *receiver = IrReceiverSampler::newIrReceiverSampler(100U, 8, false, 0U);
+    static const unsigned long periods[] = { 10UL, 25UL, 100UL };
+    for (unsigned int i = 0U; i < sizeof(periods)/sizeof(periods[0]); i++) {
+        ok = ok && Board::setMicrosPerTick(periods[i]);
+        uint64_t events = SimulatedClock::getEventCount();
+        receiver->enable();
+        SIL::inject(8, nec1->getIntro());
+        while (!receiver->isReady())
+            delay(1UL);
+        uint64_t ticks = SimulatedClock::getEventCount() - events;
+        receiver->disable();
+        Nec1Decoder decoder(*receiver);
+        // The marks start on a tick, so they are measured with an error less than a period.
+        int error = (int) receiver->getDuration(0) - (int) nec1->getIntro().getDurations()[0];
+        if (verbose)
+            std::cout << periods[i] << "us: " << receiver->getDuration(0) << ", " << ticks << " ticks" << std::endl;
+        ok = ok && receiver->getMicrosPerTick() == periods[i] && decoder.isValid() && decoder.getD() == 122
+                && abs(error) <= (int) periods[i] && receiver->getEndingTimeout() == IrReader::defaultEndingTimeout;
+        SIL::eject(8);
+    }
+    Board::setMicrosPerTick(Board::defaultMicrosPerTick);
+    IrReceiverSampler::deleteInstance();
+    delete nec1;
+    return ok;
+}
+
+#ifdef ISR_STATISTICS
+static bool testIsrStatistics(bool verbose) {
+    IrReceiverSampler *receiver = IrReceiverSampler::newIrReceiverSampler(100U, 10);
+    receiver->enable();
+    IrReceiverSampler::resetIsrStatistics();
+    delay(1UL); // 20 ticks, on time
+    IrReceiverSampler::IsrStatistics statistics;
+    IrReceiverSampler::getIsrStatistics(statistics);
+    bool ok = statistics.calls == 20UL && statistics.missedTicks == 0UL && statistics.maxLatency == 0U;
+
+    // Blocking interrupts over three ticks: one runs late, two are lost.
+    noInterrupts();
+    delayMicroseconds(160U);
+    interrupts();
+    IrReceiverSampler::getIsrStatistics(statistics);
+    ok = ok && statistics.calls == 21UL && statistics.missedTicks == 2UL
+            && statistics.maxLatency == 10U && statistics.overruns == 0UL;
+    if (verbose) {
+        Stream stream(std::cout);
+        IrReceiverSampler::dumpIsrStatistics(stream);
+    }
+    receiver->disable();
+    IrReceiverSampler::deleteInstance();
+    return ok;
+}
+#endif // ISR_STATISTICS
+
+static unsigned int clockCalls;
+static uint64_t clockTimes[4];
+
+static void clockCallback(void *argument) {
+    if (clockCalls < 4U)
+        clockTimes[clockCalls] = SimulatedClock::now();
+    clockCalls++;
+    if (argument != NULL)
+        delayMicroseconds(1000U); // like in an ISR, no events run from here
+}
+
+static unsigned int pinChanges;
+
+static void pinChange() {
+    pinChanges++;
+}
+
+static bool testSimulatedClock(bool verbose) {
+    uint64_t start = SimulatedClock::now();
+    clockCalls = 0U;
+    SimulatedClock::event_t periodic = SimulatedClock::schedule(start + 100U, clockCallback, NULL, 100U);
+    SimulatedClock::schedule(start + 250U, clockCallback, &clockCalls);
+    delayMicroseconds(240U);
+    bool ok = clockCalls == 2U && clockTimes[0] == start + 100U && clockTimes[1] == start + 200U
+            && micros() == start + 240U;
+    delayMicroseconds(20U);
+    // The one-shot at 250 takes 1000us, like a long ISR; the clock is then at 1250.
+    ok = ok && clockCalls == 3U && clockTimes[2] == start + 250U && micros() == start + 1250U;
+    noInterrupts();
+    delayMicroseconds(1000U);
+    ok = ok && clockCalls == 3U;
+    // The periodic event, due since 300, runs once when interrupts are enabled.
+    interrupts();
+    ok = ok && clockCalls == 4U && clockTimes[3] == start + 2250U
+            && SimulatedClock::cancel(periodic) && !SimulatedClock::cancel(periodic);
+    delay(1UL);
+    ok = ok && clockCalls == 4U && millis() == (start + 3250U) / 1000U;
+
+    // Pin change events
+    static const microseconds_t data[] = { 1000U, 500U, 1000U, 2000U };
+    pinChanges = 0U;
+    attachInterrupt(digitalPinToInterrupt(10), pinChange, CHANGE);
+    uint32_t end = SIL::inject(10, IrSequence(data, 4U));
+    SimulatedClock::advanceTo(end);
+    detachInterrupt(digitalPinToInterrupt(10));
+    SIL::eject(10);
+    if (verbose)
+        std::cout << clockCalls << " " << pinChanges << " " << micros() - start << std::endl;
+    return ok && pinChanges == 4U && SimulatedClock::pending() == 0U;
+}
+
+static bool testInjectedPoll(bool verbose) {
+    const IrSignal *nec1 = Nec1Renderer::newIrSignal(122, 29);
+    IrReceiverPoll receiver(100U, 9);
+    SIL::seed(4711U);
+    SIL::inject(9, nec1->getIntro(), 0U, 20U);
+    receiver.enable();
+    Nec1Decoder decoder(receiver);
+    if (verbose) {
+        Stream stdout(std::cout);
+        receiver.dump(stdout);
+    }
+    bool ok = !receiver.isEmpty() && decoder.isValid() && decoder.getD() == 122 && decoder.getF() == 29;
+
+    // Carrier and glitches reach the pin as they are, the NEC1 decoder does not accept that.
+    SIL::inject(9, nec1->getIntro(), 38400U, 0U, 10U);
+    receiver.enable();
+    Nec1Decoder modulated(receiver);
+    ok = ok && receiver.getDataLength() > 68U && !modulated.isValid();
+    SIL::eject(9);
+    delete nec1;
+    return ok;
+}
+
 static bool testIrSenderSimulator(bool verbose) {
     const IrSignal *nec1 = Nec1Renderer::newIrSignal(122, 29); // power_on for Yahama receivers
     if (verbose) {
@@ -147,8 +1023,8 @@ static bool testIrSenderSimulator(bool verbose) {
         sender.sendIrSignal(*nec1, 3);
     }
     return checkSenderSimulator(*nec1, 3, "IrSenderSimulator: f=38400 40% +9024 -4512 +564 -564 +564 -1692 +564 -564 +564 -1692 +564 -1692 +564 -1692 +564 -1692 +564 -564 +564 -1692 +564 -564 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -1692 +564 -564 +564 -1692 +564 -1692 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -1692 +564 -1692 +564 -39756\n"
-            "IrSenderSimulator: f=38400 40% +9024 -2256 +564 -65535\n"
-            "IrSenderSimulator: f=38400 40% +9024 -2256 +564 -65535\n");
+            "IrSenderSimulator: f=38400 40% +9024 -2256 +564 -" LONG_DURATION(96156) "\n"
+            "IrSenderSimulator: f=38400 40% +9024 -2256 +564 -" LONG_DURATION(96156) "\n");
 }
 
 static bool testPronto(bool verbose) {
@@ -163,7 +1039,7 @@ static bool testPronto(bool verbose) {
             "+9040 -2266 +573 -65535\n\n"
 #else
             "+9022 -4498 +572 -572 +572 -1690 +572 -572 +572 -1690 +572 -1690 +572 -1690 +572 -1690 +572 -572 +572 -1690 +572 -572 +572 -1690 +572 -572 +572 -572 +572 -572 +572 -572 +572 -1690 +572 -1690 +572 -572 +572 -1690 +572 -1690 +572 -1690 +572 -572 +572 -572 +572 -572 +572 -572 +572 -1690 +572 -572 +572 -572 +572 -572 +572 -1690 +572 -1690 +572 -1690 +572 -39702\n"
-            "+9022 -2262 +572 -65535\n\n"
+            "+9022 -2262 +572 -" LONG_DURATION(95992) "\n\n"
 #endif
             );
 }
@@ -200,7 +1076,280 @@ static bool testProntoDump(bool verbose) {
     std::ostringstream oss;
     Stream ss(oss);
     Pronto::dump(ss, *nec1);
-    return oss.str() == std::string("0000 006B 0022 0002 015B 00AE 0016 0016 0016 0041 0016 0016 0016 0041 0016 0041 0016 0041 0016 0041 0016 0016 0016 0041 0016 0016 0016 0041 0016 0016 0016 0016 0016 0016 0016 0016 0016 0041 0016 0041 0016 0016 0016 0041 0016 0041 0016 0041 0016 0016 0016 0016 0016 0016 0016 0016 0016 0041 0016 0016 0016 0016 0016 0016 0016 0041 0016 0041 0016 0041 0016 05F9 015B 0057 0016 09D9 ");
+    return oss.str() == std::string("0000 006B 0022 0002 015B 00AE 0016 0016 0016 0041 0016 0016 0016 0041 0016 0041 0016 0041 0016 0041 0016 0016 0016 0041 0016 0016 0016 0041 0016 0016 0016 0016 0016 0016 0016 0016 0016 0041 0016 0041 0016 0016 0016 0041 0016 0041 0016 0041 0016 0016 0016 0016 0016 0016 0016 0016 0016 0041 0016 0016 0016 0016 0016 0016 0016 0041 0016 0041 0016 0041 0016 05F9 015B 0057 0016 "
+#ifdef LONG_DURATIONS
+            "0E72 "
+#else
+            "09D9 "
+#endif
+            );
+}
+
+static BinaryFrame::Parser::Status feedFrame(BinaryFrame::Parser& parser, const std::string& frame) {
+    parser.reset();
+    for (size_t i = 0; i < frame.length(); i++)
+        parser.feed((uint8_t) frame[i]);
+    return parser.getStatus();
+}
+
+// Frames the payload, with sync, type, length, and CRC.
+static std::string makeFrame(const uint8_t *data, size_t length) {
+    std::string frame(1U, (char) BinaryFrame::sync);
+    uint16_t crc = 0xFFFFU;
+    for (size_t i = 0U; i < length; i++) {
+        frame += (char) data[i];
+        crc = BinaryFrame::crc16(crc, data[i]);
+    }
+    frame += (char) (crc >> 8U);
+    frame += (char) (crc & 0xFFU);
+    return frame;
+}
+
+static bool testBinaryFrame(bool verbose) {
+    const IrSignal *nec1 = Nec1Renderer::newIrSignal(122, 29);
+    std::ostringstream oss;
+    Stream ss(oss);
+    BinaryFrame::write(ss, *nec1);
+    std::string frame = oss.str();
+
+    microseconds_t buffer[100];
+    BinaryFrame::Parser parser(buffer, 100);
+    bool ok = feedFrame(parser, "garbage" + frame) == BinaryFrame::Parser::complete
+            && parser.getType() == BinaryFrame::signalType
+            && checkIrSignalDump(parser.toIrSignal(), "f=38400 "
+            "+9024 -4512 +564 -564 +564 -1692 +564 -564 +564 -1692 +564 -1692 +564 -1692 +564 -1692 +564 -564 +564 -1692 +564 -564 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -1692 +564 -564 +564 -1692 +564 -1692 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -1692 +564 -1692 +564 -39756\n"
+            "+9024 -2256 +564 -" LONG_DURATION(96156) "\n\n");
+    if (verbose)
+        std::cout << "frame length " << frame.length() << std::endl;
+
+    std::string corrupted = frame;
+    corrupted[10] ^= 0x04;
+    ok = ok && feedFrame(parser, corrupted) == BinaryFrame::Parser::error;
+
+    BinaryFrame::Parser smallParser(buffer, 10);
+    ok = ok && feedFrame(smallParser, frame) == BinaryFrame::Parser::error;
+
+    // Lengths 0xFFFFFFF0 + 0x20 + 0 wrap to 16 in 32 bits; must be rejected, not read out of bounds.
+    static const uint8_t wrapping[] = {
+        BinaryFrame::signalType, 24U, // payload: 4 header varints (1 + 5 + 1 + 1), 16 durations
+        0x01U, 0xF0U, 0xFFU, 0xFFU, 0xFFU, 0x0FU, 0x20U, 0x00U,
+        1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U, 1U
+    };
+    ok = ok && feedFrame(parser, makeFrame(wrapping, sizeof(wrapping))) == BinaryFrame::Parser::error;
+
+    // f=38000 +100 -100 is fine; a zero duration, or f=600000, is not.
+    uint8_t small[] = {
+        BinaryFrame::signalType, 8U,
+        0xF0U, 0xA8U, 0x02U, 2U, 0U, 0U, 100U, 100U
+    };
+    ok = ok && feedFrame(parser, makeFrame(small, sizeof(small))) == BinaryFrame::Parser::complete
+            && parser.getFrequency() == 38000U;
+    small[9] = 0U;
+    ok = ok && feedFrame(parser, makeFrame(small, sizeof(small))) == BinaryFrame::Parser::error;
+    small[9] = 100U;
+    small[2] = 0xC0U;
+    small[3] = 0xCFU;
+    small[4] = 0x24U;
+    ok = ok && feedFrame(parser, makeFrame(small, sizeof(small))) == BinaryFrame::Parser::error;
+
+    std::ostringstream timeout;
+    Stream ts(timeout);
+    BinaryFrame::writeTimeout(ts);
+    ok = ok && feedFrame(parser, timeout.str()) == BinaryFrame::Parser::complete
+            && parser.getType() == BinaryFrame::timeoutType;
+    delete nec1;
+    return ok;
+}
+
+static bool testDurationFormatter(bool verbose) {
+    microseconds_t data[] = { 0, 9, 10, 99, 100, 9024, 4512, 65535 };
+    std::ostringstream oss;
+    Stream ss(oss);
+    DurationFormatter formatter(ss);
+    for (unsigned int i = 0; i < 20; i++) // more than fits in the buffer
+        formatter.append(data[i % (sizeof(data) / sizeof(data[0]))]);
+    formatter.append(4294967295UL);
+    formatter.println();
+    IrSequence irSequence(data, sizeof(data) / sizeof(data[0]), false);
+    irSequence.dump(ss, false);
+    if (verbose)
+        std::cout << oss.str();
+    return oss.str() == "+0 -9 +10 -99 +100 -9024 +4512 -65535 +0 -9 +10 -99 +100 -9024 +4512 -65535 +0 -9 +10 -99 +4294967295\n"
+            "0 9 10 99 100 9024 4512 65535\n";
+}
+
+// Flattens the signal, as it would have been captured when sent with noSends.
+static IrSequence *flatten(const IrSignal& irSignal, unsigned int noSends) {
+    size_t length = irSignal.getIntro().getLength() + irSignal.noRepetitions(noSends) * irSignal.getRepeat().getLength();
+    microseconds_t *data = new microseconds_t[length];
+    size_t pos = 0;
+    for (size_t i = 0; i < irSignal.getIntro().getLength(); i++)
+        data[pos++] = irSignal.getIntro().getDurations()[i];
+    for (unsigned int r = 0; r < irSignal.noRepetitions(noSends); r++)
+        for (size_t i = 0; i < irSignal.getRepeat().getLength(); i++)
+            data[pos++] = irSignal.getRepeat().getDurations()[i];
+    data[length - 1] = 30000U; // ending timeout
+    return new IrSequence(data, length, true);
+}
+
+static bool testRepeatFinder(bool verbose) {
+    const IrSignal *nec1 = Nec1Renderer::newIrSignal(122, 29);
+    IrSequence *nec1Flat = flatten(*nec1, 4);
+    RepeatFinder nec1Finder(*nec1Flat, 38400U);
+    IrSignal *nec1Signal = nec1Finder.toIrSignal();
+    if (verbose) {
+        Stream stdout(std::cout);
+        nec1Signal->dump(stdout, true);
+    }
+    bool ok = nec1Finder.getIntroLength() == 68U && nec1Finder.getRepeatLength() == 4U
+            && nec1Finder.getNumberRepeats() == 3U && nec1Finder.getEndingLength() == 0U
+            && nec1Signal->getRepeat().getDurations()[1] == 2256U;
+
+    const IrSignal *rc5 = Rc5Renderer::newIrSignal(0, 1, 0);
+    IrSequence *rc5Flat = flatten(*rc5, 3);
+    RepeatFinder rc5Finder(*rc5Flat, 36000U);
+    ok = ok && rc5Finder.getIntroLength() == 0U && rc5Finder.getRepeatLength() == rc5->getRepeat().getLength()
+            && rc5Finder.getNumberRepeats() == 3U;
+
+    // A single frame has no repeat
+    IrSequence *single = flatten(*nec1, 1);
+    RepeatFinder singleFinder(*single);
+    ok = ok && singleFinder.getNumberRepeats() == 0U && singleFinder.getIntroLength() == 68U;
+
+    delete nec1Signal;
+    delete nec1Flat;
+    delete rc5Flat;
+    delete single;
+    delete nec1;
+    delete rc5;
+    return ok;
+}
+
+static bool testSignalStore(bool verbose) {
+    const char *filename = "test1-store.bin";
+    remove(filename);
+    const IrSignal *nec1 = Nec1Renderer::newIrSignal(122, 29);
+    const IrSignal *rc5 = Rc5Renderer::newIrSignal(0, 1, 0);
+    bool ok;
+    {
+        FileStorage storage(filename, 512);
+        SignalStore<FileStorage> store(storage);
+        ok = !store.isFormatted() && store.format(4) && store.getNoSlots() == 4U
+                && store.store(1, "power", *nec1) && store.store(2, "rc5-on", *rc5);
+        unsigned long writes = storage.getWriteCount();
+        ok = ok && store.store(1, "power", *nec1) && storage.getWriteCount() == writes; // unchanged, nothing written
+    }
+
+    FileStorage storage(filename, 512);
+    SignalStore<FileStorage> store(storage);
+    IrSignal *loaded = store.load("power");
+    IrSignal *loadedRc5 = store.load(2);
+    char name[SignalStore<FileStorage>::nameLength + 1];
+    ok = ok && store.isFormatted() && store.find("rc5-on") == 2 && store.find("nothing") == SignalStore<FileStorage>::notFound
+            && !store.isUsed(0) && store.getName(1, name) && std::string(name) == "power"
+            && loaded != NULL && loadedRc5 != NULL
+            && loaded->getFrequency() == nec1->getFrequency() && loaded->getDutyCycle() == nec1->getDutyCycle()
+            && checkIrSignalDump(*loaded, "f=38400 "
+            "+9024 -4512 +564 -564 +564 -1692 +564 -564 +564 -1692 +564 -1692 +564 -1692 +564 -1692 +564 -564 +564 -1692 +564 -564 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -1692 +564 -564 +564 -1692 +564 -1692 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -1692 +564 -1692 +564 -39756\n"
+            "+9024 -2256 +564 -" LONG_DURATION(96156) "\n\n")
+            && checkIrSignalDump(*loadedRc5, "f=36000 \n"
+            "+889 -889 +1778 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -1778 +889 -" LONG_DURATION(89108) "\n\n");
+    if (verbose)
+        std::cout << "slot capacity " << store.getSlotCapacity() << std::endl;
+    ok = ok && store.erase(1) && store.find("power") == SignalStore<FileStorage>::notFound;
+
+    // A header with a geometry not fitting the storage is not trusted.
+    storage.update(4U, 0U);
+    storage.update(5U, 1U); // 4 slots of 256 bytes
+    ok = ok && !SignalStore<FileStorage>(storage).isFormatted();
+    storage.update(5U, 0U); // slots smaller than their header
+    ok = ok && !SignalStore<FileStorage>(storage).isFormatted();
+    storage.update(4U, 100U);
+    storage.update(3U, 0U); // no slots
+    ok = ok && !SignalStore<FileStorage>(storage).isFormatted();
+    storage.update(3U, 4U);
+    ok = ok && SignalStore<FileStorage>(storage).isFormatted();
+    delete loaded;
+    delete loadedRc5;
+    delete nec1;
+    delete rc5;
+    remove(filename);
+    return ok;
+}
+
+static bool testSignalLibrary(bool verbose) {
+    const char *filename = "test1-library.bin";
+    const char necDump[] = "f=38400 "
+            "+9024 -4512 +564 -564 +564 -1692 +564 -564 +564 -1692 +564 -1692 +564 -1692 +564 -1692 +564 -564 +564 -1692 +564 -564 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -1692 +564 -564 +564 -1692 +564 -1692 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -564 +564 -564 +564 -564 +564 -1692 +564 -1692 +564 -1692 +564 -39756\n"
+            "+9024 -2256 +564 -" LONG_DURATION(96156) "\n\n";
+    const char rc5Dump[] = "f=36000 \n"
+            "+889 -889 +1778 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -889 +889 -1778 +889 -" LONG_DURATION(89108) "\n\n";
+    const char prontoHex[] = "0000 006C 0022 0002 015B 00AD 0016 0016 0016 0041 0016 0016 0016 0041 0016 0041 0016 0041 0016 0041 0016 0016 0016 0041 0016 0016 0016 0041 0016 0016 0016 0016 0016 0016 0016 0016 0016 0041 0016 0041 0016 0016 0016 0041 0016 0041 0016 0041 0016 0016 0016 0016 0016 0016 0016 0016 0016 0041 0016 0016 0016 0016 0016 0016 0016 0041 0016 0041 0016 0041 0016 05F7 015B 0057 0016 0E6C";
+
+    SignalLibrary::Builder builder;
+    const IrSignal *nec1 = Nec1Renderer::newIrSignal(12, 34);
+    builder.add("yamaha_off", *nec1);
+    bool ok = builder.addRaw("yamaha_on", necDump)
+            && builder.addRaw("rc5", rc5Dump)
+            && builder.addPronto("pronto", prontoHex)
+            && !builder.addRaw("bad", "+1 -2 x")
+            && builder.write(filename);
+    delete nec1;
+
+    SignalLibrary library;
+    ok = ok && library.open(filename) && library.size() == 4U
+            && library.find("rc5") >= 0L && library.find("missing") == SignalLibrary::notFound;
+    if (ok) {
+        IrSignal on = library.getIrSignal((uint32_t) library.find("yamaha_on"));
+        IrSignal off = library.getIrSignal((uint32_t) library.find("yamaha_off"));
+        IrSignal rc5 = library.getIrSignal((uint32_t) library.find("rc5"));
+        if (verbose) {
+            Stream stdout(std::cout);
+            for (uint32_t i = 0; i < library.size(); i++) {
+                std::cout << library.getName(i) << ": ";
+                library.getIrSignal(i).dump(stdout, true);
+            }
+        }
+        ok = checkIrSignalDump(on, necDump) && checkIrSignalDump(rc5, rc5Dump)
+                && off.getRepeat().getDurations() == on.getRepeat().getDurations() // shared ditto block
+                && library.getIrSignal((uint32_t) library.find("pronto")).getIntro().getLength() == 68U;
+    }
+    library.close();
+
+    // Corrupt entries are rejected at open: a name outside the string table, a block outside the pool.
+    std::string contents;
+    FILE *file = fopen(filename, "rb");
+    for (int c = file != NULL ? fgetc(file) : EOF; c != EOF; c = fgetc(file))
+        contents += (char) c;
+    if (file != NULL)
+        fclose(file);
+    const size_t entries = 10U * sizeof(uint32_t); // header size
+    const size_t entrySize = 9U * sizeof(uint32_t);
+    const char *corruptName = "test1-corrupt.bin";
+    for (size_t offset : { entries, entries + entrySize + 7U * sizeof(uint32_t) }) {
+        std::string corrupt = contents;
+        corrupt[offset + 3U] = (char) 0x7F;
+        file = fopen(corruptName, "wb");
+        fwrite(corrupt.data(), 1U, corrupt.size(), file);
+        fclose(file);
+        SignalLibrary corrupted;
+        ok = ok && contents.size() > offset && !corrupted.open(corruptName);
+    }
+    // Names out of order would break the binary search of find().
+    std::string unsorted = contents;
+    for (size_t i = 0U; i < sizeof(uint32_t); i++)
+        std::swap(unsorted[entries + i], unsorted[entries + entrySize + i]);
+    file = fopen(corruptName, "wb");
+    fwrite(unsorted.data(), 1U, unsorted.size(), file);
+    fclose(file);
+    SignalLibrary shuffled;
+    ok = ok && !shuffled.open(corruptName);
+    remove(corruptName);
+
+    SignalLibrary garbage;
+    ok = ok && !garbage.open("Makefile") && !garbage.open("nonexisting");
+    remove(filename);
+    return ok;
 }
 
 #define TEST(f) if (f(verbose)) {successes++;} else {std::cout << #f << " failed!" << std::endl; fails++;}
@@ -212,19 +1361,53 @@ int main(int argc, const char *args[] __attribute__((unused))) {
 
     TEST(testNec1SendSoftCarrier);
     TEST(testNec1SendNonMod);
+    TEST(testSoftFastCarrier);
+    TEST(testSoftCarrierSchedule);
+    TEST(testIrSenderPwmTimer);
+    TEST(testPinTimeline);
+    TEST(testLongDurations);
     TEST(testNec1Renderer);
     TEST(testRc5Renderer);
+#ifdef HEAP_STATISTICS
+    TEST(testHeapStatistics);
+#endif
     TEST(testNec1Decoder);
+    TEST(testNec1DecoderVirtual);
+    TEST(testNec1DecoderAdaptive);
     TEST(testRc5Decoder);
+    TEST(testSonyRenderer);
+    TEST(testSonyDecoder);
+    TEST(testRc6Renderer);
+    TEST(testRc6Decoder);
+    TEST(testNecRenderer);
+    TEST(testNecDecoder);
+    TEST(testIrpRenderer);
+    TEST(testIrpDecoder);
     TEST(testHashDecoder);
     TEST(testHashDecoder1);
     TEST(testHashDecoder2);
 
+    TEST(testIrReceiverPollStatic);
+    TEST(testIrReceiverSamplerStatic);
+    TEST(testSimulatedClock);
+    TEST(testInjectedSampler);
+    TEST(testGlitchFilter);
+    TEST(testMedianFilter);
+#ifdef ISR_STATISTICS
+    TEST(testIsrStatistics);
+#endif
+    TEST(testSamplingPeriod);
+    TEST(testInjectedPoll);
     TEST(testIrSenderSimulator);
     TEST(testPronto);
     TEST(testToProntoHex);
     TEST(testProntoParse);
     TEST(testProntoDump);
+    TEST(testBinaryFrame);
+    TEST(testDurationFormatter);
+    TEST(testRepeatFinder);
+    TEST(testSignalStore);
+    TEST(testSignalLibrary);
 
     // Report
     std::cout << "Successes: " << successes << std::endl;